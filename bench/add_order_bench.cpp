@@ -60,9 +60,9 @@ struct BenchResult {
 }  // namespace
 
 int main() {
-    OrderBook book(false);
+    // Inline: no sink, no publisher and no logger thread behind the timed calls.
+    OrderBook book(BookBackend::RING, TradePublishMode::INLINE);
     book.setInstrumentToken(kInstrument);
-    book.setTradeListener([](const TradeEvent&) {});
 
     constexpr size_t kWarmup = 10'000;
     constexpr size_t kSamples = 100'000;
@@ -0,0 +1,97 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "engine/InlineEngine.h"
+#include "ingress/WireOrder.h"
+#include "utils/Affinity.h"
+
+// Wire payloads through the whole matching pipeline on one core
+// (engine::InlineEngine): decode, sequence, build, match and trade sinks,
+// with no thread handoff to measure. Each run replays the same seeded flow
+// twice and fails unless both passes produce the same trades.
+// Usage: inline_pipeline_bench [orders] [core]
+
+namespace {
+
+constexpr InstrumentToken kInstruments[] = {26000, 26009, 35000, 35001};
+constexpr Price kMid = 1510;
+
+std::vector<std::string> makeFlow(std::size_t orders) {
+    std::mt19937 rng(1337);
+    std::uniform_int_distribution<int> instrumentDist(0, 3);
+    std::uniform_int_distribution<int> offsetDist(-10, 10);
+    std::uniform_int_distribution<int> qtyDist(1, 200);
+    std::uniform_int_distribution<int> kindDist(0, 9);
+    std::vector<std::string> flow;
+    flow.reserve(orders);
+    for (std::size_t i = 0; i < orders; ++i) {
+        ingress::WireOrder order{};
+        order.order_id = static_cast<OrderId>(i + 1);
+        order.instrument = kInstruments[instrumentDist(rng)];
+        order.side = (i & 1) ? Side::BUY : Side::SELL;
+        order.price = static_cast<Price>(static_cast<int>(kMid) + offsetDist(rng));
+        order.quantity = static_cast<Qty>(qtyDist(rng));
+        order.type = kindDist(rng) == 0 ? OrderType::IOC : OrderType::LIMIT;
+        flow.push_back(ingress::serializeWireOrder(order));
+    }
+    return flow;
+}
+
+struct Pass {
+    uint64_t trades = 0;
+    uint64_t checksum = 1469598103934665603ULL;
+    double seconds = 0;
+};
+
+Pass replay(const std::vector<std::string>& flow) {
+    Pass pass;
+    const auto digest = [&pass](TradeBatch batch) {
+        for (const TradeEvent& trade : batch) {
+            ++pass.trades;
+            for (uint64_t field : {uint64_t{trade.instrument}, uint64_t{trade.aggressorId},
+                                   uint64_t{trade.restingOrderId}, uint64_t{trade.price},
+                                   uint64_t{trade.quantity}, trade.sequence}) {
+                pass.checksum = (pass.checksum ^ field) * 1099511628211ULL;
+            }
+        }
+    };
+    engine::InlineEngine engine;
+    engine.addTradeSink(digest);
+    // Event time, not wall time: one microsecond per order.
+    const HrtTime epoch{};
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < flow.size(); ++i) {
+        engine.handle(flow[i], epoch + std::chrono::microseconds(i));
+    }
+    pass.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return pass;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t orders = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 2'000'000;
+    if (argc > 2) {
+        cpu::setCurrentThreadAffinity({std::atoi(argv[2])});
+    }
+    const auto flow = makeFlow(orders);
+
+    const Pass first = replay(flow);
+    const Pass second = replay(flow);
+    const bool deterministic = first.trades == second.trades && first.checksum == second.checksum;
+
+    std::cout << "Inline pipeline benchmark (" << orders << " orders, " << std::size(kInstruments)
+              << " instruments)\n";
+    for (const Pass& pass : {first, second}) {
+        std::cout << "  " << static_cast<double>(orders) / pass.seconds / 1e6 << " M orders/s, "
+                  << pass.seconds * 1e9 / static_cast<double>(orders) << " ns/order, "
+                  << pass.trades << " trades, checksum " << std::hex << pass.checksum << std::dec << "\n";
+    }
+    std::cout << "  deterministic: " << (deterministic ? "yes" : "NO") << "\n";
+    return deterministic ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/OrderBook.h"
+#include "core/OrderBuilder.h"
+#include "ingress/McastSocket.h"
+#include "utils/Affinity.h"
+#include "utils/Numa.h"
+
+// NUMA placement policy on any machine. Part one fabricates a two-node sysfs
+// tree (real CPUs split in half, or a phantom node when there is only one)
+// and prints where [numa] policy=off and policy=nic put each engine thread.
+// Part two builds books and socket buffers on the main thread and on their
+// owning core, reports which node their pages landed on (move_pages) and
+// times matching on the owning core. On a single-node host both builds are
+// local; the numbers are the baseline a multi-node host is compared against.
+// Usage: numa_placement_bench [nic-node] [owner-core]
+
+namespace {
+
+constexpr uint64_t kOrders = 1'000'000;
+constexpr std::size_t kBooks = 16;
+
+std::string formatCpus(const std::vector<int>& cpus) {
+    return cpus.empty() ? "-" : cpu::formatCpus(cpus);
+}
+
+std::string formatCpuList(const std::vector<int>& cpus) {
+    return cpus.empty() ? std::string() : std::to_string(cpus.front()) + "-" + std::to_string(cpus.back());
+}
+
+std::filesystem::path fabricateTree(const std::vector<std::vector<int>>& nodes, int nic_node) {
+    namespace fs = std::filesystem;
+    const fs::path root = fs::temp_directory_path() / ("numa_bench_" + std::to_string(::getpid()));
+    for (std::size_t node = 0; node < nodes.size(); ++node) {
+        const fs::path dir = root / "devices/system/node" / ("node" + std::to_string(node));
+        fs::create_directories(dir);
+        std::ofstream(dir / "cpulist") << formatCpuList(nodes[node]) << "\n";
+    }
+    const fs::path nic = root / "class/net/sim0/device";
+    fs::create_directories(nic);
+    std::ofstream(nic / "numa_node") << nic_node << "\n";
+    return root;
+}
+
+void simulatePolicy(int nic_node) {
+    const int online = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int half = std::max(1, online / 2);
+    std::vector<std::vector<int>> nodes(2);
+    for (int cpu = 0; cpu < std::max(online, 2); ++cpu) {
+        nodes[cpu < half ? 0 : 1].push_back(cpu);
+    }
+    const auto root = fabricateTree(nodes, nic_node);
+    const numa::Topology topology = numa::discover(root.string());
+    const int node = numa::nicNode("sim0", root.string());
+    std::filesystem::remove_all(root);
+
+    // Two shards, one pinned per node; everything else left unpinned.
+    struct Role {
+        std::string name;
+        std::vector<int> pinned;
+    };
+    const std::vector<Role> roles = {
+        {"engine shard 0", {nodes[0].front()}},
+        {"engine shard 1", {nodes[1].front()}},
+        {"dispatcher 0", {}},
+        {"dispatcher 1", {}},
+        {"trade consumers", {}},
+        {"risk", {}},
+    };
+
+    std::cout << "Simulated topology: node0 " << formatCpus(topology.cpusOf(0)) << ", node1 "
+              << formatCpus(topology.cpusOf(1)) << ", NIC sim0 on node " << node << "\n";
+    for (int policy_node : {-1, node}) {
+        std::size_t local = 0;
+        std::size_t remote = 0;
+        std::size_t floating = 0;
+        std::cout << "  policy=" << (policy_node < 0 ? "off" : "nic") << "\n";
+        for (const auto& role : roles) {
+            const auto cpus = numa::placeOnNode(topology, policy_node, role.pinned);
+            const auto off_node = numa::remoteCpus(topology, node, cpus);
+            std::string where = "anywhere";
+            if (!cpus.empty()) {
+                where = off_node.empty() ? "NIC node" : "remote node";
+            }
+            (cpus.empty() ? floating : off_node.empty() ? local : remote)++;
+            std::cout << "    " << role.name << ": cpus " << formatCpus(cpus) << " (" << where << ")\n";
+        }
+        std::cout << "    " << local << " local, " << remote << " remote (warned at startup), " << floating
+                  << " left to the scheduler\n";
+    }
+}
+
+// Fraction of the pages in [data, data + bytes) resident on `node`.
+double residentOn(const void* data, std::size_t bytes, int node) {
+    const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const auto begin = reinterpret_cast<std::uintptr_t>(data) & ~(page - 1);
+    const auto end = reinterpret_cast<std::uintptr_t>(data) + bytes;
+    std::vector<void*> pages;
+    for (std::uintptr_t addr = begin; addr < end; addr += page * 16) {
+        pages.push_back(reinterpret_cast<void*>(addr));
+    }
+    std::vector<int> status(pages.size(), -1);
+    if (::syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0) != 0) {
+        return -1.0;
+    }
+    std::size_t hits = 0;
+    for (int s : status) {
+        hits += (s == node) ? 1 : 0;
+    }
+    return static_cast<double>(hits) / static_cast<double>(pages.size());
+}
+
+struct Owned {
+    std::vector<std::unique_ptr<OrderBook>> books;
+    std::unique_ptr<SocketUtils::McastSocket> socket;
+};
+
+Owned build() {
+    Owned owned;
+    for (std::size_t idx = 0; idx < kBooks; ++idx) {
+        owned.books.push_back(std::make_unique<OrderBook>(BookBackend::RING));
+        owned.books.back()->setInstrumentToken(static_cast<InstrumentToken>(idx + 1));
+        owned.books.back()->clearTradeSinks();
+    }
+    owned.socket = std::make_unique<SocketUtils::McastSocket>();
+    return owned;
+}
+
+double matchNsPerOrder(Owned& owned, int core) {
+    double ns = 0;
+    numa::runOn({core}, [&] {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < kOrders; ++i) {
+            const bool buy = (i & 1) == 0;
+            owned.books[i % kBooks]->addOrder(OrderBuilder()
+                                                  .setOrderId(i + 1)
+                                                  .setInstrumentToken(static_cast<InstrumentToken>(i % kBooks + 1))
+                                                  .setSide(buy ? Side::BUY : Side::SELL)
+                                                  .setPrice(buy ? 100'000 - (i % 50) : 100'000 + (i % 50))
+                                                  .setQuantity(10)
+                                                  .setOrderType(OrderType::LIMIT)
+                                                  .setTimestamp(std::chrono::high_resolution_clock::now())
+                                                  .build());
+        }
+        ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    });
+    return ns / static_cast<double>(kOrders);
+}
+
+void measureFirstTouch(int core) {
+    const numa::Topology topology = numa::discover();
+    const int node = topology.nodeOf(core);
+    std::cout << "Host: " << topology.nodeCount() << " NUMA node(s); owner core " << core << " on node " << node
+              << "\n";
+
+    const auto report = [&](const std::string& name, Owned& owned) {
+        const auto& buffer = owned.socket->inboundBuffer();
+        const double socket_local = residentOn(buffer.data(), buffer.size(), node);
+        double book_local = 0;
+        for (const auto& book : owned.books) {
+            book_local += residentOn(book.get(), sizeof(OrderBook), node);
+        }
+        book_local /= static_cast<double>(owned.books.size());
+        const double ns = matchNsPerOrder(owned, core);
+        std::cout << "  " << name << ": socket buffer pages on owner node " << socket_local * 100
+                  << "%, book pages " << book_local * 100 << "%, match " << ns << " ns/order\n";
+    };
+
+    Owned on_main = build();
+    report("built on main thread ", on_main);
+    Owned on_owner;
+    numa::runOn({core}, [&] { on_owner = build(); });
+    report("built on owner core  ", on_owner);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int nic_node = (argc > 1) ? std::atoi(argv[1]) : 0;
+    const int owner_core = (argc > 2) ? std::atoi(argv[2]) : 0;
+    simulatePolicy(nic_node);
+    measureFirstTouch(owner_core);
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/OrderArena.h"
+#include "core/OrderBuilder.h"
+#include "core/SideContainer.h"
+#include "datastructures/PriceRingBuffer.h"
+
+namespace {
+
+constexpr Price kMidPrice = 100'000;
+constexpr size_t kOps = 400'000;
+constexpr size_t kDepthWalkEvery = 64;
+
+// Uniform front-end over the ring buffer and the SideContainer backends.
+class RingAdapter {
+public:
+    PriceLevel* find(Price price) { return ring_.findLevel(price); }
+    PriceLevel* ensure(Price price) { return ring_.ensureLevel(price); }
+    void markNonEmpty(Price price) { ring_.markLevelNonEmpty(price); }
+    void erase(Price price) { ring_.eraseLevel(price); }
+    const PriceLevel* best() const { return ring_.bestLevel(); }
+    template <typename Fn>
+    void forEach(Fn&& fn) const { ring_.forEachAscending(fn); }
+
+private:
+    PriceRingBuffer ring_{Side::BUY};
+};
+
+class ContainerAdapter {
+public:
+    explicit ContainerAdapter(std::unique_ptr<SideContainer> side)
+        : side_(std::move(side)) {}
+
+    PriceLevel* find(Price price) { return side_->find(price); }
+    PriceLevel* ensure(Price price) { return side_->emplace(price); }
+    void markNonEmpty(Price) {}
+    void erase(Price price) { side_->erase(price); }
+    const PriceLevel* best() const { return side_->best(); }
+    template <typename Fn>
+    void forEach(Fn&& fn) const { side_->forEachConst(fn); }
+
+private:
+    std::unique_ptr<SideContainer> side_;
+};
+
+struct Resting {
+    OrderId order = 0;
+    size_t slot = PriceLevel::kInvalidSlot;
+};
+
+// Toggles a single-order level at a random price, then reads top of book,
+// which is the access pattern of add/cancel flow on one side.
+template <typename Adapter>
+void runWorkload(const std::string& name, Adapter& side, Price spread, uint32_t seed) {
+    OrderArena arena;
+    std::vector<Resting> resting(static_cast<size_t>(spread) * 2 + 1);
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<Price> offset(0, spread * 2);
+    std::vector<uint64_t> samples;
+    samples.reserve(kOps);
+    uint64_t walkNs = 0;
+    size_t walks = 0;
+    OrderId nextId = 1;
+    uint64_t checksum = 0;
+
+    for (size_t i = 0; i < kOps; ++i) {
+        const Price idx = offset(rng);
+        const Price price = kMidPrice - spread + idx;
+        auto& entry = resting[static_cast<size_t>(idx)];
+
+        const auto start = std::chrono::steady_clock::now();
+        if (entry.order != 0) {
+            if (auto* level = side.find(price)) {
+                level->removeOrderAt(entry.slot, entry.order, arena);
+                if (level->empty()) {
+                    side.erase(price);
+                }
+            }
+            arena.erase(entry.order);
+            entry = {};
+        } else {
+            const OrderId id = nextId++;
+            arena.store(OrderBuilder()
+                            .setOrderId(id)
+                            .setSide(Side::BUY)
+                            .setPrice(price)
+                            .setQuantity(10)
+                            .build());
+            PriceLevel* level = side.ensure(price);
+            entry = {id, level->addOrder(id, arena)};
+            side.markNonEmpty(price);
+        }
+        if (const PriceLevel* top = side.best()) {
+            checksum += top->openQty();
+        }
+        const auto end = std::chrono::steady_clock::now();
+        samples.push_back(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+
+        // Full-depth walk, as done by snapshot publishing.
+        if (i % kDepthWalkEvery == 0) {
+            const auto walkStart = std::chrono::steady_clock::now();
+            side.forEach([&](Price, const PriceLevel& level) { checksum += level.openQty(); });
+            walkNs += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - walkStart).count());
+            ++walks;
+        }
+    }
+
+    std::sort(samples.begin(), samples.end());
+    uint64_t total = 0;
+    for (auto ns : samples) {
+        total += ns;
+    }
+    const auto pct = [&](double p) {
+        return samples[static_cast<size_t>(p * static_cast<double>(samples.size() - 1))];
+    };
+    std::cout << "  " << name
+              << " avg " << static_cast<double>(total) / static_cast<double>(samples.size()) << " ns"
+              << " | p50 " << pct(0.50) << " ns"
+              << " | p99 " << pct(0.99) << " ns"
+              << " | max " << samples.back() << " ns"
+              << " | depth walk " << walkNs / std::max<size_t>(walks, 1) << " ns"
+              << " (checksum " << checksum << ")\n";
+}
+
+void runSuite(Price spread) {
+    std::cout << "Side container toggle+best benchmark, spread +/-" << spread << " ticks (" << kOps << " ops)\n";
+    {
+        RingAdapter ring;
+        runWorkload("PriceRingBuffer", ring, spread, 7);
+    }
+    {
+        ContainerAdapter tree(makeSideContainer(BookBackend::RB_TREE, Side::BUY));
+        runWorkload("RBTree         ", tree, spread, 7);
+    }
+    {
+        ContainerAdapter map(makeSideContainer(BookBackend::STD_MAP, Side::BUY));
+        runWorkload("std::pmr::map  ", map, spread, 7);
+    }
+    {
+        ContainerAdapter chunks(makeSideContainer(BookBackend::CHUNK_MAP, Side::BUY));
+        runWorkload("PriceChunkMap  ", chunks, spread, 7);
+    }
+}
+
+}  // namespace
+
+int main() {
+    runSuite(64);
+    runSuite(400);
+    runSuite(5'000);
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "datastructures/SpscQueue.h"
+#include "ingress/WireOrder.h"
+#include "utils/Affinity.h"
+
+// Cross-core SpscQueue throughput and ping-pong latency, against the layout
+// of the previously vendored queue (adjacent indices, remote load on every
+// operation, wrap by compare).
+// Usage: spsc_queue_bench [producer-core] [consumer-core]
+
+namespace {
+
+constexpr size_t kCapacity = 10240;
+constexpr uint64_t kThroughputItems = 20'000'000;
+constexpr uint64_t kPingPongRounds = 1'000'000;
+
+template <typename T>
+class LegacyQueue {
+public:
+    explicit LegacyQueue(std::size_t capacity)
+        : capacity_(capacity + 1),
+          buffer_(capacity_) {}
+
+    bool push(const T& value) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t next = increment(tail);
+        if (next == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        buffer_[tail] = value;
+        tail_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& out) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        out = buffer_[head];
+        head_.store(increment(head), std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::size_t increment(std::size_t idx) const { return ++idx == capacity_ ? 0 : idx; }
+
+    const std::size_t capacity_;
+    std::vector<T> buffer_;
+    std::atomic<std::size_t> head_{0};
+    std::atomic<std::size_t> tail_{0};
+};
+
+void pin(int core) {
+    if (core >= 0) {
+        cpu::setCurrentThreadAffinity(std::vector<int>{core});
+    }
+}
+
+template <typename Queue>
+double throughput(int producer_core, int consumer_core) {
+    Queue queue(kCapacity);
+    std::atomic<bool> ready{false};
+    uint64_t checksum = 0;
+
+    std::thread consumer([&] {
+        pin(consumer_core);
+        ready.store(true, std::memory_order_release);
+        ingress::WireOrder order{};
+        for (uint64_t received = 0; received < kThroughputItems;) {
+            if (queue.pop(order)) {
+                checksum += order.order_id;
+                ++received;
+            }
+        }
+    });
+
+    pin(producer_core);
+    while (!ready.load(std::memory_order_acquire)) {
+    }
+    ingress::WireOrder order{};
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < kThroughputItems; ++i) {
+        order.order_id = i;
+        while (!queue.push(order)) {
+        }
+    }
+    consumer.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (checksum != kThroughputItems * (kThroughputItems - 1) / 2) {
+        std::cerr << "checksum mismatch\n";
+        std::exit(1);
+    }
+    return static_cast<double>(kThroughputItems) / seconds / 1e6;
+}
+
+// One-way latency taken as half the round trip through a pair of queues.
+template <typename Queue>
+std::pair<uint64_t, uint64_t> pingPong(int producer_core, int consumer_core) {
+    Queue ping(kCapacity);
+    Queue pong(kCapacity);
+
+    std::thread echo([&] {
+        pin(consumer_core);
+        ingress::WireOrder order{};
+        for (uint64_t i = 0; i < kPingPongRounds; ++i) {
+            while (!ping.pop(order)) {
+            }
+            while (!pong.push(order)) {
+            }
+        }
+    });
+
+    pin(producer_core);
+    std::vector<uint64_t> samples;
+    samples.reserve(kPingPongRounds);
+    ingress::WireOrder order{};
+    for (uint64_t i = 0; i < kPingPongRounds; ++i) {
+        order.order_id = i;
+        const auto start = std::chrono::steady_clock::now();
+        while (!ping.push(order)) {
+        }
+        while (!pong.pop(order)) {
+        }
+        const auto rtt = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        samples.push_back(static_cast<uint64_t>(rtt.count()) / 2);
+    }
+    echo.join();
+
+    const auto at = [&samples](double pct) {
+        const auto rank = static_cast<std::ptrdiff_t>(pct * static_cast<double>(samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+        return samples[static_cast<size_t>(rank)];
+    };
+    const uint64_t p50 = at(0.50);
+    const uint64_t p99 = at(0.99);
+    return {p50, p99};
+}
+
+template <typename Queue>
+void report(const std::string& name, int producer_core, int consumer_core) {
+    const double mops = throughput<Queue>(producer_core, consumer_core);
+    const auto [p50, p99] = pingPong<Queue>(producer_core, consumer_core);
+    std::cout << "  " << name << ": " << mops << " Mmsg/s, one-way p50 " << p50 << " ns, p99 " << p99 << " ns\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int producer_core = (argc > 1) ? std::atoi(argv[1]) : 0;
+    const int consumer_core = (argc > 2) ? std::atoi(argv[2]) : 1;
+
+    std::cout << "SPSC WireOrder queue, producer core " << producer_core << ", consumer core " << consumer_core
+              << " (" << kThroughputItems << " msgs, " << kPingPongRounds << " round trips)\n";
+    report<LegacyQueue<ingress::WireOrder>>("legacy spsc_queue", producer_core, consumer_core);
+    report<SpscQueue<ingress::WireOrder>>("SpscQueue        ", producer_core, consumer_core);
+    return 0;
+}
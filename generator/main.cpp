@@ -179,7 +179,7 @@ size_t serializeOrder(const ingress::WireOrder& order, std::array<char, 128>& bu
     const int len = std::snprintf(
         buffer.data(),
         buffer.size(),
-        "%llu,%u,%.*s,%llu,%u,%.*s,%u",
+        "%llu,%u,%.*s,%llu,%u,%.*s,%u,%u",
         static_cast<unsigned long long>(order.order_id),
         static_cast<unsigned>(order.instrument),
         static_cast<int>(side.size()),
@@ -188,7 +188,8 @@ size_t serializeOrder(const ingress::WireOrder& order, std::array<char, 128>& bu
         static_cast<unsigned>(order.quantity),
         static_cast<int>(type.size()),
         type.data(),
-        static_cast<unsigned>(order.display)
+        static_cast<unsigned>(order.display),
+        static_cast<unsigned>(order.participant)
     );
     return (len > 0) ? static_cast<size_t>(len) : 0;
 }
@@ -260,7 +261,8 @@ int main(int argc, char** argv) {
                     price,
                     quantity,
                     OrderType::LIMIT,
-                    0
+                    0,
+                    static_cast<ParticipantId>(workerId)
                 };
 
                 std::array<char, 128> payload{};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <memory>
+
+#include "core/PriceLevel.h"
+#include "core/SideContainer.h"
+#include "datastructures/PriceRingBuffer.h"
+#include "types/AppTypes.h"
+#include "types/BookBackend.h"
+#include "types/OrderSide.h"
+#include "utils/CompilerHints.h"
+
+/**
+ * @brief One side of an OrderBook over the configured level container.
+ *
+ * The ring is the default and stays on a direct, non-virtual path; the
+ * other backends go through SideContainer.
+ */
+class BookSide {
+public:
+    BookSide(Side side, BookBackend backend) {
+        if (backend == BookBackend::RING) {
+            ring_ = std::make_unique<PriceRingBuffer>(side);
+        } else {
+            container_ = makeSideContainer(backend, side);
+        }
+    }
+
+    PriceLevel* findLevel(Price price) {
+        return LIKELY(ring_ != nullptr) ? ring_->findLevel(price) : container_->find(price);
+    }
+
+    const PriceLevel* findLevel(Price price) const {
+        return LIKELY(ring_ != nullptr) ? ring_->findLevel(price) : container_->find(price);
+    }
+
+    PriceLevel* ensureLevel(Price price) {
+        return LIKELY(ring_ != nullptr) ? ring_->ensureLevel(price) : container_->emplace(price);
+    }
+
+    void eraseLevel(Price price) {
+        if (LIKELY(ring_ != nullptr)) {
+            ring_->eraseLevel(price);
+        } else {
+            container_->erase(price);
+        }
+    }
+
+    // Only the ring tracks emptiness separately from membership.
+    void markLevelNonEmpty(Price price) {
+        if (LIKELY(ring_ != nullptr)) {
+            ring_->markLevelNonEmpty(price);
+        }
+    }
+
+    PriceLevel* bestLevel() {
+        return LIKELY(ring_ != nullptr) ? ring_->bestLevel() : container_->best();
+    }
+
+    const PriceLevel* bestLevel() const {
+        return LIKELY(ring_ != nullptr) ? ring_->bestLevel() : container_->best();
+    }
+
+    PriceLevel* bestLevel(Price& out_price) {
+        return LIKELY(ring_ != nullptr) ? ring_->bestLevel(out_price) : container_->best(out_price);
+    }
+
+    // Only ring slots persist between orders; container levels come and go.
+    void reserveLevels(size_t orders) {
+        if (LIKELY(ring_ != nullptr)) {
+            ring_->reserveLevels(orders);
+        }
+    }
+
+    Qty totalOpenQtyAt(Price price) const {
+        const PriceLevel* level = findLevel(price);
+        return level ? level->openQty() : 0;
+    }
+
+    /**
+     * @brief Visits every non-empty level. The order depends on the backend
+     *        (the ring goes by ascending price, containers best-first), so
+     *        callers that need a price order sort the result.
+     */
+    template <typename Fn>
+    void forEachLevel(Fn&& fn) const {
+        if (LIKELY(ring_ != nullptr)) {
+            ring_->forEachAscending(fn);
+            return;
+        }
+        container_->forEachConst([&](const Price& price, const PriceLevel& level) {
+            if (!level.empty()) {
+                fn(price, level);
+            }
+        });
+    }
+
+private:
+    std::unique_ptr<PriceRingBuffer> ring_;
+    std::unique_ptr<SideContainer> container_;
+};
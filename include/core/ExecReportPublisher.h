@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/ExecutionReport.h"
+#include "datastructures/SequencedRing.h"
+#include "types/TradeOverflow.h"
+#include "utils/Config.h"
+#include "utils/WaitStrategy.h"
+
+/**
+ * @brief Carries the execution reports of one engine shard to the wire.
+ *
+ * The matching thread publishes each report into a SequencedRing; one
+ * sender thread drains it, packs up to kMaxReportsPerDatagram reports per
+ * datagram behind a ReportHeader and hands the bytes to the transport. The
+ * header carries the stream id (the shard) and the ring sequence of the
+ * first report, so receivers can detect loss per stream. The transport is
+ * any callable that sends one datagram, e.g. a multicast socket.
+ *
+ * BLOCK holds the matching thread while the sender is a full ring behind;
+ * DROP discards the report and counts it. Destruction sends everything
+ * already published.
+ */
+class ExecReportPublisher {
+public:
+    using Transport = std::function<void(const char* data, std::size_t len)>;
+
+    struct Options {
+        uint32_t stream = 0;
+        std::size_t capacity = 65536;
+        TradeOverflow overflow = TradeOverflow::BLOCK;
+        WaitSettings wait;
+        int core = -1;
+        // Used when core is unset (e.g. one NUMA node).
+        std::vector<int> cpus;
+    };
+
+    ExecReportPublisher(const Options& options, Transport transport);
+    ~ExecReportPublisher();
+
+    ExecReportPublisher(const ExecReportPublisher&) = delete;
+    ExecReportPublisher& operator=(const ExecReportPublisher&) = delete;
+
+    // Starts the sender thread; publish() starts it on first use too.
+    void start();
+
+    // Matching thread.
+    void publish(const execution::ExecutionReport& report);
+
+    uint64_t published() const { return published_.load(std::memory_order_relaxed); }
+    uint64_t datagrams() const { return datagrams_.load(std::memory_order_relaxed); }
+    uint64_t stalls() const { return stalls_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t lag() const { return ring_.lag(0); }
+    // True once every published report was handed to the transport.
+    bool drained() const { return ring_.lag(0) == 0; }
+    const WaitStrategy& waitStrategy() const { return wait_; }
+
+private:
+    void run();
+    std::size_t sendBatch();
+
+    const Options options_;
+    Transport transport_;
+    SequencedRing<execution::ExecutionReport> ring_;
+    WaitStrategy wait_;
+    std::array<char, execution::kMaxDatagramBytes> datagram_{};
+    std::thread thread_;
+    bool started_ = false;
+    std::atomic<bool> running_{true};
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> datagrams_{0};
+    std::atomic<uint64_t> stalls_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
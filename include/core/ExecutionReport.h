@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "types/AppTypes.h"
+#include "types/ExecType.h"
+#include "types/OrderSide.h"
+
+namespace execution {
+
+// One report, as it travels: fixed 56 bytes, host byte order (little endian
+// on every supported target). price is the trade price for fills and the
+// order price otherwise; timestamp_ns is the engine's wall-clock time of the
+// event, comparable with the sender's clock on the same host. sequence is the
+// global inbound sequence of the order that caused the event (0 without a
+// sequencer, and for cancels/modifies made through the book's API).
+struct ExecutionReport {
+    OrderId order_id = 0;
+    uint64_t price = 0;
+    uint64_t timestamp_ns = 0;
+    InstrumentToken instrument = 0;
+    Qty last_qty = 0;
+    Qty cum_qty = 0;
+    Qty leaves_qty = 0;
+    ExecType type = ExecType::ACK;
+    uint8_t side = 0;  // Side as its underlying value
+    ExecReason reason = ExecReason::NONE;
+    uint8_t reserved[5] = {};
+    uint64_t sequence = 0;
+};
+
+constexpr uint32_t kReportMagic = 0x50525845;  // 'EXRP'
+constexpr uint16_t kReportVersion = 2;
+
+// Leads every datagram. sequence is the stream position of the first report;
+// a receiver that sees it jump has lost datagrams of that stream.
+struct ReportHeader {
+    uint32_t magic = kReportMagic;
+    uint16_t version = kReportVersion;
+    uint16_t count = 0;
+    uint32_t stream = 0;
+    uint32_t reserved = 0;
+    uint64_t sequence = 0;
+};
+
+static_assert(sizeof(ExecutionReport) == 56 && std::is_trivially_copyable_v<ExecutionReport>);
+static_assert(sizeof(ReportHeader) == 24 && std::is_trivially_copyable_v<ReportHeader>);
+
+// Keeps a datagram within one 1500-byte Ethernet frame.
+constexpr std::size_t kMaxDatagramBytes = 1472;
+constexpr std::size_t kMaxReportsPerDatagram = (kMaxDatagramBytes - sizeof(ReportHeader)) / sizeof(ExecutionReport);
+
+// Writes header + reports into out (at least kMaxDatagramBytes); returns the datagram size.
+inline std::size_t encodeReports(uint32_t stream, uint64_t sequence, std::span<const ExecutionReport> reports,
+                                 char* out) {
+    ReportHeader header;
+    header.count = static_cast<uint16_t>(reports.size());
+    header.stream = stream;
+    header.sequence = sequence;
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + sizeof(header), reports.data(), reports.size_bytes());
+    return sizeof(header) + reports.size_bytes();
+}
+
+// Appends the datagram's reports to out; false for a malformed or foreign datagram.
+inline bool decodeReports(std::string_view datagram, ReportHeader& header, std::vector<ExecutionReport>& out) {
+    if (datagram.size() < sizeof(ReportHeader)) {
+        return false;
+    }
+    std::memcpy(&header, datagram.data(), sizeof(header));
+    if (header.magic != kReportMagic || header.version != kReportVersion ||
+        datagram.size() != sizeof(ReportHeader) + header.count * sizeof(ExecutionReport)) {
+        return false;
+    }
+    const std::size_t first = out.size();
+    out.resize(first + header.count);
+    std::memcpy(out.data() + first, datagram.data() + sizeof(ReportHeader), header.count * sizeof(ExecutionReport));
+    return true;
+}
+
+}  // namespace execution
@@ -29,6 +29,8 @@ private:
     Side side_;
     OrderType type_;
     uint32_t user_id_ = 0;
+    // Global inbound sequence (0 when unsequenced).
+    uint64_t sequence_ = 0;
 
     Order(OrderId id, InstrumentToken instrument, Side s, Price p, Qty q, HrtTime ts, OrderType type, Qty display_qty)
         : order_id_(id),
@@ -80,6 +82,7 @@ public:
         return working_quantity_ - filled_quantity_;
     }
     HrtTime timestamp() const { return timestamp_; }
+    uint64_t sequence() const { return sequence_; }
     OrderType type() const { return type_; }
     Qty display_quantity() const { return display_quantity_; }
     bool hasDisplayQuantity() const { return display_quantity_ > 0 && type_ == OrderType::ICEBERG; }
@@ -111,6 +114,13 @@ public:
 
     void setOrderType(OrderType type) { type_ = type; }
 
+    // Keeps the visible slice from growing, e.g. on an in-place size reduction.
+    void capPendingQuantity(Qty maxPending) {
+        if (pending_quantity() > maxPending) {
+            working_quantity_ = filled_quantity_ + maxPending;
+        }
+    }
+
     void setDisplayQuantity(Qty displayQty) {
         display_quantity_ = displayQty;
     }
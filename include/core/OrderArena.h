@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "core/Order.h"
+#include "utils/HugePages.h"
 
 class alignas(64) OrderArena {
 public:
@@ -19,11 +20,13 @@ public:
     Order& require(OrderId id);
     const Order& require(OrderId id) const;
     void erase(OrderId id);
+    // Sizes the slot table for ids below `orders` now instead of on first use.
+    void reserve(std::size_t orders);
 
 private:
     static constexpr size_t kChunkSize = 512;
 
-    std::vector<std::unique_ptr<Order>> slots_;
+    std::vector<std::unique_ptr<Order>, HugePageAllocator<std::unique_ptr<Order>, memory::Region::ARENAS>> slots_;
 
     void ensureCapacity(OrderId id);
 };
@@ -6,25 +6,36 @@
 #define ORDERMATCHINGSYSTEM_ORDERBOOK_H
 
 #include <atomic>
-#include <functional>
 #include <limits>
 #include <memory>
-#include <thread>
+#include <span>
 #include <vector>
 
+#include "core/BookSide.h"
 #include "core/Order.h"
 #include "core/OrderArena.h"
-#include "core/OrderBookObserver.h"
+#include "core/PriceBands.h"
 #include "core/TradeEvent.h"
-#include "datastructures/PriceRingBuffer.h"
+#include "core/TradeSink.h"
+#include "types/BookBackend.h"
+#include "types/ExecType.h"
+#include "types/TradePublishMode.h"
+#include "utils/HugePages.h"
+
+class ExecReportPublisher;
+class TradePublisher;
 
 class OrderBook {
 public:
-    using TradeListener = std::function<void(const TradeEvent&)>;
+    // Gets every change to an order's open quantity other than a fill:
+    // negative when the book gives quantity up, positive when a modify adds.
+    using LeavesHook = void (*)(void* context, OrderId orderId, int64_t delta);
 
 private:
-    PriceRingBuffer bids_;
-    PriceRingBuffer asks_;
+    BookBackend backend_;
+    TradePublishMode dispatch_;
+    BookSide bids_;
+    BookSide asks_;
 
     struct OrderRef {
         Side side = Side::INVALID;
@@ -34,28 +45,39 @@ private:
 
     // this is used to know in which side of book an order is present
     static constexpr size_t kOrderIndexChunk = 1024;
-    std::vector<OrderRef> order_index_;
+    std::vector<OrderRef, HugePageAllocator<OrderRef, memory::Region::ARENAS>> order_index_;
     OrderArena orders_;
-    TradeListener trade_listener_;
+    // Starts with the TRADE log sink; clearTradeSinks() drops it.
+    TradeSinkChain sinks_;
     InstrumentToken instrument_token_ = 0;
-    mutable std::vector<std::weak_ptr<OrderBookObserver>> observers_;
-    std::vector<TradeEvent> trade_ring_;
-    std::atomic<uint64_t> trade_head_{0};
-    std::atomic<uint64_t> trade_tail_{0};
-    std::atomic<bool> trade_running_{true};
-    std::thread trade_thread_;
+    // Null means trades are emitted synchronously on the matching thread.
+    TradePublisher* publisher_ = nullptr;
+    // Null means no execution reports are produced.
+    ExecReportPublisher* reports_ = nullptr;
+    LeavesHook leaves_hook_ = nullptr;
+    void* leaves_context_ = nullptr;
     std::atomic<Price> last_trade_price_{0};
     std::atomic<Qty> last_trade_qty_{0};
-    void tradeWorker();
+    PriceBandGuard bands_;
+    uint64_t band_rejects_ = 0;
+    // Sequence of the order being applied; trades and reports carry it.
+    // cancelOrder/modifyOrder are API calls and run unsequenced (0).
+    uint64_t sequence_ = 0;
+    uint64_t last_sequence_ = 0;
     void dispatchTrade(const TradeEvent& event);
 
 public:
+    explicit OrderBook(BookBackend backend);
+    // INLINE: every trade reaches this book's sinks on the calling thread, in
+    // match order, before addOrder() returns. The book refuses a trade
+    // publisher and starts without the TRADE log sink (the logger has its own
+    // thread), so it runs deterministically on one core (see InlineEngine).
+    OrderBook(BookBackend backend, TradePublishMode dispatch);
     explicit OrderBook(bool use_std_map = false);
     ~OrderBook();
 
     void addOrder(std::unique_ptr<Order> order);
     void processOrder(OrderId orderId);
-    void setTradeListener(TradeListener listener);
     bool cancelOrder(OrderId orderId);
     void modifyOrder(OrderId orderId, Price newPrice, Qty newQty);
 
@@ -65,15 +87,40 @@ public:
     Qty totalOpenQtyAt(Side side, Price price) const;
 
     void printBook() const;
-    void emitTrade(const TradeEvent& event) const;
+    // Runs every sink over a batch of this book's trades, in order.
+    void emitTrades(TradeBatch trades) const;
 
     void setInstrumentToken(InstrumentToken token);
     InstrumentToken instrument_token() const;
-    void addObserver(const std::shared_ptr<OrderBookObserver>& observer);
+    BookBackend backend() const { return backend_; }
+    TradePublishMode dispatch() const { return dispatch_; }
+    // Sinks are registered before trading starts; see TradeSinkChain.
+    void addTradeSink(TradeSink sink);
+    void clearTradeSinks();
+    // Open quantity per level, best price first on each side.
     void snapshot(std::vector<std::pair<Price, Qty>>& bids, std::vector<std::pair<Price, Qty>>& asks) const;
     Price last_trade_price() const;
     Qty last_trade_quantity() const;
-    void bindTradeThreadToCores(const std::vector<int>& cores);
+    void setTradePublisher(TradePublisher* publisher);
+    TradePublisher* tradePublisher() const { return publisher_; }
+    // Acks, fills, cancels and rejects of this book's orders go to `reports`.
+    void setExecReportPublisher(ExecReportPublisher* reports) { reports_ = reports; }
+    ExecReportPublisher* execReportPublisher() const { return reports_; }
+    // Cancels, rejects, unfilled remainders and modifies of accepted orders
+    // are passed to `hook` on the matching thread, whether or not reports are
+    // published.
+    void setLeavesHook(LeavesHook hook, void* context) {
+        leaves_hook_ = hook;
+        leaves_context_ = context;
+    }
+    void setPriceBands(const PriceBandSettings& settings);
+    // Warm-up, before trading: sizes the order table and index for ids below
+    // `orders` and gives every ring level a pool of `level_orders` nodes.
+    void reserve(std::size_t orders, std::size_t level_orders);
+    TradingState tradingState() const;
+    uint64_t bandRejects() const;
+    // Highest global sequence applied to this book (matching thread).
+    uint64_t lastSequence() const { return last_sequence_; }
 
 private:
     struct MatchParams {
@@ -82,6 +129,11 @@ private:
     };
 
     void executeMatch(OrderId orderId, const MatchParams& params);
+    ExecReason admitBands(Order& order);
+    void report(const Order& order, ExecType type, ExecReason reason = ExecReason::NONE, Price price = 0,
+                Qty last_qty = 0);
+    void reportReject(OrderId orderId, ExecReason reason);
+    void leavesChanged(OrderId orderId, Qty before, Qty after);
     void handleIceberg(Order& order);
     bool ensureFokLiquidity(const Order& order) const;
     PriceLevel* bestLevelMutable(Side side);
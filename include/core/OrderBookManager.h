@@ -15,7 +15,7 @@ public:
     const Order* bestAsk(InstrumentToken token) const;
     Qty totalOpenQtyAt(InstrumentToken token, Side side, Price price) const;
 
-    void setTradeListener(InstrumentToken token, OrderBook::TradeListener listener);
+    void addTradeSink(InstrumentToken token, TradeSink sink);
 
     OrderBook* findBook(InstrumentToken token);
     const OrderBook* findBook(InstrumentToken token) const;
@@ -17,6 +17,7 @@ private:
     InstrumentToken instrument_token_ = 0;
     OrderType order_type_ = OrderType::LIMIT;
     Side side_ = Side::INVALID;
+    uint64_t sequence_ = 0;
 
 public:
     OrderBuilder& setOrderId(OrderId id) {
@@ -59,11 +60,18 @@ public:
         return *this;
     }
 
+    OrderBuilder& setSequence(uint64_t sequence) {
+        sequence_ = sequence;
+        return *this;
+    }
+
     [[nodiscard]] std::unique_ptr<Order> build() {
         // if (!order_id_ || side_== Side::INVALID || !price_ || !quantity_)
         //     throw std::runtime_error("Missing required order fields");
 
-        return std::unique_ptr<Order>(new Order(order_id_, instrument_token_, side_, price_, quantity_, timestamp_, order_type_, display_quantity_));
+        auto order = std::unique_ptr<Order>(new Order(order_id_, instrument_token_, side_, price_, quantity_, timestamp_, order_type_, display_quantity_));
+        order->sequence_ = sequence_;
+        return order;
     }
 };
 
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "types/AppTypes.h"
+#include "types/OrderSide.h"
+#include "utils/CompilerHints.h"
+#include "utils/Config.h"
+
+enum class TradingState : uint8_t {
+    Continuous,
+    Halted,
+};
+
+/**
+ * @brief Static/dynamic price bands and volatility interruption for one book.
+ *
+ * The admissible window is recomputed only when the reference moves (on each
+ * trade), so the entry check is two comparisons. Time is taken from order
+ * timestamps, which keeps replays deterministic and avoids clock reads.
+ */
+class PriceBandGuard {
+public:
+    PriceBandGuard() = default;
+    explicit PriceBandGuard(const PriceBandSettings& settings);
+
+    bool active() const { return active_; }
+    TradingState state() const { return state_; }
+
+    bool admitsPrice(Price price) const { return price >= low_ && price <= high_; }
+
+    // Limit used to cap market orders so they cannot sweep past the band.
+    Price protectionPrice(Side side) const { return side == Side::BUY ? high_ : low_; }
+    bool hasReference() const { return last_price_ != 0; }
+
+    // Returns false while halted; lifts the halt once halt_until has passed.
+    bool admitsTrading(int64_t now_ns) {
+        if (LIKELY(state_ == TradingState::Continuous)) {
+            return true;
+        }
+        if (now_ns < halt_until_ns_) {
+            return false;
+        }
+        state_ = TradingState::Continuous;
+        anchor_price_ = 0;
+        return true;
+    }
+
+    // Returns true when this trade triggered a volatility interruption.
+    bool onTrade(Price price, int64_t now_ns);
+
+private:
+    void recomputeWindow();
+    static Price offset(Price reference, uint32_t bps);
+
+    PriceBandSettings settings_{};
+    bool active_ = false;
+    TradingState state_ = TradingState::Continuous;
+    Price low_ = 0;
+    Price high_ = std::numeric_limits<Price>::max();
+    Price static_reference_ = 0;
+    Price last_price_ = 0;
+    Price anchor_price_ = 0;
+    int64_t anchor_ns_ = 0;
+    int64_t halt_until_ns_ = 0;
+};
@@ -7,6 +7,7 @@
 
 #include "core/OrderArena.h"
 #include "types/OrderRequest.h"
+#include "utils/HugePages.h"
 
 class alignas(64) PriceLevel {
 public:
@@ -23,6 +24,9 @@ public:
     bool empty() const { return count_ == 0; }
     Qty openQty() const { return open_qty_; }
     void decOpenQty(Qty qty);
+    // Grows the free node pool to `nodes` entries (and touches them) so the
+    // first orders at this level do not reallocate. clear() keeps the pool.
+    void reserve(size_t nodes);
     void clear();
     void print(const OrderArena& arena) const;
 
@@ -35,7 +39,7 @@ private:
         size_t prev = kInvalidSlot;
     };
 
-    std::vector<Node> nodes_;
+    std::vector<Node, HugePageAllocator<Node, memory::Region::LADDERS>> nodes_;
     size_t head_slot_ = kInvalidSlot;
     size_t tail_slot_ = kInvalidSlot;
     size_t free_head_ = kInvalidSlot;
@@ -5,8 +5,10 @@
 #include <memory_resource>
 #include <memory>
 
+#include "datastructures/PriceChunkMap.h"
 #include "datastructures/RBTree.h"
 #include "types/AppTypes.h"
+#include "types/BookBackend.h"
 #include "core/PriceLevel.h"
 
 class SideContainer {
@@ -14,9 +16,12 @@ public:
     virtual ~SideContainer() = default;
     virtual PriceLevel* best() = 0;
     virtual const PriceLevel* best() const = 0;
+    virtual PriceLevel* best(Price& outPrice) = 0;
     virtual PriceLevel* find(Price price) = 0;
     virtual const PriceLevel* find(Price price) const = 0;
     virtual void insert(Price price, PriceLevel&& level) = 0;
+    // Returns the level at price, creating an empty one if needed.
+    virtual PriceLevel* emplace(Price price) = 0;
     virtual void erase(Price price) = 0;
     virtual bool empty() const = 0;
     virtual void forEach(const std::function<void(const Price&, PriceLevel&)>& fn) = 0;
@@ -28,11 +33,17 @@ class RbTreeSide final : public SideContainer {
 public:
     PriceLevel* best() override { return tree_.best(); }
     const PriceLevel* best() const override { return tree_.best(); }
+    PriceLevel* best(Price& outPrice) override { return tree_.findMin(&outPrice); }
 
     PriceLevel* find(Price price) override { return tree_.find(price); }
     const PriceLevel* find(Price price) const override { return tree_.find(price); }
 
     void insert(Price price, PriceLevel&& level) override { tree_.insert(price, std::move(level)); }
+    PriceLevel* emplace(Price price) override {
+        if (auto* level = tree_.find(price)) return level;
+        tree_.insert(price, PriceLevel{});
+        return tree_.find(price);
+    }
     void erase(Price price) override { tree_.erase(price); }
     bool empty() const override { return tree_.empty(); }
 
@@ -58,6 +69,11 @@ public:
         if (map_.empty()) return nullptr;
         return &map_.begin()->second;
     }
+    PriceLevel* best(Price& outPrice) override {
+        if (map_.empty()) return nullptr;
+        outPrice = map_.begin()->first;
+        return &map_.begin()->second;
+    }
 
     PriceLevel* find(Price price) override {
         auto it = map_.find(price);
@@ -74,6 +90,7 @@ public:
             it->second = std::move(level);
         }
     }
+    PriceLevel* emplace(Price price) override { return &map_.try_emplace(price).first->second; }
     void erase(Price price) override { map_.erase(price); }
     bool empty() const override { return map_.empty(); }
 
@@ -89,17 +106,55 @@ public:
     }
 
 private:
-    std::pmr::map<Price, PriceLevel, Compare> map_{&memory_};
+    // Declared before the map so it is constructed first and destroyed last.
     std::pmr::monotonic_buffer_resource memory_;
+    std::pmr::map<Price, PriceLevel, Compare> map_{&memory_};
 };
 
-inline std::unique_ptr<SideContainer> makeSideContainer(bool use_std_map, Side side) {
-    if (use_std_map) {
-        if (side == Side::BUY)
-            return std::make_unique<StdMapSide<std::greater<Price>>>();
-        return std::make_unique<StdMapSide<std::less<Price>>>();
+template <typename Compare>
+class ChunkMapSide final : public SideContainer {
+public:
+    PriceLevel* best() override { return map_.best(); }
+    const PriceLevel* best() const override { return map_.best(); }
+    PriceLevel* best(Price& outPrice) override { return map_.best(&outPrice); }
+
+    PriceLevel* find(Price price) override { return map_.find(price); }
+    const PriceLevel* find(Price price) const override { return map_.find(price); }
+
+    void insert(Price price, PriceLevel&& level) override { map_.insert(price, std::move(level)); }
+    PriceLevel* emplace(Price price) override { return map_.emplace(price); }
+    void erase(Price price) override { map_.erase(price); }
+    bool empty() const override { return map_.empty(); }
+
+    void forEach(const std::function<void(const Price&, PriceLevel&)>& fn) override {
+        map_.inOrder([&](const Price& p, PriceLevel& lvl) { fn(p, lvl); });
+    }
+    void forEachConst(const std::function<void(const Price&, const PriceLevel&)>& fn) const override {
+        map_.inOrder([&](const Price& p, PriceLevel& lvl) { fn(p, lvl); });
     }
+
+private:
+    PriceChunkMap<Price, PriceLevel, Compare> map_;
+};
+
+template <template <typename> class Container>
+std::unique_ptr<SideContainer> makeSideContainerFor(Side side) {
     if (side == Side::BUY)
-        return std::make_unique<RbTreeSide<std::greater<Price>>>();
-    return std::make_unique<RbTreeSide<std::less<Price>>>();
+        return std::make_unique<Container<std::greater<Price>>>();
+    return std::make_unique<Container<std::less<Price>>>();
+}
+
+// RING has no SideContainer form; OrderBook handles it directly.
+inline std::unique_ptr<SideContainer> makeSideContainer(BookBackend backend, Side side) {
+    switch (backend) {
+        case BookBackend::STD_MAP: return makeSideContainerFor<StdMapSide>(side);
+        case BookBackend::CHUNK_MAP: return makeSideContainerFor<ChunkMapSide>(side);
+        case BookBackend::RB_TREE:
+        case BookBackend::RING:
+        default: return makeSideContainerFor<RbTreeSide>(side);
+    }
+}
+
+inline std::unique_ptr<SideContainer> makeSideContainer(bool use_std_map, Side side) {
+    return makeSideContainer(use_std_map ? BookBackend::STD_MAP : BookBackend::RB_TREE, side);
 }
@@ -11,4 +11,6 @@ struct TradeEvent {
     OrderId restingOrderId;
     Price price;
     Qty quantity;
+    // Global sequence of the aggressing order (0 when unsequenced).
+    uint64_t sequence;
 };
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/TradeEvent.h"
+#include "core/TradeSink.h"
+#include "datastructures/SequencedRing.h"
+#include "types/TradeOverflow.h"
+#include "types/TradePublishMode.h"
+#include "utils/Config.h"
+#include "utils/WaitStrategy.h"
+
+class OrderBook;
+
+/**
+ * @brief Fans trade events of many books out to a set of consumers.
+ *
+ * One publisher serves every book of an engine shard, so the number of trade
+ * threads follows the shard and consumer counts rather than the instrument
+ * count. All of its books must be driven from a single matching thread.
+ *
+ * Consumer 0 hands each book its own trades for the book's sinks; more
+ * consumers (drop copy, market data, analytics) can be added before start().
+ * In THREAD mode events go through a SequencedRing and every consumer drains
+ * it on its own thread at its own pace; sinks get batches that are the ring
+ * slots themselves, with no copy. Books are attach()ed by token so consumer
+ * 0 can find them without storing a pointer per event; books tracked after
+ * start() wait in a mailbox that consumer 0 merges before its next batch, so
+ * a book tracked before its first trade is published is always found. Overflow
+ * decides what the matching thread does when the slowest consumer is a full
+ * ring behind. In INLINE mode consumers run on the matching thread, in
+ * registration order, and no thread is started.
+ *
+ * Destruction drains everything already published, so the attached books
+ * must still be alive when the publisher goes away.
+ */
+class TradePublisher {
+public:
+    using Mode = TradePublishMode;
+    using Overflow = TradeOverflow;
+
+    struct Options {
+        Mode mode = Mode::THREAD;
+        std::size_t capacity = 65536;
+        Overflow overflow = Overflow::BLOCK;
+        WaitSettings wait;
+        int core = -1;
+        // Consumer threads without a core are confined to these CPUs (e.g. one NUMA node).
+        std::vector<int> cpus;
+    };
+
+    struct ConsumerStats {
+        std::string name;
+        uint64_t consumed = 0;
+        uint64_t lag = 0;
+        uint64_t max_lag = 0;
+        WaitCounters waits;
+    };
+
+    TradePublisher();
+    explicit TradePublisher(const Options& options);
+    ~TradePublisher();
+
+    TradePublisher(const TradePublisher&) = delete;
+    TradePublisher& operator=(const TradePublisher&) = delete;
+
+    // Routes this book's trades through the publisher; only valid before start().
+    void attach(InstrumentToken token, OrderBook& book);
+    // Lets the publisher deliver to a book that may be attached later, when it
+    // migrates or is onboarded here. Thread-safe; must happen before the
+    // book's first trade is published here.
+    void track(InstrumentToken token, const OrderBook& book);
+    // Registers another consumer; only valid before start(). Returns its index.
+    std::size_t addConsumer(std::string name, TradeSink sink, int core = -1);
+    // Starts the consumer threads. publish() starts them on first use too.
+    void start();
+
+    void publish(const OrderBook& book, const TradeEvent& event);
+    // Matching thread: moves spilled events back into the ring while it has
+    // room. Returns how many are still spilled.
+    std::size_t flush();
+    // Matching thread: true once every published trade reached every consumer.
+    bool drained() const;
+
+    Mode mode() const { return options_.mode; }
+    Overflow overflow() const { return options_.overflow; }
+    uint64_t published() const { return published_.load(std::memory_order_relaxed); }
+    uint64_t stalls() const { return stalls_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t spilled() const { return spilled_.load(std::memory_order_relaxed); }
+    std::size_t consumerCount() const { return consumers_.size(); }
+    std::vector<ConsumerStats> consumerStats() const;
+
+private:
+    struct Consumer {
+        std::string name;
+        TradeSink sink;
+        int core = -1;
+        WaitStrategy wait;
+        std::atomic<uint64_t> consumed{0};
+        std::atomic<uint64_t> max_lag{0};
+        std::thread thread;
+
+        Consumer(std::string consumer_name, TradeSink consumer_sink, int consumer_core, const WaitSettings& settings)
+            : name(std::move(consumer_name)),
+              sink(consumer_sink),
+              core(consumer_core),
+              wait(settings) {}
+    };
+
+    // Consumer 0: splits a batch into per-book runs.
+    struct BookFanout {
+        TradePublisher* owner = nullptr;
+        void onTrades(TradeBatch trades) const;
+    };
+
+    static constexpr std::size_t kMaxBurst = 64;
+
+    void ensureNotStarted(const char* what) const;
+    void enqueue(const TradeEvent& event);
+    void notifyConsumers();
+    void mergeTracked();
+    void run(std::size_t index);
+    std::size_t drain(std::size_t index);
+
+    const Options options_;
+    BookFanout fanout_;
+    std::unordered_map<InstrumentToken, const OrderBook*> books_;
+    std::mutex tracked_mutex_;
+    std::vector<std::pair<InstrumentToken, const OrderBook*>> tracked_;
+    std::atomic<bool> tracked_pending_{false};
+    std::vector<std::unique_ptr<Consumer>> consumers_;
+    std::unique_ptr<SequencedRing<TradeEvent>> ring_;
+    std::deque<TradeEvent> spill_;
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> stalls_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> spilled_{0};
+    std::atomic<bool> running_{true};
+};
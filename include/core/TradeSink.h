@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include "core/TradeEvent.h"
+
+using TradeBatch = std::span<const TradeEvent>;
+
+/**
+ * @brief Non-owning reference to something that takes a batch of trades.
+ *
+ * Binds to an object with onTrades(TradeBatch) or to a callable taking a
+ * TradeBatch; either way a call is one indirect jump through a plain
+ * function pointer, with no refcount and no vtable. Only lvalues bind, and
+ * the target must outlive every sink that refers to it.
+ */
+class TradeSink {
+public:
+    TradeSink() = default;
+
+    template <typename T>
+        requires(!std::same_as<std::remove_cv_t<T>, TradeSink>)
+    TradeSink(T& target)  // NOLINT(google-explicit-constructor): sinks are passed by reference
+        : target_(const_cast<void*>(static_cast<const void*>(std::addressof(target)))),
+          call_(&invoke<T>) {}
+
+    void operator()(TradeBatch trades) const { call_(target_, trades); }
+    explicit operator bool() const { return call_ != nullptr; }
+
+private:
+    template <typename T>
+    static void invoke(void* target, TradeBatch trades) {
+        T& bound = *static_cast<T*>(target);
+        if constexpr (requires { bound.onTrades(trades); }) {
+            bound.onTrades(trades);
+        } else {
+            bound(trades);
+        }
+    }
+
+    void* target_ = nullptr;
+    void (*call_)(void*, TradeBatch) = nullptr;
+};
+
+/**
+ * @brief Fixed-capacity list of sinks, registered at startup and then only read.
+ */
+class TradeSinkChain {
+public:
+    static constexpr std::size_t kMaxSinks = 8;
+
+    void add(TradeSink sink) {
+        if (count_ == kMaxSinks) {
+            throw std::runtime_error("Trade sink chain is full");
+        }
+        sinks_[count_++] = sink;
+    }
+
+    void clear() { count_ = 0; }
+
+    void operator()(TradeBatch trades) const {
+        for (std::size_t i = 0; i < count_; ++i) {
+            sinks_[i](trades);
+        }
+    }
+
+    bool empty() const { return count_ == 0; }
+    std::size_t size() const { return count_; }
+
+private:
+    std::array<TradeSink, kMaxSinks> sinks_{};
+    std::size_t count_ = 0;
+};
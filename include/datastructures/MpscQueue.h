@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "utils/CompilerHints.h"
+#include "utils/HugePages.h"
+
+/**
+ * @brief Bounded multi-producer/single-consumer ring (Vyukov).
+ *
+ * Every cell carries a sequence number: equal to the position when the cell
+ * is free for that lap, position + 1 once a producer has filled it. A
+ * producer reserves a position with one CAS on the shared enqueue index and
+ * publishes by bumping the cell's sequence, so producers never wait on each
+ * other's copies and each producer's items come out in the order it pushed
+ * them. The single consumer needs no atomic read-modify-write at all.
+ *
+ * The capacity is rounded up to a power of two.
+ */
+template <typename T>
+class MpscQueue {
+public:
+    explicit MpscQueue(std::size_t capacity)
+        : mask_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1),
+          cells_(mask_ + 1) {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    bool push(const T& value) { return emplace(value); }
+    bool push(T&& value) { return emplace(std::move(value)); }
+
+    bool pop(T& out) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[head & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+        out = std::move(cell.value);
+        cell.sequence.store(head + mask_ + 1, std::memory_order_release);
+        head_.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Consumer: runs fn on up to `max` ready items in place, oldest first.
+    template <typename Fn>
+    std::size_t consume(std::size_t max, Fn&& fn) {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        std::size_t done = 0;
+        for (; done < max; ++done, ++head) {
+            Cell& cell = cells_[head & mask_];
+            if (cell.sequence.load(std::memory_order_acquire) != head + 1) {
+                break;
+            }
+            fn(static_cast<const T&>(cell.value));
+            cell.sequence.store(head + mask_ + 1, std::memory_order_release);
+        }
+        head_.store(head, std::memory_order_relaxed);
+        return done;
+    }
+
+    // Includes positions reserved by a producer that is still writing.
+    std::size_t read_available() const {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        return enqueue_.load(std::memory_order_acquire) - head;
+    }
+
+    std::size_t write_available() const {
+        const std::size_t used = read_available();
+        return used >= capacity() ? 0 : capacity() - used;
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<std::size_t> sequence{0};
+        T value{};
+    };
+
+    template <typename U>
+    bool emplace(U&& value) {
+        std::size_t pos = enqueue_.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            if (sequence == pos) {
+                if (LIKELY(enqueue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))) {
+                    break;
+                }
+            } else if (sequence < pos) {
+                return false;  // the consumer has not freed this cell for the current lap yet
+            } else {
+                pos = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::forward<U>(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    const std::size_t mask_;
+    std::vector<Cell, HugePageAllocator<Cell, memory::Region::QUEUES>> cells_;
+
+    alignas(64) std::atomic<std::size_t> enqueue_{0};
+    alignas(64) std::atomic<std::size_t> head_{0};
+};
@@ -0,0 +1,203 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "utils/MemPool.h"
+
+/**
+ * @brief Two-level B+tree keyed by price: a flat fence array over
+ *        cache-line aligned leaves that store their keys contiguously.
+ *
+ * A lookup binary-searches the fences and then scans one leaf, best() is the
+ * first key of the first leaf, and in-order iteration walks leaves front to
+ * back. Values live in a pool, so their address is stable while the key is
+ * present even though keys shift inside leaves.
+ */
+template <typename Key, typename Value, typename Compare = std::less<Key>, std::size_t LeafKeys = 16>
+class PriceChunkMap {
+    static_assert(LeafKeys >= 4 && LeafKeys % 2 == 0, "LeafKeys must be an even number >= 4");
+
+private:
+    struct alignas(64) Leaf {
+        Key keys[LeafKeys];
+        Value* values[LeafKeys];
+        std::size_t count = 0;
+    };
+
+    std::vector<Leaf*> leaves_;
+    std::vector<Key> fences_;  // fences_[i] == leaves_[i]->keys[0]
+    std::size_t size_ = 0;
+    Compare comp_{};
+    MemPool<Leaf, 64> leaf_pool_;
+    MemPool<Value, 256> value_pool_;
+
+public:
+    PriceChunkMap() = default;
+    ~PriceChunkMap() { clear(); }
+
+    PriceChunkMap(const PriceChunkMap&) = delete;
+    PriceChunkMap& operator=(const PriceChunkMap&) = delete;
+
+    Value* find(const Key& key) const {
+        if (leaves_.empty()) return nullptr;
+        const Leaf* leaf = leaves_[leafFor(key)];
+        const std::size_t pos = slotIn(*leaf, key);
+        return (pos < leaf->count && !comp_(key, leaf->keys[pos])) ? leaf->values[pos] : nullptr;
+    }
+
+    /**
+     * @brief Returns the value for @p key, default-constructing it if absent.
+     */
+    Value* emplace(const Key& key) {
+        if (leaves_.empty()) {
+            leaves_.push_back(leaf_pool_.allocate());
+            fences_.push_back(key);
+        }
+        std::size_t idx = leafFor(key);
+        Leaf* leaf = leaves_[idx];
+        std::size_t pos = slotIn(*leaf, key);
+        if (pos < leaf->count && !comp_(key, leaf->keys[pos])) {
+            return leaf->values[pos];
+        }
+
+        if (leaf->count == LeafKeys) {
+            splitLeaf(idx);
+            if (pos > LeafKeys / 2) {
+                pos -= LeafKeys / 2;
+                leaf = leaves_[++idx];
+            }
+        }
+
+        std::move_backward(leaf->keys + pos, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+        std::move_backward(leaf->values + pos, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+        leaf->keys[pos] = key;
+        leaf->values[pos] = value_pool_.allocate();
+        ++leaf->count;
+        if (pos == 0) fences_[idx] = key;
+        ++size_;
+        return leaf->values[pos];
+    }
+
+    bool insert(const Key& key, Value&& val) {
+        const std::size_t before = size_;
+        *emplace(key) = std::move(val);
+        return size_ != before;
+    }
+
+    bool erase(const Key& key) {
+        if (leaves_.empty()) return false;
+        const std::size_t idx = leafFor(key);
+        Leaf* leaf = leaves_[idx];
+        const std::size_t pos = slotIn(*leaf, key);
+        if (pos >= leaf->count || comp_(key, leaf->keys[pos])) return false;
+
+        value_pool_.deallocate(leaf->values[pos]);
+        std::move(leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos);
+        std::move(leaf->values + pos + 1, leaf->values + leaf->count, leaf->values + pos);
+        --leaf->count;
+        --size_;
+
+        if (leaf->count == 0) {
+            removeLeaf(idx);
+            return true;
+        }
+        if (pos == 0) fences_[idx] = leaf->keys[0];
+        if (idx + 1 < leaves_.size() && leaf->count + leaves_[idx + 1]->count <= LeafKeys / 2) {
+            mergeWithNext(idx);
+        } else if (idx > 0 && leaves_[idx - 1]->count + leaf->count <= LeafKeys / 2) {
+            mergeWithNext(idx - 1);
+        }
+        return true;
+    }
+
+    /**
+     * @brief First entry in comparator order (top of book).
+     */
+    Value* best(Key* outKey = nullptr) const {
+        if (leaves_.empty()) return nullptr;
+        if (outKey) *outKey = leaves_.front()->keys[0];
+        return leaves_.front()->values[0];
+    }
+
+    bool empty() const { return size_ == 0; }
+    std::size_t size() const { return size_; }
+    std::size_t leafCount() const { return leaves_.size(); }
+
+    /**
+     * @brief Visits entries in comparator order. If @p fn returns bool,
+     *        returning false stops the walk early.
+     */
+    template <typename Func>
+    void inOrder(Func&& fn) const {
+        for (const Leaf* leaf : leaves_) {
+            for (std::size_t i = 0; i < leaf->count; ++i) {
+                if constexpr (std::is_same_v<std::invoke_result_t<Func&, const Key&, Value&>, bool>) {
+                    if (!fn(leaf->keys[i], *leaf->values[i])) return;
+                } else {
+                    fn(leaf->keys[i], *leaf->values[i]);
+                }
+            }
+        }
+    }
+
+    void clear() {
+        for (Leaf* leaf : leaves_) {
+            for (std::size_t i = 0; i < leaf->count; ++i) {
+                value_pool_.deallocate(leaf->values[i]);
+            }
+            leaf_pool_.deallocate(leaf);
+        }
+        leaves_.clear();
+        fences_.clear();
+        size_ = 0;
+    }
+
+private:
+    // Last leaf whose fence is not ordered after key; leaf 0 for keys before every fence.
+    std::size_t leafFor(const Key& key) const {
+        const auto it = std::upper_bound(fences_.begin(), fences_.end(), key, comp_);
+        return it == fences_.begin() ? 0 : static_cast<std::size_t>(it - fences_.begin()) - 1;
+    }
+
+    // First slot whose key is not ordered before key. Leaves are small, so a
+    // forward scan beats a binary search here.
+    std::size_t slotIn(const Leaf& leaf, const Key& key) const {
+        std::size_t pos = 0;
+        while (pos < leaf.count && comp_(leaf.keys[pos], key)) ++pos;
+        return pos;
+    }
+
+    void splitLeaf(std::size_t idx) {
+        Leaf* left = leaves_[idx];
+        Leaf* right = leaf_pool_.allocate();
+        constexpr std::size_t half = LeafKeys / 2;
+        std::move(left->keys + half, left->keys + LeafKeys, right->keys);
+        std::move(left->values + half, left->values + LeafKeys, right->values);
+        right->count = LeafKeys - half;
+        left->count = half;
+        const auto offset = static_cast<std::ptrdiff_t>(idx + 1);
+        leaves_.insert(leaves_.begin() + offset, right);
+        fences_.insert(fences_.begin() + offset, right->keys[0]);
+    }
+
+    void mergeWithNext(std::size_t idx) {
+        Leaf* left = leaves_[idx];
+        Leaf* right = leaves_[idx + 1];
+        std::move(right->keys, right->keys + right->count, left->keys + left->count);
+        std::move(right->values, right->values + right->count, left->values + left->count);
+        left->count += right->count;
+        right->count = 0;
+        removeLeaf(idx + 1);
+    }
+
+    void removeLeaf(std::size_t idx) {
+        leaf_pool_.deallocate(leaves_[idx]);
+        const auto offset = static_cast<std::ptrdiff_t>(idx);
+        leaves_.erase(leaves_.begin() + offset);
+        fences_.erase(fences_.begin() + offset);
+    }
+};
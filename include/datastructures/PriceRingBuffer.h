@@ -4,12 +4,23 @@
 #include <cstddef>
 #include <functional>
 #include <limits>
+#include <new>
 
 #include "core/PriceLevel.h"
+#include "datastructures/RBTree.h"
 #include "utils/CompilerHints.h"
 #include "types/AppTypes.h"
 #include "types/OrderSide.h"
-
+#include "utils/HugePages.h"
+
+/**
+ * @brief Fixed window of price slots around the touch, with an RBTree
+ *        overflow for levels that fall outside it.
+ *
+ * The window always contains the best price, so every overflow level is
+ * worse than the ring's best and top-of-book never consults the tree while
+ * the ring holds a level.
+ */
 class alignas(64) PriceRingBuffer {
 public:
     static constexpr size_t kCapacity = 1024;
@@ -19,6 +30,14 @@ public:
 
     explicit PriceRingBuffer(Side side);
 
+    // The slot array is most of a book's footprint; it lives in the ladders region.
+    static void* operator new(std::size_t size, std::align_val_t align) {
+        return memory::allocate(memory::Region::LADDERS, size, static_cast<std::size_t>(align));
+    }
+    static void operator delete(void* ptr, std::size_t size, std::align_val_t align) noexcept {
+        memory::deallocate(memory::Region::LADDERS, ptr, size, static_cast<std::size_t>(align));
+    }
+
     PriceLevel* findLevel(Price price);
     const PriceLevel* findLevel(Price price) const;
     PriceLevel* ensureLevel(Price price);
@@ -37,8 +56,11 @@ public:
     template <typename Fn>
     void forEachAscending(Fn&& fn) const;
 
-    bool empty() const { return active_levels_ == 0; }
+    bool empty() const { return active_levels_ == 0 && overflow_.empty(); }
     Qty totalOpenQtyAt(Price price) const;
+    size_t overflowLevels() const { return overflow_.size(); }
+    // Pre-grows the order list of every slot; window shifts keep the pools in the ring.
+    void reserveLevels(size_t orders);
 
 private:
     struct alignas(64) Slot {
@@ -58,6 +80,7 @@ private:
     size_t active_levels_ = 0;
     size_t best_slot_ = kInvalidSlot;
     Price best_price_ = 0;
+    RBTree<Price, PriceLevel> overflow_;
 
     void initializeBase(Price price);
     size_t logicalIndex(Price price) const;
@@ -65,29 +88,45 @@ private:
     size_t slotIndex(Price price) const;
     bool priceInWindow(Price price) const;
     void rebalanceWindow(Price focus_price);
+    void shiftWindow(Price new_base);
     Price clampBase(Price candidate) const;
+    bool improvesBest(Price price) const;
+    PriceLevel* overflowBest(Price& out_price) const;
     void updateBestCandidate(size_t slotIdx);
     void recomputeBest() const;
     void recomputeBestInternal();
     bool ensureBestSlot() const;
 };
 
+// Bid overflow sits below the window and ask overflow above it.
 template <typename Fn>
 void PriceRingBuffer::forEachAscending(Fn&& fn) {
+    if (side_ == Side::BUY) {
+        overflow_.inOrder([&](const Price& price, PriceLevel& level) { fn(price, level); });
+    }
     for (auto& slot : slots_) {
         if (!slot.active || slot.level.empty()) {
             continue;
         }
         fn(slot.price, slot.level);
     }
+    if (side_ != Side::BUY) {
+        overflow_.inOrder([&](const Price& price, PriceLevel& level) { fn(price, level); });
+    }
 }
 
 template <typename Fn>
 void PriceRingBuffer::forEachAscending(Fn&& fn) const {
+    if (side_ == Side::BUY) {
+        overflow_.inOrder([&](const Price& price, const PriceLevel& level) { fn(price, level); });
+    }
     for (const auto& slot : slots_) {
         if (!slot.active || slot.level.empty()) {
             continue;
         }
         fn(slot.price, slot.level);
     }
+    if (side_ != Side::BUY) {
+        overflow_.inOrder([&](const Price& price, const PriceLevel& level) { fn(price, level); });
+    }
 }
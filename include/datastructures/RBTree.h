@@ -1,46 +1,48 @@
 #pragma once
 #include <functional>
 #include <memory>
+#include <type_traits>
 
 #include "utils/LogMacros.h"
+#include "utils/MemPool.h"
 /**
  * @brief Generic header-only Red-Black Tree.
  *        Supports both ascending and descending order via comparator.
  *        Designed for order books (price → PriceLevel).
+ *
+ *        Nodes come from a pooled arena, the leftmost/rightmost nodes are
+ *        cached so best()/worst() are O(1), and traversal walks parent links
+ *        instead of recursing.
  */
 
-template <typename Key, typename Value, typename Compare = std::less<Key>>
+template <typename Key, typename Value, typename Compare = std::less<Key>, std::size_t PoolChunk = 256>
 class RBTree {
 private:
     enum class Color { RED, BLACK };
 
+    // Key and links first so a descent only touches the node's first cache line.
     struct Node {
         Key key;
-        Value value;
         Color color;
         Node* parent;
         Node* left;
         Node* right;
+        Value value;
 
         Node(const Key& k, Value&& v, Color c, Node* p)
-            : key(k), value(std::move(v)), color(c), parent(p), left(nullptr), right(nullptr) {}
+            : key(k), color(c), parent(p), left(nullptr), right(nullptr), value(std::move(v)) {}
     };
 
-    template <typename Func>
-    void inOrderImpl(Node* node, Func&& fn) const {
-        if (!node) return;
-        inOrderImpl(node->left, fn);
-        fn(node->key, node->value);
-        inOrderImpl(node->right, fn);
-    }
-
     Node* root_ = nullptr;
+    Node* leftmost_ = nullptr;
+    Node* rightmost_ = nullptr;
     size_t size_ = 0;
     Compare comp_{};
+    MemPool<Node, PoolChunk> pool_;
 
 public:
     RBTree() = default;
-    ~RBTree() { clear(root_); }
+    ~RBTree() { clear(); }
 
     RBTree(const RBTree&) = delete;
     RBTree& operator=(const RBTree&) = delete;
@@ -65,7 +67,7 @@ public:
             }
         }
 
-        Node* node = new Node(key, std::move(val), Color::RED, parent);
+        Node* node = pool_.allocate(key, std::move(val), Color::RED, parent);
         if (!parent)
             root_ = node;
         else if (comp_(key, parent->key))
@@ -73,46 +75,62 @@ public:
         else
             parent->right = node;
 
+        // Rotations never change in-order extremes, so compare once here.
+        if (!leftmost_ || comp_(key, leftmost_->key))
+            leftmost_ = node;
+        if (!rightmost_ || comp_(rightmost_->key, key))
+            rightmost_ = node;
+
         fixInsert(node);
         size_++;
         return true;
     }
 
     Value* find(const Key& key) const {
-        Node* cur = root_;
-        while (cur) {
-            if (comp_(key, cur->key))
-                cur = cur->left;
-            else if (comp_(cur->key, key))
-                cur = cur->right;
-            else
-                return &cur->value;
-        }
-        return nullptr;
+        Node* n = findNode(key);
+        return n ? &n->value : nullptr;
+    }
+
+    /**
+     * @brief First entry whose key is not ordered before @p key.
+     */
+    Value* lowerBound(const Key& key, Key* outKey = nullptr) const {
+        Node* n = lowerBoundNode(key);
+        if (!n) return nullptr;
+        if (outKey) *outKey = n->key;
+        return &n->value;
     }
 
     bool erase(const Key& key) {
         Node* node = findNode(key);
         if (!node) return false;
+        if (node == leftmost_)
+            leftmost_ = successor(node);
+        if (node == rightmost_)
+            rightmost_ = predecessor(node);
         deleteNode(node);
         size_--;
         return true;
     }
 
-    Value* findMin() const {
-        Node* n = minNode(root_);
-        return n ? &n->value : nullptr;
+    Value* findMin(Key* outKey = nullptr) const {
+        if (!leftmost_) return nullptr;
+        if (outKey) *outKey = leftmost_->key;
+        return &leftmost_->value;
     }
 
-    Value* findMax() const {
-        Node* n = maxNode(root_);
-        return n ? &n->value : nullptr;
+    Value* findMax(Key* outKey = nullptr) const {
+        if (!rightmost_) return nullptr;
+        if (outKey) *outKey = rightmost_->key;
+        return &rightmost_->value;
     }
 
     bool empty() const { return root_ == nullptr; }
     size_t size() const { return size_; }
 
-    void printInOrder() const { printInOrder(root_); }
+    void printInOrder() const {
+        inOrder([](const Key& key, Value&) { LOG_INFO("{}", key); });
+    }
 
     /**
      * @brief Returns pointer to best (top-of-book) value.
@@ -132,15 +150,65 @@ public:
         return findMax();
     }
 
+    /**
+     * @brief Visits entries in comparator order. If @p fn returns bool,
+     *        returning false stops the walk early.
+     */
     template <typename Func>
     void inOrder(Func&& fn) const {
-        inOrderImpl(root_, std::forward<Func>(fn));
+        walkFrom(leftmost_, std::forward<Func>(fn));
+    }
+
+    /**
+     * @brief Like inOrder(), starting at lowerBound(@p key).
+     */
+    template <typename Func>
+    void inOrderFrom(const Key& key, Func&& fn) const {
+        walkFrom(lowerBoundNode(key), std::forward<Func>(fn));
+    }
+
+    void clear() {
+        // Iterative post-order release; no recursion on deep trees.
+        Node* n = root_;
+        while (n) {
+            if (n->left) {
+                n = n->left;
+                continue;
+            }
+            if (n->right) {
+                n = n->right;
+                continue;
+            }
+            Node* parent = n->parent;
+            if (parent) {
+                if (parent->left == n)
+                    parent->left = nullptr;
+                else
+                    parent->right = nullptr;
+            }
+            pool_.deallocate(n);
+            n = parent;
+        }
+        root_ = leftmost_ = rightmost_ = nullptr;
+        size_ = 0;
     }
 
 private:
     // ==========================================================
     //  INTERNAL HELPERS
     // ==========================================================
+    template <typename Func>
+    void walkFrom(Node* n, Func&& fn) const {
+        while (n) {
+            if constexpr (std::is_same_v<std::invoke_result_t<Func&, const Key&, Value&>, bool>) {
+                if (!fn(n->key, n->value)) return;
+            } else {
+                fn(n->key, n->value);
+            }
+            n = successor(n);
+        }
+    }
+
     Node* findNode(const Key& key) const {
         Node* cur = root_;
         while (cur) {
@@ -154,32 +222,54 @@ private:
         return nullptr;
     }
 
-    Node* minNode(Node* n) const {
+    Node* lowerBoundNode(const Key& key) const {
+        Node* cur = root_;
+        Node* result = nullptr;
+        while (cur) {
+            if (comp_(cur->key, key)) {
+                cur = cur->right;
+            } else {
+                result = cur;
+                cur = cur->left;
+            }
+        }
+        return result;
+    }
+
+    static Node* minNode(Node* n) {
         if (!n) return nullptr;
         while (n->left) n = n->left;
         return n;
     }
 
-    Node* maxNode(Node* n) const {
+    static Node* maxNode(Node* n) {
         if (!n) return nullptr;
         while (n->right) n = n->right;
         return n;
     }
 
-    void clear(Node* n) {
-        if (!n) return;
-        clear(n->left);
-        clear(n->right);
-        delete n;
+    static Node* successor(Node* n) {
+        if (n->right) return minNode(n->right);
+        Node* p = n->parent;
+        while (p && n == p->right) {
+            n = p;
+            p = p->parent;
+        }
+        return p;
     }
 
-    void printInOrder(Node* n) const {
-        if (!n) return;
-        printInOrder(n->left);
-        LOG_INFO("{}", n->key);
-        printInOrder(n->right);
+    static Node* predecessor(Node* n) {
+        if (n->left) return maxNode(n->left);
+        Node* p = n->parent;
+        while (p && n == p->left) {
+            n = p;
+            p = p->parent;
+        }
+        return p;
     }
 
+    static bool isBlack(const Node* n) { return !n || n->color == Color::BLACK; }
+
     // ==========================================================
     //  ROTATION / BALANCING LOGIC
     // ==========================================================
@@ -200,6 +290,7 @@ private:
     }
 
     void rotateRight(Node* y) {
+        if (!y || !y->left) return;
         Node* x = y->left;
         y->left = x->right;
         if (x->right) x->right->parent = y;
@@ -273,21 +364,26 @@ private:
     void deleteNode(Node* z) {
         Node* y = z;
         Node* x = nullptr;
+        Node* xParent = nullptr;
         Color yColor = y->color;
 
         if (!z->left) {
             x = z->right;
+            xParent = z->parent;
             transplant(z, z->right);
         } else if (!z->right) {
             x = z->left;
+            xParent = z->parent;
             transplant(z, z->left);
         } else {
             y = minNode(z->right);
             yColor = y->color;
             x = y->right;
             if (y->parent == z) {
+                xParent = y;
                 if (x) x->parent = y;
             } else {
+                xParent = y->parent;
                 transplant(y, y->right);
                 y->right = z->right;
                 if (y->right) y->right->parent = y;
@@ -298,75 +394,80 @@ private:
             y->color = z->color;
         }
 
-        delete z;
+        pool_.deallocate(z);
         if (yColor == Color::BLACK)
-            fixDelete(x);
+            fixDelete(x, xParent);
     }
 
-    void fixDelete(Node* x) {
-        while (x != root_ && (!x || x->color == Color::BLACK)) {
-            Node* parent = x ? x->parent : nullptr;
-            if (!parent) break;
-
-            bool leftChild = (x == parent->left);
-            Node* sibling  = leftChild ? parent->right : parent->left;
+    // x may be null (a black leaf), so its parent is tracked explicitly.
+    void fixDelete(Node* x, Node* parent) {
+        while (x != root_ && isBlack(x) && parent) {
+            if (x == parent->left) {
+                Node* sibling = parent->right;
+                if (sibling && sibling->color == Color::RED) {
+                    sibling->color = Color::BLACK;
+                    parent->color = Color::RED;
+                    rotateLeft(parent);
+                    sibling = parent->right;
+                }
+                if (!sibling) {
+                    x = parent;
+                    parent = x->parent;
+                    continue;
+                }
+                if (isBlack(sibling->left) && isBlack(sibling->right)) {
+                    sibling->color = Color::RED;
+                    x = parent;
+                    parent = x->parent;
+                    continue;
+                }
+                if (isBlack(sibling->right)) {
+                    if (sibling->left) sibling->left->color = Color::BLACK;
+                    sibling->color = Color::RED;
+                    rotateRight(sibling);
+                    sibling = parent->right;
+                }
+                sibling->color = parent->color;
+                parent->color = Color::BLACK;
+                if (sibling->right) sibling->right->color = Color::BLACK;
+                rotateLeft(parent);
+                x = root_;
+                break;
+            }
 
+            Node* sibling = parent->left;
+            if (sibling && sibling->color == Color::RED) {
+                sibling->color = Color::BLACK;
+                parent->color = Color::RED;
+                rotateRight(parent);
+                sibling = parent->left;
+            }
             if (!sibling) {
                 x = parent;
+                parent = x->parent;
                 continue;
             }
-
-            if (sibling->color == Color::RED) {
-                sibling->color = Color::BLACK;
-                parent->color  = Color::RED;
-                if (leftChild)
-                    rotateLeft(parent);
-                else
-                    rotateRight(parent);
-                sibling = leftChild ? parent->right : parent->left;
-                if (!sibling) continue;
-            }
-
-            bool leftBlack  = !sibling->left  || sibling->left->color  == Color::BLACK;
-            bool rightBlack = !sibling->right || sibling->right->color == Color::BLACK;
-
-            if (leftBlack && rightBlack) {
+            if (isBlack(sibling->left) && isBlack(sibling->right)) {
                 sibling->color = Color::RED;
                 x = parent;
+                parent = x->parent;
                 continue;
             }
-
-            if (leftChild) {
-                if (sibling->right && sibling->right->color == Color::BLACK) {
-                    if (sibling->left) sibling->left->color = Color::BLACK;
-                    sibling->color = Color::RED;
-                    rotateRight(sibling);
-                    sibling = parent->right;
-                    if (!sibling) continue;
-                }
-            } else {
-                if (sibling->left && sibling->left->color == Color::BLACK) {
-                    if (sibling->right) sibling->right->color = Color::BLACK;
-                    sibling->color = Color::RED;
-                    rotateLeft(sibling);
-                    sibling = parent->left;
-                    if (!sibling) continue;
-                }
+            if (isBlack(sibling->left)) {
+                if (sibling->right) sibling->right->color = Color::BLACK;
+                sibling->color = Color::RED;
+                rotateLeft(sibling);
+                sibling = parent->left;
             }
-
             sibling->color = parent->color;
-            parent->color  = Color::BLACK;
-            if (leftChild && sibling->right)
-                sibling->right->color = Color::BLACK;
-            else if (!leftChild && sibling->left)
-                sibling->left->color = Color::BLACK;
-
-            if (leftChild)
-                rotateLeft(parent);
-            else
-                rotateRight(parent);
+            parent->color = Color::BLACK;
+            if (sibling->left) sibling->left->color = Color::BLACK;
+            rotateRight(parent);
+            x = root_;
             break;
         }
+        if (x)
+            x->color = Color::BLACK;
     }
 
 };
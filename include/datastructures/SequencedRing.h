@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "utils/CompilerHints.h"
+#include "utils/HugePages.h"
+
+/**
+ * @brief Single-producer ring read by a fixed set of independent consumers.
+ *
+ * Every event gets a sequence number. The producer owns the published
+ * cursor; each consumer owns its own cursor on a separate cache line and
+ * reads slots in place, so N consumers see the same events without any
+ * copy and without coordinating with each other. A slot is only reused once
+ * every consumer has moved past it: the producer gates on the slowest
+ * cursor, re-reading the cursors only when its cached minimum says the ring
+ * looks full. Nothing is ever overwritten behind a consumer's back; a full
+ * ring is reported to the producer, which decides what to do.
+ *
+ * The number of consumers is fixed at construction. The capacity is rounded
+ * up to a power of two.
+ */
+template <typename T>
+class SequencedRing {
+public:
+    SequencedRing(std::size_t capacity, std::size_t consumers)
+        : mask_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1),
+          buffer_(mask_ + 1),
+          consumer_count_(consumers),
+          cursors_(std::make_unique<Cursor[]>(consumers)) {}
+
+    SequencedRing(const SequencedRing&) = delete;
+    SequencedRing& operator=(const SequencedRing&) = delete;
+
+    // Producer: false when the slowest consumer is a full ring behind.
+    bool tryPublish(const T& value) {
+        const uint64_t seq = next_;
+        if (UNLIKELY(seq - gate_ >= capacity())) {
+            gate_ = minCursor(seq);
+            if (seq - gate_ >= capacity()) {
+                return false;
+            }
+        }
+        buffer_[seq & mask_] = value;
+        next_ = seq + 1;
+        published_.store(seq + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer `consumer`: up to `max` unread events in sequence order, as
+    // the slots themselves. They stay valid until release(); the run stops at
+    // the end of the buffer, so call again for the wrapped part.
+    std::span<const T> peek(std::size_t consumer, std::size_t max) const {
+        const uint64_t from = cursors_[consumer].value.load(std::memory_order_relaxed);
+        const uint64_t ready = published_.load(std::memory_order_acquire) - from;
+        const std::size_t offset = static_cast<std::size_t>(from & mask_);
+        const std::size_t count =
+            static_cast<std::size_t>(std::min<uint64_t>({ready, max, capacity() - offset}));
+        return {buffer_.data() + offset, count};
+    }
+
+    // Consumer `consumer`: hands the first `count` events of its last peek() back.
+    void release(std::size_t consumer, std::size_t count) {
+        std::atomic<uint64_t>& cursor = cursors_[consumer].value;
+        cursor.store(cursor.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // Consumer `consumer`: fn(const T&) over up to `max` events, then release.
+    template <typename Fn>
+    std::size_t consume(std::size_t consumer, std::size_t max, Fn&& fn) {
+        std::size_t handled = 0;
+        while (handled < max) {
+            const std::span<const T> events = peek(consumer, max - handled);
+            if (events.empty()) {
+                break;
+            }
+            for (const T& event : events) {
+                fn(event);
+            }
+            release(consumer, events.size());
+            handled += events.size();
+        }
+        return handled;
+    }
+
+    uint64_t published() const { return published_.load(std::memory_order_acquire); }
+    uint64_t cursor(std::size_t consumer) const {
+        return cursors_[consumer].value.load(std::memory_order_acquire);
+    }
+    // Events published but not yet consumed by `consumer`.
+    uint64_t lag(std::size_t consumer) const { return published() - cursor(consumer); }
+
+    std::size_t consumers() const { return consumer_count_; }
+    std::size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct alignas(64) Cursor {
+        std::atomic<uint64_t> value{0};
+    };
+
+    uint64_t minCursor(uint64_t upper) const {
+        uint64_t lowest = upper;
+        for (std::size_t i = 0; i < consumer_count_; ++i) {
+            lowest = std::min(lowest, cursors_[i].value.load(std::memory_order_acquire));
+        }
+        return lowest;
+    }
+
+    const std::size_t mask_;
+    std::vector<T, HugePageAllocator<T, memory::Region::QUEUES>> buffer_;
+    const std::size_t consumer_count_;
+    std::unique_ptr<Cursor[]> cursors_;
+
+    // Producer line: consumers only read published_.
+    alignas(64) std::atomic<uint64_t> published_{0};
+    uint64_t next_ = 0;
+    uint64_t gate_ = 0;
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "utils/CompilerHints.h"
+#include "utils/HugePages.h"
+
+/**
+ * @brief Bounded single-producer/single-consumer ring.
+ *
+ * Producer and consumer indices live on separate cache lines and each side
+ * keeps a private copy of the other's index, refreshed only when the ring
+ * looks full (producer) or empty (consumer). In steady state a push or pop
+ * touches only its own line plus the slot, so the line carrying the remote
+ * index stops bouncing between cores on every message.
+ *
+ * Indices grow monotonically and are masked into the buffer, so the capacity
+ * is rounded up to a power of two and every slot is usable.
+ *
+ * Besides single push/pop, both sides can work on contiguous runs of slots
+ * in place: the producer claim()s free slots, fills them and commit()s, the
+ * consumer peek()s ready slots and release()s them, so one index store
+ * publishes a whole batch and no intermediate copy is made. Runs stop at the
+ * end of the buffer; call again for the wrapped part.
+ */
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(std::size_t capacity)
+        : mask_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1),
+          buffer_(mask_ + 1) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    bool push(const T& value) { return emplace(value); }
+    bool push(T&& value) { return emplace(std::move(value)); }
+
+    bool pop(T& out) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (UNLIKELY(head == cached_tail_)) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+        out = std::move(buffer_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Returns how many of items[0, n) were pushed, in order.
+    std::size_t try_push_n(const T* items, std::size_t n) {
+        std::size_t pushed = 0;
+        while (pushed < n) {
+            const std::span<T> slots = claim(n - pushed);
+            if (slots.empty()) {
+                break;
+            }
+            std::copy_n(items + pushed, slots.size(), slots.begin());
+            pushed += slots.size();
+            commit(slots.size());
+        }
+        return pushed;
+    }
+
+    // Returns how many items were moved into out[0, n).
+    std::size_t try_pop_n(T* out, std::size_t n) {
+        std::size_t popped = 0;
+        while (popped < n) {
+            const std::span<T> slots = peek(n - popped);
+            if (slots.empty()) {
+                break;
+            }
+            std::move(slots.begin(), slots.end(), out + popped);
+            popped += slots.size();
+            release(slots.size());
+        }
+        return popped;
+    }
+
+    // Producer: up to `max` free slots starting at the write position. The
+    // slots are invisible to the consumer until commit(); claiming again
+    // without a commit hands out the same slots.
+    std::span<T> claim(std::size_t max) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        std::size_t free = capacity() - (tail - cached_head_);
+        if (free < max) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            free = capacity() - (tail - cached_head_);
+        }
+        const std::size_t offset = tail & mask_;
+        return {buffer_.data() + offset, std::min({max, free, capacity() - offset})};
+    }
+
+    // Producer: publishes the first `count` slots of the last claim().
+    void commit(std::size_t count) {
+        tail_.store(tail_.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // Consumer: up to `max` ready slots, oldest first, valid until release().
+    std::span<T> peek(std::size_t max) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        std::size_t ready = cached_tail_ - head;
+        if (ready < max) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            ready = cached_tail_ - head;
+        }
+        const std::size_t offset = head & mask_;
+        return {buffer_.data() + offset, std::min({max, ready, capacity() - offset})};
+    }
+
+    // Consumer: hands the first `count` slots of the last peek() back to the producer.
+    void release(std::size_t count) {
+        head_.store(head_.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // Consumer: runs fn on up to `max` ready items in place, oldest first.
+    template <typename Fn>
+    std::size_t consume(std::size_t max, Fn&& fn) {
+        std::size_t done = 0;
+        while (done < max) {
+            const std::span<T> ready = peek(max - done);
+            if (ready.empty()) {
+                break;
+            }
+            for (const T& item : ready) {
+                fn(item);
+            }
+            release(ready.size());
+            done += ready.size();
+        }
+        return done;
+    }
+
+    // Safe from either side; exact for the calling side, a snapshot otherwise.
+    std::size_t read_available() const {
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+
+    std::size_t write_available() const { return capacity() - read_available(); }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+private:
+    template <typename U>
+    bool emplace(U&& value) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (UNLIKELY(tail - cached_head_ > mask_)) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_) {
+                return false;
+            }
+        }
+        buffer_[tail & mask_] = std::forward<U>(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Read-only after construction; shared by both sides without contention.
+    const std::size_t mask_;
+    std::vector<T, HugePageAllocator<T, memory::Region::QUEUES>> buffer_;
+
+    // Producer line.
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    std::size_t cached_head_ = 0;
+
+    // Consumer line.
+    alignas(64) std::atomic<std::size_t> head_{0};
+    std::size_t cached_tail_ = 0;
+};
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/ExecReportPublisher.h"
+#include "core/OrderBook.h"
+#include "core/TradePublisher.h"
+#include "ingress/OrderDispatcher.h"
+#include "ingress/WireOrder.h"
+#include "snapshot/SnapshotPublisher.h"
+#include "utils/WaitStrategy.h"
+
+namespace engine {
+
+// Load of one instrument, stable across migrations. processed is written by
+// the owning shard; shard names the current owner.
+struct InstrumentLoad {
+    InstrumentToken token = 0;
+    OrderDispatcher::Queue* queue = nullptr;
+    std::atomic<uint64_t> processed{0};
+    std::atomic<std::size_t> shard{0};
+};
+
+/**
+ * @brief One engine thread owning many books.
+ *
+ * Each instrument keeps its own SPSC queue so the dispatcher and risk stage
+ * routing stays per instrument; run() sweeps the shard's queues and drains a
+ * bounded burst from each, so one busy instrument cannot starve the rest.
+ * Producers reach a shard through routeFor(); the queue names the shard's
+ * WaitStrategy so a parked shard is woken by the push. Trades of every book
+ * in the shard leave through one TradePublisher, and with
+ * enableExecReports() their execution reports through one
+ * ExecReportPublisher, whose stream id is the shard id.
+ *
+ * A running shard can hand an instrument to another one (requestRelease()).
+ * The queue travels with the book, so producers keep pushing into the same
+ * queue and nothing is lost or reordered. The releasing shard acts between
+ * sweeps: it waits (at most the migration pause) until its trade publisher
+ * has delivered every trade already matched and every report is sent, then
+ * posts the instrument to the target, which re-points the queue's consumer
+ * at itself and adopts it between its own sweeps. Any book a shard may
+ * adopt must be tracked by its trade publisher before it arrives
+ * (ShardBalancer does this).
+ *
+ * onboard() adds an instrument to a running shard the same way: the book
+ * and queue are built by the caller's thread, prepared, and handed over as
+ * an adoption.
+ *
+ * queueFor(), bookFor() and forEachBook() walk the shard's current
+ * instruments and are only safe while the shard is not running.
+ */
+class EngineShard {
+public:
+    using Queue = OrderDispatcher::Queue;
+
+    EngineShard(std::size_t id, int core, std::size_t queue_capacity, const WaitSettings& wait = {},
+                const TradePublisher::Options& trade = {});
+
+    EngineShard(const EngineShard&) = delete;
+    EngineShard& operator=(const EngineShard&) = delete;
+
+    // multi_producer selects an MPSC queue for instruments fed by more than one producer.
+    OrderBook& addInstrument(InstrumentToken token, std::unique_ptr<OrderBook> book, bool multi_producer = false);
+    // Thread-safe: builds the instrument on the calling thread and hands it to
+    // the shard, which adopts it between sweeps. prepare runs before the
+    // hand-over, while the caller still owns the book, to add trade sinks or
+    // route the queue. The load record stays valid for the shard's lifetime.
+    using Prepare = std::function<void(OrderBook& book, Queue& queue)>;
+    InstrumentLoad& onboard(InstrumentToken token, std::unique_ptr<OrderBook> book, bool multi_producer,
+                            const Prepare& prepare);
+    void setSnapshotPublisher(SnapshotPublisher* publisher);
+    // Before run(); books added or adopted later report through it as well.
+    void enableExecReports(const ExecReportPublisher::Options& options, ExecReportPublisher::Transport transport);
+    void setMigrationPause(std::chrono::microseconds pause) { migration_pause_ = pause; }
+
+    Queue* queueFor(InstrumentToken token);
+    OrderDispatcher::Route routeFor(InstrumentToken token) { return {queueFor(token)}; }
+    OrderBook* bookFor(InstrumentToken token);
+
+    template <typename Fn>
+    void forEachBook(Fn&& fn) {
+        for (auto& instrument : instruments_) {
+            fn(instrument.token, *instrument.book);
+        }
+    }
+
+    // Before run(): every instrument's load record, in the order they were added.
+    template <typename Fn>
+    void forEachLoad(Fn&& fn) {
+        for (auto& instrument : instruments_) {
+            fn(*instrument.load);
+        }
+    }
+
+    // Thread-safe: asks this shard to move `token` to `target` between sweeps.
+    void requestRelease(InstrumentToken token, EngineShard& target);
+
+    void run();
+    void stop();
+
+    std::size_t id() const { return id_; }
+    int core() const { return core_; }
+    std::size_t instrumentCount() const { return instruments_.size(); }
+    uint64_t processed() const { return processed_.load(std::memory_order_relaxed); }
+    uint64_t migratedIn() const { return migrated_in_.load(std::memory_order_relaxed); }
+    uint64_t migratedOut() const { return migrated_out_.load(std::memory_order_relaxed); }
+    uint64_t onboarded() const { return onboarded_.load(std::memory_order_relaxed); }
+    uint64_t migrationAborts() const { return migration_aborts_.load(std::memory_order_relaxed); }
+    uint64_t maxMigrationPauseNs() const { return max_migration_pause_ns_.load(std::memory_order_relaxed); }
+    const WaitStrategy& waitStrategy() const { return wait_; }
+    // Extra trade consumers must be added before run().
+    TradePublisher& tradePublisher() { return trade_publisher_; }
+    const TradePublisher& tradePublisher() const { return trade_publisher_; }
+    // Null unless enableExecReports() was called.
+    const ExecReportPublisher* execReports() const { return exec_reports_.get(); }
+
+private:
+    struct Instrument {
+        InstrumentToken token = 0;
+        std::unique_ptr<Queue> queue;
+        std::unique_ptr<OrderBook> book;
+        std::unique_ptr<InstrumentLoad> load;
+        SnapshotPublisher::Region* snapshot = nullptr;
+    };
+
+    struct Command {
+        enum class Kind : uint8_t { RELEASE, ADOPT, ONBOARD };
+        Kind kind = Kind::RELEASE;
+        InstrumentToken token = 0;
+        EngineShard* target = nullptr;
+        Instrument instrument;
+    };
+
+    static constexpr std::size_t kMaxBurst = 32;
+
+    Instrument makeInstrument(InstrumentToken token, std::unique_ptr<OrderBook> book, bool multi_producer);
+    std::size_t drain(Instrument& instrument);
+    bool hasInput() const;
+    void post(Command command);
+    void applyControl(bool stopping);
+    void release(InstrumentToken token, EngineShard& target);
+    void adopt(Instrument instrument, bool onboarded);
+
+    std::size_t id_;
+    int core_;
+    std::size_t queue_capacity_;
+    SnapshotPublisher* publisher_ = nullptr;
+    std::vector<Instrument> instruments_;
+    // Declared after the books so it drains and stops before they go away.
+    TradePublisher trade_publisher_;
+    std::unique_ptr<ExecReportPublisher> exec_reports_;
+    WaitStrategy wait_;
+    std::atomic<bool> running_{true};
+    std::atomic<uint64_t> processed_{0};
+
+    std::chrono::microseconds migration_pause_{1000};
+    std::mutex control_mutex_;
+    std::vector<Command> control_;
+    std::atomic<bool> control_pending_{false};
+    std::atomic<uint64_t> migrated_in_{0};
+    std::atomic<uint64_t> migrated_out_{0};
+    std::atomic<uint64_t> onboarded_{0};
+    std::atomic<uint64_t> migration_aborts_{0};
+    std::atomic<uint64_t> max_migration_pause_ns_{0};
+};
+
+}  // namespace engine
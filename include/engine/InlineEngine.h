@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "core/OrderBook.h"
+#include "core/TradeSink.h"
+#include "ingress/WireOrder.h"
+#include "utils/Config.h"
+
+namespace engine {
+
+/**
+ * @brief The matching pipeline on the calling thread, for backtests, replay
+ *        and benchmarks.
+ *
+ * handle() takes an order as a dispatcher would decode it, stamps it with the
+ * next sequence and applies it to its instrument's book, which is created
+ * (with the config's backend and price bands) the first time the instrument
+ * is seen. Books are INLINE, so each trade has reached every sink before
+ * handle() returns. There is no queue, dispatcher, shard, publisher or
+ * logger thread in between. Order timestamps are the caller's event time,
+ * not the clock. The same input therefore always gives the same trades,
+ * sequences and price band decisions, at the speed of one core.
+ */
+class InlineEngine {
+public:
+    explicit InlineEngine(const AppConfig& config = {});
+
+    InlineEngine(const InlineEngine&) = delete;
+    InlineEngine& operator=(const InlineEngine&) = delete;
+
+    // Before the first order: every book, present and future, gets the sink.
+    void addTradeSink(TradeSink sink);
+
+    // False for a payload that does not parse; nothing is applied then.
+    bool handle(std::string_view payload, HrtTime timestamp);
+    void handle(const ingress::WireOrder& order, HrtTime timestamp);
+
+    // Null for an instrument no order has reached yet.
+    OrderBook* book(InstrumentToken token);
+    std::size_t books() const { return books_.size(); }
+    uint64_t lastSequence() const { return sequence_; }
+
+private:
+    OrderBook& bookFor(InstrumentToken token);
+
+    AppConfig config_;
+    std::vector<TradeSink> sinks_;
+    std::unordered_map<InstrumentToken, std::unique_ptr<OrderBook>> books_;
+    uint64_t sequence_ = 0;
+};
+
+}  // namespace engine
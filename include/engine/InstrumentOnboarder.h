@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "engine/EngineShard.h"
+#include "engine/ShardAssignment.h"
+#include "ingress/OnboardingChannel.h"
+#include "ingress/OrderDispatcher.h"
+#include "snapshot/SnapshotPublisher.h"
+#include "utils/Config.h"
+
+namespace engine {
+
+class ShardBalancer;
+
+/**
+ * @brief Engine side of the OnboardingChannel: creates the books of
+ *        instruments first seen on the ingress path.
+ *
+ * Runs on its own thread, off every hot path. A new token goes to the shard
+ * the startup assignment policy picks; its book and queue are built on that
+ * shard's core, it gets a snapshot region, every other shard's trade
+ * publisher tracks it so it can migrate later, and the shard adopts it
+ * between sweeps. The hook wires the book into the rest of the pipeline
+ * before it goes live and returns the route dispatchers should use (the
+ * engine queue by default). Every request for a token gets the same answer;
+ * tokens beyond the instrument limit are refused.
+ */
+class InstrumentOnboarder {
+public:
+    using Route = OrderDispatcher::Route;
+    using Hook = std::function<Route(InstrumentToken token, OrderBook& book, Route engine_route)>;
+
+    InstrumentOnboarder(std::vector<EngineShard*> shards, ingress::OnboardingChannel& channel, const AppConfig& config,
+                        ShardAssignmentPolicy& assignment, SnapshotPublisher* snapshots, bool multi_producer);
+
+    InstrumentOnboarder(const InstrumentOnboarder&) = delete;
+    InstrumentOnboarder& operator=(const InstrumentOnboarder&) = delete;
+
+    // Before run().
+    void setHook(Hook hook) { hook_ = std::move(hook); }
+    void setBalancer(ShardBalancer* balancer) { balancer_ = balancer; }
+
+    // Serves requests until stop() closes the channel.
+    void run();
+    void stop();
+
+    // One request; run() calls this for each one it takes.
+    void handle(const ingress::OnboardingChannel::Request& request);
+
+    uint64_t onboarded() const { return onboarded_.load(std::memory_order_relaxed); }
+    uint64_t refused() const { return refused_.load(std::memory_order_relaxed); }
+
+private:
+    Route create(InstrumentToken token);
+
+    std::vector<EngineShard*> shards_;
+    ingress::OnboardingChannel& channel_;
+    const AppConfig& config_;
+    ShardAssignmentPolicy& assignment_;
+    SnapshotPublisher* snapshots_;
+    bool multi_producer_;
+    Hook hook_;
+    ShardBalancer* balancer_ = nullptr;
+    std::unordered_map<InstrumentToken, Route> routes_;
+    std::atomic<uint64_t> onboarded_{0};
+    std::atomic<uint64_t> refused_{0};
+};
+
+}  // namespace engine
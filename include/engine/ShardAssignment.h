@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+
+#include "types/AppTypes.h"
+#include "utils/Config.h"
+#include "utils/InstrumentUniverse.h"
+
+namespace engine {
+
+/**
+ * @brief Decides which engine shard owns an instrument. Called once per
+ *        instrument at startup, in universe order.
+ */
+class ShardAssignmentPolicy {
+public:
+    virtual ~ShardAssignmentPolicy() = default;
+    virtual std::size_t assign(const InstrumentSpec& instrument, std::size_t shard_count) = 0;
+    virtual const char* name() const = 0;
+};
+
+// Deals instruments out in universe order.
+class RoundRobinAssignment final : public ShardAssignmentPolicy {
+public:
+    std::size_t assign(const InstrumentSpec& instrument, std::size_t shard_count) override;
+    const char* name() const override { return "round_robin"; }
+
+private:
+    std::size_t next_ = 0;
+};
+
+// Stable for a token regardless of universe order or size.
+class HashAssignment final : public ShardAssignmentPolicy {
+public:
+    std::size_t assign(const InstrumentSpec& instrument, std::size_t shard_count) override;
+    const char* name() const override { return "hash"; }
+};
+
+// Explicit token -> shard pins, deferring to another policy for the rest.
+class PinnedAssignment final : public ShardAssignmentPolicy {
+public:
+    PinnedAssignment(std::unordered_map<InstrumentToken, std::size_t> pins,
+                     std::unique_ptr<ShardAssignmentPolicy> fallback);
+
+    std::size_t assign(const InstrumentSpec& instrument, std::size_t shard_count) override;
+    const char* name() const override { return fallback_->name(); }
+
+private:
+    std::unordered_map<InstrumentToken, std::size_t> pins_;
+    std::unique_ptr<ShardAssignmentPolicy> fallback_;
+};
+
+// Throws std::runtime_error for an unknown EngineSettings::assignment.
+std::unique_ptr<ShardAssignmentPolicy> makeAssignmentPolicy(const EngineSettings& settings);
+
+}  // namespace engine
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "engine/EngineShard.h"
+#include "utils/Config.h"
+
+namespace engine {
+
+/**
+ * @brief Moves books from the busiest engine shard to the idlest one.
+ *
+ * Every interval it samples each instrument's processed count and queue
+ * depth; an instrument's load is the messages it handled in the interval
+ * plus its backlog. When the busiest shard carries at least min_load and
+ * more than ratio times the idlest one, the instrument that best evens the
+ * pair out is moved with EngineShard::requestRelease(). One migration is in
+ * flight at a time, and pinned instruments never move.
+ *
+ * The constructor registers every book with every shard's trade publisher,
+ * so it must run before the shards do. Instruments onboarded later join
+ * through watch().
+ */
+class ShardBalancer {
+public:
+    ShardBalancer(const std::vector<EngineShard*>& shards, const EngineSettings& settings);
+
+    ShardBalancer(const ShardBalancer&) = delete;
+    ShardBalancer& operator=(const ShardBalancer&) = delete;
+
+    // Thread-safe: samples an instrument onboarded after construction. Its
+    // book must already be tracked by every other shard's trade publisher.
+    void watch(InstrumentLoad& load);
+
+    // One sampling step; returns true when it requested a migration.
+    bool rebalance();
+
+    void run();
+    void stop();
+
+    uint64_t requested() const { return requested_.load(std::memory_order_relaxed); }
+
+private:
+    struct Sample {
+        InstrumentLoad* load = nullptr;
+        uint64_t last_processed = 0;
+    };
+
+    // Intervals after which an unconfirmed migration is given up on.
+    static constexpr uint32_t kPendingIntervals = 10;
+
+    std::vector<EngineShard*> shards_;
+    std::vector<Sample> samples_;
+    std::unordered_set<InstrumentToken> pinned_;
+    std::chrono::milliseconds interval_;
+    double ratio_;
+    uint64_t min_load_;
+
+    InstrumentLoad* pending_ = nullptr;
+    std::size_t pending_target_ = 0;
+    uint32_t pending_age_ = 0;
+
+    std::atomic<uint64_t> requested_{0};
+    // Guards running_ and watched_.
+    std::mutex mutex_;
+    std::vector<InstrumentLoad*> watched_;
+    std::condition_variable wake_;
+    bool running_ = true;
+};
+
+}  // namespace engine
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "engine/EngineShard.h"
+#include "types/BookBackend.h"
+#include "utils/Config.h"
+
+namespace engine {
+
+struct WarmupResult {
+    std::size_t books = 0;
+    uint64_t synthetic_orders = 0;
+    uint64_t synthetic_trades = 0;
+};
+
+/**
+ * @brief Startup warm-up of the matching path, run before live traffic.
+ *
+ * warmUpShard() pre-sizes every book of a shard that is not running yet
+ * (order table, order index, ring level pools) and then drives synthetic
+ * orders through a scratch book of each backend the shard uses. Call it on
+ * the shard's core: the pages are first-touched there, and the caches and
+ * branch predictors it warms are that core's.
+ */
+WarmupResult warmUpShard(EngineShard& shard, const WarmupSettings& settings);
+
+// Resting limits on both sides, crossing limits, IOCs, cancels and modifies
+// against an inline scratch book whose only sink counts the trades, so
+// nothing leaves it. Returns the trades.
+uint64_t runSyntheticFlow(BookBackend backend, std::size_t orders);
+
+}  // namespace engine
@@ -7,8 +7,10 @@
 #include <cstddef>
 #include <functional>
 #include <memory>
-#include <vector>
 #include <string>
+#include <vector>
+
+#include "utils/HugePages.h"
 
 namespace SocketUtils {
     /// size of send and receive buffers in bytes.
@@ -17,6 +19,9 @@ namespace SocketUtils {
     /// RAII + PImpl-based Multicast Socket wrapper.
     class McastSocket {
     public:
+        // Send and receive buffers live in the socket_buffers memory region.
+        using Buffer = std::vector<char, HugePageAllocator<char, memory::Region::SOCKETS>>;
+
         explicit McastSocket();
         ~McastSocket();
 
@@ -27,8 +32,10 @@ namespace SocketUtils {
         McastSocket& operator=(McastSocket&&) noexcept;
 
         /// Initialize multicast socket to read from or publish to a stream.
-        /// Does not join the multicast stream yet.
-        auto init(const std::string& ip, const std::string& iface, int port, bool is_listening) -> int;
+        /// Does not join the multicast stream yet. reuse_port lets several
+        /// listening sockets bind the same port (SO_REUSEPORT).
+        auto init(const std::string& ip, const std::string& iface, int port, bool is_listening,
+                  bool reuse_port = false) -> int;
 
         /// Add / Join membership / subscription to a multicast stream.
         auto join(const std::string& ip) -> bool;
@@ -49,8 +56,8 @@ namespace SocketUtils {
 
         /// Accessors (non-breaking)
         [[nodiscard]] int fd() const noexcept;
-        [[nodiscard]] std::vector<char>& outboundBuffer() noexcept;
-        [[nodiscard]] std::vector<char>& inboundBuffer() noexcept;
+        [[nodiscard]] Buffer& outboundBuffer() noexcept;
+        [[nodiscard]] Buffer& inboundBuffer() noexcept;
         [[nodiscard]] size_t recvSize() const noexcept;
 
     private:
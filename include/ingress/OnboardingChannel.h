@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "ingress/OrderQueue.h"
+#include "types/AppTypes.h"
+
+namespace ingress {
+
+/**
+ * @brief Control path between dispatchers that meet an unknown instrument
+ *        and the engine thread that creates its book.
+ *
+ * Dispatchers post requests; the engine side answers each one with the
+ * queue to route to (null when the instrument is refused). Every dispatcher
+ * has its own reply mailbox with an eventfd, so it can wait for answers in
+ * the same epoll set as its socket instead of polling. Nothing here is on
+ * the path of instruments that already have a route.
+ */
+class OnboardingChannel {
+public:
+    struct Request {
+        InstrumentToken token = 0;
+        std::size_t dispatcher = 0;
+    };
+
+    struct Reply {
+        InstrumentToken token = 0;
+        OrderQueue* queue = nullptr;
+    };
+
+    explicit OnboardingChannel(std::size_t dispatchers);
+    ~OnboardingChannel();
+
+    OnboardingChannel(const OnboardingChannel&) = delete;
+    OnboardingChannel& operator=(const OnboardingChannel&) = delete;
+
+    // Dispatcher side.
+    void request(std::size_t dispatcher, InstrumentToken token);
+    // Readable while replies are waiting for this dispatcher.
+    int replyFd(std::size_t dispatcher) const;
+    std::vector<Reply> takeReplies(std::size_t dispatcher);
+
+    // Engine side: waits up to timeout for requests; false once closed.
+    bool waitRequests(std::vector<Request>& out, std::chrono::milliseconds timeout);
+    void reply(std::size_t dispatcher, const Reply& reply);
+    void close();
+
+    std::size_t dispatchers() const { return mailboxes_.size(); }
+
+private:
+    struct Mailbox {
+        std::mutex mutex;
+        std::vector<Reply> replies;
+        int event_fd = -1;
+    };
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<Request> requests_;
+    bool closed_ = false;
+    std::vector<std::unique_ptr<Mailbox>> mailboxes_;
+};
+
+}  // namespace ingress
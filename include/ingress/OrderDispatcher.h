@@ -1,30 +1,239 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <span>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
-#include "boost/lockfree/spsc_queue.hpp"
 #include "ingress/McastSocket.h"
+#include "ingress/OnboardingChannel.h"
+#include "ingress/OrderQueue.h"
+#include "ingress/Sequencer.h"
+#include "ingress/Throttle.h"
 #include "ingress/WireOrder.h"
+#include "types/ExecType.h"
+#include "types/IngressOverflow.h"
+#include "utils/WaitStrategy.h"
 
+/**
+ * @brief Reads one multicast socket and routes each order into its
+ *        instrument's queue.
+ *
+ * Several dispatchers may run side by side, each on its own socket and
+ * thread; per-instrument order is kept as long as every instrument has a
+ * single producing dispatcher (see partitionRoutes) or its queue is MPSC and
+ * the sender keeps it on one group.
+ *
+ * An instrument with no route at all is either onboarded or refused. With
+ * an OnboardingChannel, the dispatcher that owns the token asks the engine
+ * for a book and holds the instrument's orders (a bounded number, for a
+ * bounded time) until the answer arrives on its epoll set, then replays
+ * them in arrival order. Other dispatchers give the token an empty route.
+ * Without a channel, or once refused, the orders are dropped and counted;
+ * only the first drop of an instrument is logged.
+ *
+ * With a Sequencer, every order is stamped with the next global sequence as
+ * it is decoded, before it reaches any queue; held orders are stamped on
+ * arrival, not on replay.
+ *
+ * A full instrument queue is handled per instrument (Backpressure). BLOCK
+ * waits for the book, and with it every other instrument of the dispatcher.
+ * SPILL parks that instrument's orders in a bounded backlog, which later
+ * orders queue behind and which is replayed between socket reads; DROP (and
+ * a full backlog) discards the order, counts it and hands it to on_reject.
+ * Each instrument's deepest queue, spills and drops are kept in queueStats().
+ *
+ * With a Throttle, every order is checked against its participant's and
+ * instrument's rate before it is stamped. An order over the rate is rejected
+ * or, with ThrottleAction::DELAY, held until its bucket has a token again and
+ * stamped then, so a delayed order counts as arriving when it is released.
+ * Dropped and rejected orders go to the reject sink with their reason.
+ */
 class OrderDispatcher {
 public:
-    using Queue = boost::lockfree::spsc_queue<ingress::WireOrder>;
-    using QueueMap = std::unordered_map<InstrumentToken, Queue*>;
+    using Queue = ingress::OrderQueue;
 
-    OrderDispatcher(SocketUtils::McastSocket& socket, QueueMap queues);
+    // The queue's consumer is notified after every push so a parked reader
+    // wakes up. A route without a queue marks an instrument another
+    // dispatcher owns.
+    struct Route {
+        Queue* queue = nullptr;
+    };
+    using RouteMap = std::unordered_map<InstrumentToken, Route>;
+
+    // owners > 1 (reuseport) splits new tokens: this dispatcher claims those
+    // with token % owners == index % owners.
+    struct Onboarding {
+        ingress::OnboardingChannel* channel = nullptr;
+        std::size_t index = 0;
+        std::size_t owners = 1;
+        std::size_t buffer = 1024;
+        std::chrono::milliseconds timeout{100};
+    };
+
+    struct Backpressure {
+        IngressOverflow overflow = IngressOverflow::BLOCK;
+        std::size_t spill_capacity = 4096;
+        std::unordered_map<InstrumentToken, IngressOverflow> overrides;
+    };
+
+    // Runs on the dispatcher thread for every order it drops or rejects.
+    using RejectSink = std::function<void(const ingress::WireOrder&, ExecReason)>;
+
+    // high_water is the deepest the queue was seen right after a push.
+    struct QueueStats {
+        InstrumentToken token = 0;
+        std::size_t capacity = 0;
+        IngressOverflow overflow = IngressOverflow::BLOCK;
+        uint64_t high_water = 0;
+        uint64_t spilled = 0;
+        uint64_t dropped = 0;
+    };
+
+    OrderDispatcher(SocketUtils::McastSocket& socket, RouteMap routes, const WaitSettings& wait = {});
+
+    // Before run().
+    void setOnboarding(const Onboarding& onboarding) { onboarding_ = onboarding; }
+    void setSequencer(ingress::Sequencer* sequencer) { sequencer_ = sequencer; }
+    void setBackpressure(Backpressure backpressure);
+    // Shared by every dispatcher; must outlive them.
+    void setThrottle(ingress::Throttle* throttle);
+    void setRejectSink(RejectSink sink) { reject_sink_ = std::move(sink); }
 
     void run();
     void stop();
 
-private:
+    const WaitStrategy& waitStrategy() const { return wait_; }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t onboarded() const { return onboarded_.load(std::memory_order_relaxed); }
+    // Thread-safe: every instrument this dispatcher routes to a queue.
+    std::vector<QueueStats> queueStats() const;
+
+    // Decodes and routes one datagram; run() calls this for each one it reads.
     void handlePayload(std::string_view payload);
+    // Routes delayed orders that are due, moves what it can of every backlog
+    // into its queue and publishes claimed slots.
+    void flush();
+
+private:
+    // Written by the dispatcher, read by queueStats().
+    struct Counters {
+        InstrumentToken token = 0;
+        std::size_t capacity = 0;
+        IngressOverflow overflow = IngressOverflow::BLOCK;
+        std::atomic<uint64_t> high_water{0};
+        std::atomic<uint64_t> spilled{0};
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    struct RouteState;
+
+    // Datagrams are decoded straight into claimed queue slots; a queue is
+    // published (one index store, one notify) when its claim runs out or
+    // when the socket has been drained. The claim belongs to the queue, not
+    // the instrument: several instruments may share one queue (the risk
+    // stage's inbound). Multi-producer queues have no claim API and take a
+    // decoded copy instead.
+    struct Claim {
+        Queue* queue = nullptr;
+        std::span<ingress::WireOrder> slots;
+        std::size_t used = 0;
+        // Instruments that wrote since the last publish, for their high-water marks.
+        std::vector<RouteState*> writers;
+    };
+
+    struct RouteState {
+        Route route;
+        Claim* claim = nullptr;
+        bool writing = false;
+        bool refused = false;
+        IngressOverflow overflow = IngressOverflow::BLOCK;
+        // Set from the first overflow until the queue takes orders again; logs once per episode.
+        bool overflowing = false;
+        std::size_t high_water = 0;
+        Counters* counters = nullptr;
+        std::deque<ingress::WireOrder> spill;
+        ingress::Throttle::Bucket* limit = nullptr;
+    };
+
+    // An order held by the throttle; equal release times keep arrival order.
+    struct Delayed {
+        int64_t release_ns = 0;
+        uint64_t arrival = 0;
+        RouteState* state = nullptr;
+        ingress::WireOrder order;
+
+        bool operator>(const Delayed& other) const {
+            return release_ns != other.release_ns ? release_ns > other.release_ns : arrival > other.arrival;
+        }
+    };
+
+    // Orders of an instrument waiting for its book.
+    struct Pending {
+        std::vector<ingress::WireOrder> orders;
+        std::chrono::steady_clock::time_point deadline;
+        bool expired = false;
+    };
+
+    static constexpr std::size_t kClaimBatch = 32;
+    static constexpr std::size_t kMaxDatagramsPerWake = 64;
+
+    void handleUnknown(InstrumentToken instrument, std::string_view payload);
+    // False when the order must not be routed now: malformed, rejected or delayed.
+    bool decode(std::string_view payload, RouteState& state, ingress::WireOrder& order);
+    bool admit(RouteState& state, const ingress::WireOrder& order);
+    void releaseDelayed();
+    void reject(const ingress::WireOrder& order, ExecReason reason);
+    void stamp(ingress::WireOrder& order);
+    void attach(InstrumentToken token, RouteState& state);
+    void enqueue(RouteState& state, const ingress::WireOrder& order);
+    bool tryPush(RouteState& state, const ingress::WireOrder& order);
+    void overflow(RouteState& state, const ingress::WireOrder& order);
+    void drainSpills();
+    void applyReplies();
+    void expirePending();
+    void refuse(InstrumentToken instrument, std::size_t orders);
+    // Null when the queue is full and the instrument does not block.
+    ingress::WireOrder* nextSlot(RouteState& state);
+    void wrote(RouteState& state);
+    void publish(Claim& claim);
+    void noteDepth(RouteState& state);
 
     SocketUtils::McastSocket& socket_;
-    QueueMap queues_;
+    std::unordered_map<InstrumentToken, RouteState> routes_;
+    std::unordered_map<Queue*, Claim> claims_;
+    std::vector<Claim*> dirty_;
+    WaitStrategy wait_;
     std::atomic<bool> running_{true};
     std::unordered_set<InstrumentToken> seen_instruments_;
+    Onboarding onboarding_;
+    ingress::Sequencer* sequencer_ = nullptr;
+    Backpressure backpressure_;
+    RejectSink reject_sink_;
+    ingress::Throttle* throttle_ = nullptr;
+    std::priority_queue<Delayed, std::vector<Delayed>, std::greater<>> delayed_;
+    uint64_t delay_arrivals_ = 0;
+    std::vector<RouteState*> spilling_;
+    mutable std::mutex counters_mutex_;
+    std::vector<std::unique_ptr<Counters>> counters_;
+    std::unordered_map<InstrumentToken, Pending> pending_;
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> onboarded_{0};
 };
+
+// Splits routes across `parts` dispatchers, dealing `tokens` round-robin so
+// each instrument has exactly one owner; the other parts get an empty route
+// for it. Tokens without a route are skipped.
+std::vector<OrderDispatcher::RouteMap> partitionRoutes(const OrderDispatcher::RouteMap& routes,
+                                                       const std::vector<InstrumentToken>& tokens,
+                                                       std::size_t parts);
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "datastructures/MpscQueue.h"
+#include "datastructures/SpscQueue.h"
+#include "ingress/WireOrder.h"
+#include "utils/CompilerHints.h"
+#include "utils/WaitStrategy.h"
+
+namespace ingress {
+
+/**
+ * @brief Per-instrument order queue between producers and an engine shard.
+ *
+ * Single-producer queues (the default) stay on the SpscQueue path, including
+ * its claim/commit API; instruments fed by several producers (more than one
+ * dispatcher, a gateway, an internal agent) use MpscQueue instead. Either
+ * way there is exactly one consumer, and order is FIFO per producer.
+ *
+ * The queue also names the WaitStrategy of whoever consumes it, so every
+ * producer wakes the right thread and re-pointing it (when a book changes
+ * shard) is seen by all producers at once.
+ */
+class OrderQueue {
+public:
+    using Single = SpscQueue<WireOrder>;
+    using Multi = MpscQueue<WireOrder>;
+
+    explicit OrderQueue(std::size_t capacity, bool multi_producer = false) {
+        if (multi_producer) {
+            multi_ = std::make_unique<Multi>(capacity);
+        } else {
+            single_ = std::make_unique<Single>(capacity);
+        }
+    }
+
+    bool push(const WireOrder& order) {
+        return LIKELY(single_ != nullptr) ? single_->push(order) : multi_->push(order);
+    }
+
+    bool pop(WireOrder& out) {
+        return LIKELY(single_ != nullptr) ? single_->pop(out) : multi_->pop(out);
+    }
+
+    template <typename Fn>
+    std::size_t consume(std::size_t max, Fn&& fn) {
+        return LIKELY(single_ != nullptr) ? single_->consume(max, fn) : multi_->consume(max, fn);
+    }
+
+    std::size_t read_available() const {
+        return LIKELY(single_ != nullptr) ? single_->read_available() : multi_->read_available();
+    }
+
+    std::size_t write_available() const {
+        return LIKELY(single_ != nullptr) ? single_->write_available() : multi_->write_available();
+    }
+
+    std::size_t capacity() const {
+        return LIKELY(single_ != nullptr) ? single_->capacity() : multi_->capacity();
+    }
+
+    bool multiProducer() const { return multi_ != nullptr; }
+
+    // The in-place claim/commit path, or null for a multi-producer queue.
+    Single* single() { return single_.get(); }
+
+    void setConsumer(WaitStrategy* consumer) { consumer_.store(consumer, std::memory_order_seq_cst); }
+    WaitStrategy* consumer() const { return consumer_.load(std::memory_order_acquire); }
+
+    // Producers call this after a push or commit.
+    void notifyConsumer() {
+        if (WaitStrategy* consumer = consumer_.load(std::memory_order_seq_cst)) {
+            consumer->notify();
+        }
+    }
+
+private:
+    std::atomic<WaitStrategy*> consumer_{nullptr};
+    std::unique_ptr<Single> single_;
+    std::unique_ptr<Multi> multi_;
+};
+
+}  // namespace ingress
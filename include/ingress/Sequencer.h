@@ -0,0 +1,34 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace ingress {
+
+/**
+ * @brief Global monotonic sequence shared by every dispatcher.
+ *
+ * Each inbound order takes the next number before it is routed to its
+ * instrument's queue, so orders of different instruments (and different
+ * dispatchers) have one total order that replays and output consumers can
+ * rely on. Stamping is a single relaxed fetch_add on a line of its own;
+ * there is no lock and no extra thread or hop. Numbers start at 1, so 0
+ * marks an unsequenced event (e.g. a book driven through its API).
+ */
+class Sequencer {
+public:
+    explicit Sequencer(uint64_t last = 0) : next_(last + 1) {}
+
+    Sequencer(const Sequencer&) = delete;
+    Sequencer& operator=(const Sequencer&) = delete;
+
+    uint64_t next() { return next_.fetch_add(1, std::memory_order_relaxed); }
+
+    // Last number handed out (0 before the first).
+    uint64_t last() const { return next_.load(std::memory_order_relaxed) - 1; }
+
+private:
+    alignas(64) std::atomic<uint64_t> next_;
+};
+
+}  // namespace ingress
@@ -33,6 +33,7 @@ namespace SocketUtils {
     bool is_udp_ = false;
     bool is_listening_ = false;
     bool needs_so_timestamp_ =  false;
+    bool reuse_port_ = false;
 
     [[nodiscard]] std::string toString() const {
       std::ostringstream ss;
@@ -42,6 +43,7 @@ namespace SocketUtils {
          << " is_udp:" << std::boolalpha << is_udp_
          << " is_listening:" << is_listening_
          << " needs_SO_timestamp:" << needs_so_timestamp_
+         << " reuse_port:" << reuse_port_
          << "]";
       const std::string desc = ss.str();
       LOG_INFO("{}", desc);
@@ -147,8 +149,17 @@ namespace SocketUtils {
         ASSERT(setsockopt(socket_fd, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&one), sizeof(one)) == 0, "setsockopt() SO_REUSEADDR failed. errno:" + std::string(strerror(errno)));
       }
 
+      if (socket_cfg.is_listening_ && socket_cfg.reuse_port_) { // several dispatcher sockets share the port.
+        ASSERT(setsockopt(socket_fd, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<const char *>(&one), sizeof(one)) == 0, "setsockopt() SO_REUSEPORT failed. errno:" + std::string(strerror(errno)));
+      }
+
+      if (socket_cfg.is_udp_ && socket_cfg.is_listening_) { // only deliver groups this socket joined, not every group joined on the host.
+        const int zero = 0;
+        ASSERT(setsockopt(socket_fd, IPPROTO_IP, IP_MULTICAST_ALL, &zero, sizeof(zero)) == 0, "setsockopt() IP_MULTICAST_ALL failed. errno:" + std::string(strerror(errno)));
+      }
+
       if (socket_cfg.is_listening_) {
-        const sockaddr_in addr{AF_INET, htons(socket_cfg.port_), {htonl(INADDR_ANY)}, {}};
+        const sockaddr_in addr{AF_INET, htons(static_cast<uint16_t>(socket_cfg.port_)), {htonl(INADDR_ANY)}, {}};
         ASSERT(bind(socket_fd, socket_cfg.is_udp_ ? reinterpret_cast<const struct sockaddr *>(&addr) : rp->ai_addr, sizeof(addr)) == 0, "bind() failed. errno:%" + std::string(strerror(errno)));
       }
 
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "ingress/WireOrder.h"
+#include "utils/Config.h"
+
+namespace ingress {
+
+/**
+ * @brief Per-participant and per-instrument order rate limits, shared by
+ *        every dispatcher.
+ *
+ * Each limit is a token bucket of `rate` orders per second holding up to
+ * `burst` orders, kept in its GCRA form: one atomic theoretical arrival time
+ * per bucket, so a check is a comparison against the clock and one CAS, with
+ * no refill timer and no lock. Participant buckets are a flat array indexed
+ * by participant id; ids at or above max_participants share the last one.
+ * Instrument buckets are resolved once per route (bucketFor) and used through
+ * the pointer afterwards.
+ */
+class Throttle {
+public:
+    static constexpr int64_t kRejected = -1;
+
+    class Bucket {
+    public:
+        Bucket() = default;
+        Bucket(uint64_t rate, uint32_t burst) { configure(rate, burst); }
+
+        void configure(uint64_t rate, uint32_t burst);
+        bool limited() const { return interval_ns_ > 0; }
+        // Takes a token and returns when it is due (now_ns when one is left),
+        // or kRejected, taking nothing, when that is more than max_wait_ns away.
+        int64_t acquire(int64_t now_ns, int64_t max_wait_ns);
+        void refund() { tat_ns_.fetch_sub(interval_ns_, std::memory_order_relaxed); }
+
+    private:
+        std::atomic<int64_t> tat_ns_{0};
+        int64_t interval_ns_ = 0;
+        int64_t tolerance_ns_ = 0;
+    };
+
+    struct ParticipantStats {
+        ParticipantId participant = 0;
+        uint64_t rejected = 0;
+        uint64_t delayed = 0;
+    };
+
+    explicit Throttle(const ThrottleSettings& settings);
+
+    Throttle(const Throttle&) = delete;
+    Throttle& operator=(const Throttle&) = delete;
+
+    const ThrottleSettings& settings() const { return settings_; }
+
+    // Cold path: the instrument's bucket, created on first use; null when
+    // instruments are not limited.
+    Bucket* bucketFor(InstrumentToken token);
+
+    // When the order conforms to its participant's bucket and `instrument`
+    // (null: unlimited), charging both; kRejected, charging neither, when
+    // that is more than max_wait_ns after now_ns.
+    int64_t admit(const WireOrder& order, Bucket* instrument, int64_t now_ns, int64_t max_wait_ns);
+
+    // Participants that were rejected or delayed at least once, by id.
+    std::vector<ParticipantStats> throttled() const;
+
+private:
+    struct alignas(64) Participant {
+        Bucket bucket;
+        std::atomic<uint64_t> rejected{0};
+        std::atomic<uint64_t> delayed{0};
+    };
+
+    const ThrottleSettings settings_;
+    std::vector<Participant> participants_;
+    std::mutex instruments_mutex_;
+    std::deque<Bucket> instrument_buckets_;
+    std::unordered_map<InstrumentToken, Bucket*> instruments_;
+};
+
+}  // namespace ingress
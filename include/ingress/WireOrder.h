@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <charconv>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -21,6 +22,9 @@ struct WireOrder {
     Qty quantity = 0;
     OrderType type = OrderType::LIMIT;
     Qty display = 0;
+    ParticipantId participant = 0;
+    // Stamped by the dispatcher when a Sequencer is set; never on the wire.
+    uint64_t sequence = 0;
 };
 
 inline std::string_view toString(Side side) {
@@ -58,27 +62,33 @@ inline std::optional<OrderType> orderTypeFromString(std::string_view value) {
 }
 
 inline std::string serializeWireOrder(const WireOrder& order) {
-    return fmt::format("{},{},{},{},{},{},{}",
+    return fmt::format("{},{},{},{},{},{},{},{}",
                        order.order_id,
                        order.instrument,
                        toString(order.side),
                        order.price,
                        order.quantity,
                        toString(order.type),
-                       order.display);
+                       order.display,
+                       order.participant);
 }
 
+// The participant column is optional so older senders (7 columns) keep working.
 inline bool parseWireOrder(std::string_view line, WireOrder& out) {
-    std::array<std::string_view, 7> parts{};
+    std::array<std::string_view, 8> parts{};
+    size_t fields = 0;
     size_t start = 0;
-    for (size_t i = 0; i < parts.size(); ++i) {
-        size_t end = (i + 1 == parts.size()) ? line.size() : line.find(',', start);
-        if (end == std::string_view::npos) {
-            return false;
+    while (fields < parts.size() && start <= line.size()) {
+        size_t end = line.find(',', start);
+        if (end == std::string_view::npos || fields + 1 == parts.size()) {
+            end = line.size();
         }
-        parts[i] = line.substr(start, end - start);
+        parts[fields++] = line.substr(start, end - start);
         start = end + 1;
     }
+    if (fields < parts.size() - 1) {
+        return false;
+    }
 
     try {
         out.order_id = static_cast<OrderId>(std::stoull(std::string(parts[0])));
@@ -92,6 +102,9 @@ inline bool parseWireOrder(std::string_view line, WireOrder& out) {
         if (!maybeType) return false;
         out.type = *maybeType;
         out.display = static_cast<Qty>(std::stoul(std::string(parts[6])));
+        out.participant = (fields == parts.size())
+            ? static_cast<ParticipantId>(std::stoul(std::string(parts[7])))
+            : 0;
     } catch (const std::exception&) {
         return false;
     }
@@ -99,4 +112,21 @@ inline bool parseWireOrder(std::string_view line, WireOrder& out) {
     return true;
 }
 
+// Reads only the instrument column, so the dispatcher can pick a route before
+// decoding the order straight into that route's queue slot.
+inline bool peekWireInstrument(std::string_view line, InstrumentToken& out) {
+    const size_t first = line.find(',');
+    if (first == std::string_view::npos) {
+        return false;
+    }
+    size_t end = line.find(',', first + 1);
+    if (end == std::string_view::npos) {
+        end = line.size();
+    }
+    const char* begin = line.data() + first + 1;
+    const char* last = line.data() + end;
+    const auto [ptr, ec] = std::from_chars(begin, last, out);
+    return ec == std::errc{} && ptr == last;
+}
+
 } // namespace ingress
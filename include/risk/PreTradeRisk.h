@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/TradeEvent.h"
+#include "ingress/WireOrder.h"
+#include "utils/Config.h"
+
+namespace risk {
+
+enum class RiskResult : uint8_t {
+    Accepted,
+    UnknownParticipant,
+    MaxOrderQty,
+    MaxNotional,
+    MaxOpenOrders,
+    MaxPosition,
+    OrderTableFull,
+};
+
+inline constexpr std::size_t kRiskResultCount = 7;
+
+const char* toString(RiskResult result);
+
+/**
+ * @brief Per-participant pre-trade limits backed by flat arrays.
+ *
+ * Single-threaded: owned by the risk stage. Accepted resting orders reserve
+ * open quantity, which is released again as fills are fed back from the
+ * engine via onTrade() and as cancels, rejects and modifies arrive via
+ * onLeavesChange().
+ * Live orders sit in a fixed open-addressing table sized by
+ * max_live_orders, so a wire id never sizes an allocation.
+ */
+class PreTradeRisk {
+public:
+    explicit PreTradeRisk(const RiskSettings& settings);
+
+    RiskResult check(const ingress::WireOrder& order);
+    void onTrade(const TradeEvent& event);
+    // The engine changed the order's open quantity outside a fill: negative for
+    // cancels, rejects, unfilled remainders and modifies down, positive for
+    // modifies up. Changes must arrive before the fills the engine made after them.
+    void onLeavesChange(OrderId orderId, int64_t delta);
+
+    int64_t position(ParticipantId participant) const;
+    uint32_t openOrders(ParticipantId participant) const;
+    uint64_t rejected(RiskResult reason) const;
+    uint64_t accepted() const;
+    std::size_t liveOrders() const { return live_orders_; }
+
+private:
+    struct alignas(32) ParticipantState {
+        int64_t position = 0;
+        uint64_t open_buy_qty = 0;
+        uint64_t open_sell_qty = 0;
+        uint32_t open_orders = 0;
+    };
+
+    struct OrderState {
+        OrderId order_id = 0;
+        ParticipantId participant = 0;
+        Qty remaining = 0;
+        Side side = Side::INVALID;
+        bool rests = false;
+        bool used = false;
+    };
+
+    RiskSettings settings_;
+    std::vector<ParticipantState> participants_;
+    // Linear probing, at most half full; an order leaves once nothing of it remains.
+    std::vector<OrderState> orders_;
+    std::size_t order_mask_ = 0;
+    unsigned order_shift_ = 0;
+    std::size_t live_orders_ = 0;
+    std::array<std::atomic<uint64_t>, kRiskResultCount> counters_{};
+
+    RiskResult evaluate(const ingress::WireOrder& order, const ParticipantState& state) const;
+    void applyFill(OrderId orderId, Qty qty);
+    // Drops `qty` from the order's remaining quantity and open reservation.
+    void release(OrderState& order, Qty qty);
+    std::size_t homeSlot(OrderId orderId) const;
+    OrderState* findOrder(OrderId orderId);
+    // Null when the table is full.
+    OrderState* insertOrder(OrderId orderId);
+    void eraseOrder(OrderState& order);
+};
+
+}  // namespace risk
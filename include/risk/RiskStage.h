@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "core/OrderBook.h"
+#include "core/TradeSink.h"
+#include "datastructures/SpscQueue.h"
+#include "ingress/OrderDispatcher.h"
+#include "risk/PreTradeRisk.h"
+#include "utils/WaitStrategy.h"
+
+namespace risk {
+
+/**
+ * @brief Pipeline stage between the dispatcher and the engine queues.
+ *
+ * The dispatcher routes every instrument into inbound(); the stage runs the
+ * pre-trade checks on its own thread and forwards accepted orders to the
+ * per-instrument engine queue. Fills, and the changes to open quantity from
+ * cancels, rejects and modifies, come back over SPSC queues per book so the
+ * matching thread never waits on risk state.
+ *
+ * Instruments onboarded while the stage runs arrive through addInstrument();
+ * the stage merges them at the top of its loop and again when an order
+ * misses its route, so an order never overtakes its instrument's route.
+ */
+class RiskStage {
+public:
+    using Queue = OrderDispatcher::Queue;
+    using RouteMap = OrderDispatcher::RouteMap;
+    using FeedbackQueue = SpscQueue<TradeEvent>;
+    // Runs on the risk thread for every order the checks refuse.
+    using RejectSink = OrderDispatcher::RejectSink;
+    struct LeavesChange {
+        OrderId order_id = 0;
+        int64_t delta = 0;
+    };
+    using LeavesQueue = SpscQueue<LeavesChange>;
+
+    // multi_producer_inbound lets several dispatchers feed inbound().
+    RiskStage(const RiskSettings& settings, RouteMap routes, std::size_t queue_capacity,
+              const WaitSettings& wait = {}, bool multi_producer_inbound = false);
+
+    RiskStage(const RiskStage&) = delete;
+    RiskStage& operator=(const RiskStage&) = delete;
+
+    Queue* inbound() { return &inbound_; }
+    OrderDispatcher::Route inboundRoute() { return {&inbound_}; }
+
+    // Must be called for every book before run(). Adds a trade sink and sets
+    // the leaves hook; both are owned by the stage, so the stage has to outlive
+    // the book and the trade publisher delivering to it.
+    void attachFeedback(OrderBook& book);
+
+    // Thread-safe: routes a new instrument while the stage runs and attaches
+    // its book's feedback, like attachFeedback().
+    void addInstrument(InstrumentToken token, OrderDispatcher::Route route, OrderBook& book);
+
+    // Set before run().
+    void setRejectSink(RejectSink sink) { reject_sink_ = std::move(sink); }
+
+    void run();
+    void stop();
+
+    const PreTradeRisk& limits() const { return risk_; }
+    const WaitStrategy& waitStrategy() const { return wait_; }
+
+private:
+    // Trades are pushed by the book's trade thread, leaves changes by its
+    // matching thread, so each has its own queue.
+    struct FeedbackSink {
+        FeedbackQueue& queue;
+        LeavesQueue& leaves;
+        WaitStrategy& consumer;
+        void onTrades(TradeBatch trades);
+        static void onLeaves(void* context, OrderId orderId, int64_t delta);
+    };
+
+    FeedbackSink& makeFeedbackSink(FeedbackQueue& queue, LeavesQueue& leaves);
+    void drainFeedback();
+    // Returns true when anything was merged.
+    bool mergeAdded();
+    bool hasInput() const;
+
+    PreTradeRisk risk_;
+    RouteMap routes_;
+    Queue inbound_;
+    WaitStrategy wait_;
+    std::size_t queue_capacity_;
+    std::vector<std::unique_ptr<FeedbackQueue>> feedback_;
+    // leaves_[i] belongs to the same book as feedback_[i].
+    std::vector<std::unique_ptr<LeavesQueue>> leaves_;
+    std::vector<std::unique_ptr<FeedbackSink>> feedback_sinks_;
+    RejectSink reject_sink_;
+
+    std::mutex added_mutex_;
+    std::vector<std::pair<InstrumentToken, OrderDispatcher::Route>> added_routes_;
+    std::vector<std::unique_ptr<FeedbackQueue>> added_feedback_;
+    std::vector<std::unique_ptr<LeavesQueue>> added_leaves_;
+    std::atomic<bool> added_pending_{false};
+    std::atomic<bool> running_{true};
+};
+
+}  // namespace risk
@@ -7,7 +7,7 @@
 namespace snapshot {
 
 constexpr uint32_t kSnapshotMagic = 0x5349424b;  // 'SIBK' signature
-constexpr uint32_t kSnapshotVersion = 1;
+constexpr uint32_t kSnapshotVersion = 2;
 
 struct Level {
     double price = 0.0;
@@ -22,6 +22,8 @@ struct alignas(64) SharedSnapshot {
     uint64_t timestamp_ns = 0;
     double ltp = 0.0;
     double ltq = 0.0;
+    // Highest global inbound sequence reflected in this snapshot (0 unsequenced).
+    uint64_t last_sequence = 0;
     Level data[1];
 };
 
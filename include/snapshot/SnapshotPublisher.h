@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -18,15 +19,29 @@ struct SnapshotConfig {
     std::size_t max_levels = 32;
 };
 
+/**
+ * @brief One shared-memory snapshot region per instrument.
+ *
+ * Regions are created up front or by addInstrument() while the engine runs,
+ * and never move; the matching thread keeps the Region* of each of its books
+ * and publishes through it without a lookup. Only the owning matching thread
+ * publishes a region.
+ */
 class SnapshotPublisher {
 public:
+    struct Region;
+
     explicit SnapshotPublisher(const SnapshotConfig& config,
                                const std::vector<InstrumentToken>& tokens);
     ~SnapshotPublisher();
 
-    void maybePublish(InstrumentToken token, const OrderBook& book);
+    // Thread-safe. Creates the instrument's region if needed; null when shm fails.
+    Region* addInstrument(InstrumentToken token);
+    // Thread-safe; null for an instrument without a region.
+    Region* regionFor(InstrumentToken token);
+
+    void maybePublish(Region* region, const OrderBook& book);
 
-private:
     struct Region {
         int fd = -1;
         std::size_t size = 0;
@@ -34,9 +49,12 @@ private:
         std::chrono::steady_clock::time_point next_publish{};
     };
 
+private:
     SnapshotConfig config_;
-    std::unordered_map<InstrumentToken, Region> regions_;
+    std::mutex mutex_;
+    std::unordered_map<InstrumentToken, std::unique_ptr<Region>> regions_;
 
     static std::string regionName(const std::string& prefix, InstrumentToken token);
+    std::unique_ptr<Region> openRegion(InstrumentToken token) const;
     void publishNow(Region& region, const OrderBook& book);
 };
@@ -11,6 +11,7 @@ typedef uint32_t Qty;
 typedef uint64_t Price;
 typedef uint64_t OrderId;
 typedef uint32_t InstrumentToken;
+typedef uint32_t ParticipantId;
 typedef std::chrono::system_clock::time_point HrtTime;
 
 #endif //ORDERMATCHINGSYSTEM_TYPES_H
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+// Price-level container used for each side of an OrderBook.
+enum class BookBackend : uint8_t {
+    RING,       // PriceRingBuffer window with RBTree overflow (default)
+    RB_TREE,    // pooled RBTree
+    STD_MAP,    // std::pmr::map
+    CHUNK_MAP,  // PriceChunkMap, for books spread over thousands of ticks
+};
+
+inline const char* toString(BookBackend backend) {
+    switch (backend) {
+        case BookBackend::RING: return "ring";
+        case BookBackend::RB_TREE: return "rbtree";
+        case BookBackend::STD_MAP: return "std_map";
+        case BookBackend::CHUNK_MAP: return "chunk_map";
+        default: return "unknown";
+    }
+}
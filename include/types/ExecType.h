@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+// Kind of an execution report.
+enum class ExecType : uint8_t {
+    ACK,           // accepted: resting, or about to match
+    PARTIAL_FILL,  // traded, quantity left
+    FILL,          // traded, nothing left
+    CANCEL,        // taken off the book or not rested (IOC/FOK/market remainder, halt)
+    REJECT,        // never accepted, or a cancel/modify that could not apply
+};
+
+// Why an order was cancelled or rejected; NONE for acks, fills and client cancels.
+enum class ExecReason : uint8_t {
+    NONE,
+    PRICE_BAND,     // outside the static or dynamic band
+    HALTED,         // instrument in a volatility interruption
+    UNFILLED,       // IOC/FOK/market quantity with no liquidity left
+    UNKNOWN_ORDER,  // cancel or modify of an order that is not resting
+    INVALID,        // malformed order or quantity
+    OVERLOADED,     // dropped at ingress (queue and backlog full) or no room left in the book
+    THROTTLED,      // over its participant's or instrument's order rate at ingress
+    RISK,           // refused by a pre-trade risk limit
+};
+
+inline const char* toString(ExecType type) {
+    switch (type) {
+        case ExecType::ACK: return "ack";
+        case ExecType::PARTIAL_FILL: return "partial_fill";
+        case ExecType::FILL: return "fill";
+        case ExecType::CANCEL: return "cancel";
+        case ExecType::REJECT: return "reject";
+        default: return "unknown";
+    }
+}
+
+inline const char* toString(ExecReason reason) {
+    switch (reason) {
+        case ExecReason::NONE: return "none";
+        case ExecReason::PRICE_BAND: return "price_band";
+        case ExecReason::HALTED: return "halted";
+        case ExecReason::UNFILLED: return "unfilled";
+        case ExecReason::UNKNOWN_ORDER: return "unknown_order";
+        case ExecReason::INVALID: return "invalid";
+        case ExecReason::OVERLOADED: return "overloaded";
+        case ExecReason::THROTTLED: return "throttled";
+        case ExecReason::RISK: return "risk";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+// How one family of long-lived structures is backed; see memory::allocate().
+enum class HugePageMode : uint8_t {
+    OFF,      // ordinary heap allocation (default)
+    THP,      // 2 MB-aligned anonymous mappings advised with MADV_HUGEPAGE
+    HUGETLB,  // MAP_HUGETLB from the reserved pool, falling back to THP when it is empty
+};
+
+inline const char* toString(HugePageMode mode) {
+    switch (mode) {
+        case HugePageMode::OFF: return "off";
+        case HugePageMode::THP: return "thp";
+        case HugePageMode::HUGETLB: return "hugetlb";
+        default: return "unknown";
+    }
+}
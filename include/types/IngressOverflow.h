@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+// What a dispatcher does with an order whose instrument queue is full.
+enum class IngressOverflow : uint8_t {
+    BLOCK,  // wait for the book; every instrument on the dispatcher waits with it (default)
+    SPILL,  // park the instrument's orders in a bounded backlog, replayed in order; drop beyond it
+    DROP,   // discard the order, count it and reject it on the execution report path
+};
+
+inline const char* toString(IngressOverflow overflow) {
+    switch (overflow) {
+        case IngressOverflow::BLOCK: return "block";
+        case IngressOverflow::SPILL: return "spill";
+        case IngressOverflow::DROP: return "drop";
+        default: return "unknown";
+    }
+}
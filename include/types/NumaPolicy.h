@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+// Where threads without an explicit core land relative to the NIC.
+enum class NumaPolicy : uint8_t {
+    OFF,  // leave placement to the configured cores and the scheduler (default)
+    NIC,  // keep unpinned threads and their memory on the NIC's NUMA node
+};
+
+inline const char* toString(NumaPolicy policy) {
+    switch (policy) {
+        case NumaPolicy::OFF: return "off";
+        case NumaPolicy::NIC: return "nic";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+// What a dispatcher does with an order over its participant's or instrument's rate.
+enum class ThrottleAction : uint8_t {
+    REJECT,  // discard the order and reject it on the execution report path (default)
+    DELAY,   // hold it until the bucket has a token again, up to a bounded wait
+};
+
+inline const char* toString(ThrottleAction action) {
+    switch (action) {
+        case ThrottleAction::REJECT: return "reject";
+        case ThrottleAction::DELAY: return "delay";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+// What the matching thread does when the slowest trade consumer is a full ring behind.
+enum class TradeOverflow : uint8_t {
+    BLOCK,  // wait for the slowest consumer; lossless (default)
+    DROP,   // discard the event and count it
+    SPILL,  // park events in an unbounded producer-side backlog, replayed in order
+};
+
+inline const char* toString(TradeOverflow overflow) {
+    switch (overflow) {
+        case TradeOverflow::BLOCK: return "block";
+        case TradeOverflow::DROP: return "drop";
+        case TradeOverflow::SPILL: return "spill";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+// How an engine shard hands trade events to their consumers. For an
+// OrderBook, INLINE means its sinks always run on the matching thread and it
+// never takes a TradePublisher.
+enum class TradePublishMode : uint8_t {
+    THREAD,  // sequenced ring, one thread per consumer (default)
+    INLINE,  // consumers run on the shard thread
+};
+
+inline const char* toString(TradePublishMode mode) {
+    switch (mode) {
+        case TradePublishMode::THREAD: return "thread";
+        case TradePublishMode::INLINE: return "inline";
+        default: return "unknown";
+    }
+}
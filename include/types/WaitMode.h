@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+// How a polling thread behaves once its input runs dry.
+enum class WaitMode : uint8_t {
+    BUSY_SPIN,   // pause instruction only; lowest latency, owns the core
+    SPIN_YIELD,  // spin, yielding every spin_limit polls (default)
+    SPIN_PARK,   // spin, then sleep on a futex until a producer notifies
+    BACKOFF,     // spin, then nanosleep with exponential backoff
+};
+
+inline const char* toString(WaitMode mode) {
+    switch (mode) {
+        case WaitMode::BUSY_SPIN: return "busy_spin";
+        case WaitMode::SPIN_YIELD: return "spin_yield";
+        case WaitMode::SPIN_PARK: return "spin_park";
+        case WaitMode::BACKOFF: return "backoff";
+        default: return "unknown";
+    }
+}
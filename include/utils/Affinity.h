@@ -1,12 +1,21 @@
 #pragma once
 
+#include <string>
 #include <thread>
 #include <vector>
 
 namespace cpu {
 
+// "0-3,8,10-11" -> {0,1,2,3,8,10,11}; the format of [affinity] keys and sysfs cpulists.
+std::vector<int> parseCpuList(const std::string& spec);
+// {0,1,8} -> "0,1,8", for logs.
+std::string formatCpus(const std::vector<int>& cpus);
+
 bool setCurrentThreadAffinity(const std::vector<int>& cpus);
 bool setThreadAffinity(std::thread& thread, const std::vector<int>& cpus);
 bool setThreadAffinity(std::thread& thread, int cpu);
 
+// SCHED_FIFO at `priority` (1-99); false when refused, e.g. without CAP_SYS_NICE.
+bool setThreadRealtime(std::thread& thread, int priority);
+
 }  // namespace cpu
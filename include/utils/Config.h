@@ -2,8 +2,19 @@
 
 #include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "types/AppTypes.h"
+#include "types/BookBackend.h"
+#include "types/HugePageMode.h"
+#include "types/IngressOverflow.h"
+#include "types/NumaPolicy.h"
+#include "types/ThrottleAction.h"
+#include "types/TradeOverflow.h"
+#include "types/TradePublishMode.h"
+#include "types/WaitMode.h"
+
 struct SnapshotSettings {
     std::string shm_prefix = "/simex_book";
     uint32_t interval_ms = 50;
@@ -18,6 +29,189 @@ struct LoggingSettings {
 struct AffinitySettings {
     std::vector<int> logging_cores;
     std::vector<int> engine_cores;
+    std::vector<int> risk_cores;
+    std::vector<int> dispatcher_cores;
+    // trade_cores[i] pins the trade publisher thread of engine shard i.
+    std::vector<int> trade_cores;
+    // exec_report_cores[i] pins the execution report sender of engine shard i.
+    std::vector<int> exec_report_cores;
+};
+
+// Backing of each structure family, see memory::configureHugePages().
+struct HugePageSettings {
+    HugePageMode ladders = HugePageMode::OFF;
+    HugePageMode arenas = HugePageMode::OFF;
+    HugePageMode queues = HugePageMode::OFF;
+    HugePageMode sockets = HugePageMode::OFF;
+};
+
+// policy=nic confines every thread without a configured core to the NUMA
+// node of mcast_iface (or `node` when set) and builds each thread's books,
+// queues and buffers on that thread. Configured cores on another node are
+// kept but reported at startup.
+struct NumaSettings {
+    NumaPolicy policy = NumaPolicy::OFF;
+    int node = -1;
+    std::string sys_root = "/sys";
+};
+
+// A limit of 0 disables that particular check.
+struct RiskSettings {
+    bool enabled = false;
+    uint32_t max_participants = 1024;
+    uint64_t max_order_qty = 0;
+    uint64_t max_notional = 0;
+    uint32_t max_open_orders = 0;
+    uint64_t max_position = 0;
+    // Orders tracked at once (not a limit that 0 disables): sizes the order
+    // table, and new orders are rejected while it is full.
+    uint32_t max_live_orders = 1u << 20;
+};
+
+// Band widths are in basis points; 0 disables the corresponding check.
+struct PriceBandSettings {
+    Price reference_price = 0;
+    uint32_t static_band_bps = 0;
+    uint32_t dynamic_band_bps = 0;
+    uint32_t volatility_move_bps = 0;
+    uint32_t volatility_window_ms = 0;
+    uint32_t halt_ms = 0;
+};
+
+// Universe = explicit tokens plus every row of csv_path (market_data.csv
+// schema). A relative csv_path is resolved against the config file directory.
+struct InstrumentSettings {
+    std::vector<InstrumentToken> tokens;
+    std::string csv_path;
+};
+
+// One shard per AffinitySettings::engine_cores entry (a single unpinned
+// shard when that list is empty). pins override the assignment policy.
+// multi_producer_queues switches the per-instrument queues to MPSC.
+// Trades of a shard go through one publisher: a ring of trade_ring_capacity
+// events drained by per-consumer threads, or inline on the shard thread.
+// trade_overflow applies when the slowest trade consumer falls a ring behind.
+struct EngineSettings {
+    std::string assignment = "round_robin";
+    std::size_t queue_capacity = 10240;
+    bool multi_producer_queues = false;
+    TradePublishMode trade_publisher = TradePublishMode::THREAD;
+    std::size_t trade_ring_capacity = 65536;
+    TradeOverflow trade_overflow = TradeOverflow::BLOCK;
+    // rebalance_interval_ms > 0 moves books from the busiest shard to the
+    // idlest when busiest > idlest * rebalance_ratio and the busiest handled
+    // at least rebalance_min_load messages in the interval. A move pauses the
+    // releasing shard for at most migration_max_pause_us.
+    uint32_t rebalance_interval_ms = 0;
+    double rebalance_ratio = 1.5;
+    uint64_t rebalance_min_load = 1000;
+    uint32_t migration_max_pause_us = 1000;
+    std::unordered_map<InstrumentToken, std::size_t> pins;
+};
+
+// dispatchers > 1 runs one socket and thread per dispatcher. "reuseport":
+// every socket joins mcast_ip on a shared port and each dispatcher only
+// routes the instruments it owns. "groups": dispatcher i joins groups[i]
+// and the sender partitions instruments across groups.
+//
+// With onboarding on, an order for an unknown instrument makes its owning
+// dispatcher ask the engine for a book; up to onboarding_buffer orders are
+// held for at most onboarding_timeout_ms meanwhile, and at most
+// onboarding_max_instruments books are created at runtime. Off, such orders
+// are dropped and counted.
+//
+// sequencer stamps every inbound order with one global sequence shared by all
+// dispatchers; trades, execution reports and snapshots carry it.
+//
+// overflow decides what a dispatcher does when an instrument's queue is full
+// (per token in [ingress.overflow]); spill keeps up to spill_capacity orders
+// per instrument.
+struct IngressSettings {
+    std::size_t dispatchers = 1;
+    std::string mode = "reuseport";
+    std::vector<std::string> groups;
+    bool onboarding = false;
+    std::size_t onboarding_buffer = 1024;
+    uint32_t onboarding_timeout_ms = 100;
+    std::size_t onboarding_max_instruments = 1024;
+    bool sequencer = false;
+    IngressOverflow overflow = IngressOverflow::BLOCK;
+    std::size_t spill_capacity = 4096;
+    std::unordered_map<InstrumentToken, IngressOverflow> instrument_overflow;
+};
+
+// Order rate limits at ingress, as token buckets: *_rate is orders per second
+// (0 leaves that dimension unlimited) and *_burst how many may arrive back to
+// back. Participants are ids below max_participants (higher ids share one
+// bucket); [throttle.participants] sets a rate per id. Excess orders are
+// rejected, or with action=delay held for at most max_delay_us, and at most
+// delay_capacity per dispatcher, before being rejected after all.
+struct ThrottleSettings {
+    bool enabled = false;
+    uint32_t max_participants = 1024;
+    uint64_t participant_rate = 0;
+    uint32_t participant_burst = 100;
+    std::unordered_map<ParticipantId, uint64_t> participant_rates;
+    uint64_t instrument_rate = 0;
+    uint32_t instrument_burst = 1000;
+    ThrottleAction action = ThrottleAction::REJECT;
+    uint32_t max_delay_us = 10000;
+    std::size_t delay_capacity = 65536;
+};
+
+// Binary execution reports (ack, fill, partial, cancel, reject), one stream
+// per engine shard, sent to mcast_ip:mcast_port through mcast_iface. Each
+// shard queues up to ring_capacity reports for its sender thread; overflow
+// is block or drop.
+struct ExecReportSettings {
+    bool enabled = false;
+    std::string mcast_ip = "239.192.1.3";
+    int mcast_port = 5002;
+    std::size_t ring_capacity = 65536;
+    TradeOverflow overflow = TradeOverflow::BLOCK;
+};
+
+// Startup warm-up, done before any dispatcher joins multicast. lock_memory
+// mlockall()s the process, current and future mappings, so later ones are
+// faulted in as they are mapped. expected_orders pre-sizes every book's order
+// table and index for order ids up to that value; level_orders pre-grows the
+// order list of every ring slot. synthetic_orders are matched through a
+// throwaway book per backend on each shard's core.
+struct WarmupSettings {
+    bool enabled = false;
+    bool lock_memory = false;
+    std::size_t expected_orders = 0;
+    std::size_t level_orders = 0;
+    std::size_t synthetic_orders = 0;
+};
+
+// Startup profile for deterministic latency: mlockall, SCHED_FIFO for pinned
+// engine and dispatcher threads (priority 0 keeps SCHED_OTHER), transparent huge
+// pages off for the process unless a [memory] region asks for thp, a check
+// that engine_cores are isolated (isolcpus) and tickless (nohz_full), and an
+// OS jitter probe of probe_ms on each engine core before going live.
+struct LowJitterSettings {
+    bool enabled = false;
+    int engine_priority = 80;
+    int dispatcher_priority = 70;
+    uint32_t probe_ms = 200;
+    uint32_t probe_threshold_ns = 1000;
+};
+
+// Idle behaviour of one polling thread; see WaitStrategy.
+struct WaitSettings {
+    WaitMode mode = WaitMode::SPIN_YIELD;
+    uint32_t spin_limit = 1000;
+    uint32_t park_timeout_us = 1000;
+    uint32_t backoff_max_us = 256;
+};
+
+// [wait] sets every role, [wait.<role>] overrides one of them.
+struct ThreadWaitSettings {
+    WaitSettings engine;
+    WaitSettings dispatcher;
+    WaitSettings trade;
+    WaitSettings risk;
 };
 
 struct AppConfig {
@@ -25,9 +219,27 @@ struct AppConfig {
     std::string mcast_iface = "lo";
     int mcast_port = 5001;
     bool use_std_map = false;
+    BookBackend book_backend = BookBackend::RING;
+    std::unordered_map<InstrumentToken, BookBackend> instrument_book_backends;
     SnapshotSettings snapshot;
     LoggingSettings logging;
     AffinitySettings affinity;
+    NumaSettings numa;
+    HugePageSettings memory;
+    InstrumentSettings instruments;
+    EngineSettings engine;
+    IngressSettings ingress;
+    ThrottleSettings throttle;
+    ExecReportSettings exec_reports;
+    WarmupSettings warmup;
+    LowJitterSettings low_jitter;
+    ThreadWaitSettings wait;
+    RiskSettings risk;
+    PriceBandSettings price_bands;
+    std::unordered_map<InstrumentToken, PriceBandSettings> instrument_price_bands;
+
+    const PriceBandSettings& priceBandsFor(InstrumentToken token) const;
+    BookBackend bookBackendFor(InstrumentToken token) const;
 };
 
 AppConfig loadConfig(const std::string& path);
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "utils/Config.h"
+
+namespace memory {
+
+// Families of structures whose backing is configured together ([memory] in app.ini).
+enum class Region : uint8_t {
+    LADDERS,  // price ring slots and per-level order lists
+    ARENAS,   // order slot tables and the per-book order index
+    QUEUES,   // instruction queues and trade rings
+    SOCKETS,  // multicast send and receive buffers
+};
+
+constexpr std::size_t kRegionCount = 4;
+constexpr std::size_t kHugePageSize = std::size_t{2} << 20;
+
+const char* toString(Region region);
+
+// Bytes currently mapped for a region, by what actually backs them.
+struct RegionStats {
+    HugePageMode mode = HugePageMode::OFF;
+    uint64_t allocations = 0;
+    uint64_t live_bytes = 0;
+    uint64_t hugetlb_bytes = 0;
+    uint64_t thp_bytes = 0;
+    uint64_t small_page_bytes = 0;
+    // MAP_HUGETLB attempts that found the pool empty and fell back.
+    uint64_t hugetlb_fallbacks = 0;
+};
+
+/**
+ * @brief Process-wide backing for the structures that dominate the TLB
+ *        footprint of the matching path.
+ *
+ * With a region OFF, allocate() is plain aligned operator new. Otherwise
+ * requests of half a huge page or more get their own 2 MB-aligned mapping
+ * and smaller ones are carved out of the calling thread's 2 MB slabs in
+ * power-of-two size classes, with no lock; freed blocks go back to the
+ * freeing thread's class, so a vector that grows reuses what it released.
+ * Slabs are never returned to the system.
+ *
+ * configureHugePages() must run before anything of a region is allocated:
+ * deallocate() trusts the region's mode, so a region that has allocated
+ * keeps its mode and a later change is refused with a warning.
+ */
+void configureHugePages(const HugePageSettings& settings);
+void* allocate(Region region, std::size_t bytes, std::size_t align);
+void deallocate(Region region, void* ptr, std::size_t bytes, std::size_t align) noexcept;
+RegionStats stats(Region region);
+// Logs per-region backing plus AnonHugePages of the process.
+void logHugePageReport();
+// mlockall(MCL_CURRENT | MCL_FUTURE): everything mapped so far is faulted in
+// and pinned, later mappings are populated as they are made. Logs and
+// returns false when refused (e.g. RLIMIT_MEMLOCK).
+bool lockProcessMemory();
+
+}  // namespace memory
+
+// std::allocator stand-in that places a container's storage in a region.
+template <typename T, memory::Region R>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = HugePageAllocator<U, R>;
+    };
+
+    HugePageAllocator() noexcept = default;
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, R>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(memory::allocate(R, n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept {
+        memory::deallocate(R, ptr, n * sizeof(T), alignof(T));
+    }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U, R>&) const noexcept {
+        return true;
+    }
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "types/AppTypes.h"
+#include "utils/Config.h"
+
+// One row of market_data.csv; tokens listed only in the ini get defaults.
+struct InstrumentSpec {
+    InstrumentToken token = 0;
+    std::string symbol;
+    std::string name;
+    uint32_t lot_size = 1;
+    double tick_size = 0.0;
+    double prev_close = 0.0;
+};
+
+// Columns are matched by header name; only "token" is required.
+std::vector<InstrumentSpec> loadInstrumentCsv(const std::string& path);
+
+// Ini tokens first, then CSV rows, de-duplicated by token in that order.
+std::vector<InstrumentSpec> loadInstrumentUniverse(const InstrumentSettings& settings);
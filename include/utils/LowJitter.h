@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace jitter {
+
+// CPUs the kernel keeps other tasks off (isolcpus) and runs without the
+// periodic tick (nohz_full), from /sys/devices/system/cpu/{isolated,nohz_full}.
+struct Isolation {
+    std::vector<int> isolated;
+    std::vector<int> nohz_full;
+};
+
+// sys_root lets tests point at a fabricated tree, as numa::discover does.
+Isolation readIsolation(const std::string& sys_root = "/sys");
+
+// Warns once per core of `role` that is not isolated or not tickless;
+// true when every core is both.
+bool checkIsolation(const char* role, const std::vector<int>& cores, const Isolation& isolation);
+
+// Selected mode of /sys/kernel/mm/transparent_hugepage/defrag ("always",
+// "defer", "madvise", ...); empty when unknown.
+std::string thpDefrag(const std::string& sys_root = "/sys");
+
+// prctl(PR_SET_THP_DISABLE): no transparent huge page faults, hence no
+// compaction or khugepaged collapse, for this process. hugetlb is unaffected.
+bool disableTransparentHugePages();
+
+// What a sysjitter-style probe saw: the calling thread reads the clock in a
+// tight loop and every gap above the threshold counts as time the OS took.
+struct Probe {
+    uint64_t samples = 0;
+    uint64_t interruptions = 0;
+    uint64_t lost_ns = 0;
+    uint64_t max_ns = 0;
+    uint64_t elapsed_ns = 0;
+
+    double lostPercent() const {
+        return elapsed_ns == 0 ? 0.0 : 100.0 * static_cast<double>(lost_ns) / static_cast<double>(elapsed_ns);
+    }
+};
+
+// Spins for `duration` on the calling thread; pin it to the core to measure.
+Probe measure(std::chrono::nanoseconds duration, std::chrono::nanoseconds threshold);
+
+}  // namespace jitter
@@ -36,14 +36,19 @@ public:
     }
 
 private:
+    // Over-aligned T (e.g. cache-line aligned nodes) needs storage with the same alignment.
+    struct alignas(T) Storage {
+        std::byte bytes[sizeof(T)];
+    };
+
     void addChunk() {
-        auto chunk = std::make_unique<std::uint8_t[]>(ChunkSize * sizeof(T));
-        T* ptr = reinterpret_cast<T*>(chunk.get());
-        for (std::size_t i = 0; i < ChunkSize; ++i)
-            free_list_.push_back(ptr + i);
+        auto chunk = std::make_unique<Storage[]>(ChunkSize);
+        // Push in reverse so allocation hands out ascending addresses.
+        for (std::size_t i = ChunkSize; i > 0; --i)
+            free_list_.push_back(reinterpret_cast<T*>(&chunk[i - 1]));
         chunks_.push_back(std::move(chunk));
     }
 
-    std::vector<std::unique_ptr<std::uint8_t[]>> chunks_;
+    std::vector<std::unique_ptr<Storage[]>> chunks_;
     std::vector<T*> free_list_;
 };
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace numa {
+
+/**
+ * @brief NUMA nodes and their CPUs as reported by sysfs.
+ *
+ * Built from /sys/devices/system/node/node<N>/cpulist. Machines (or
+ * containers) without that directory come back as a single node 0 holding
+ * every online CPU, so callers never need a special case for "no NUMA".
+ */
+struct Topology {
+    // node_cpus[n] lists the CPUs of node n; ids missing from sysfs stay empty.
+    std::vector<std::vector<int>> node_cpus;
+
+    std::size_t nodeCount() const;
+    bool multiNode() const { return nodeCount() > 1; }
+    // -1 when the CPU belongs to no known node.
+    int nodeOf(int cpu) const;
+    const std::vector<int>& cpusOf(int node) const;
+};
+
+// sys_root lets tests and the placement bench point at a fabricated tree.
+Topology discover(const std::string& sys_root = "/sys");
+
+// Node of the NIC behind iface, from /sys/class/net/<iface>/device/numa_node;
+// -1 for virtual interfaces and single-node machines.
+int nicNode(const std::string& iface, const std::string& sys_root = "/sys");
+
+// CPUs for a thread of the given role: its configured cores when there are
+// any (explicit pinning always wins), otherwise every CPU of `node`. Empty
+// when neither is known, i.e. leave the thread to the scheduler.
+std::vector<int> placeOnNode(const Topology& topology, int node, const std::vector<int>& pinned);
+
+// The subset of cpus that lies outside `node`.
+std::vector<int> remoteCpus(const Topology& topology, int node, const std::vector<int>& cpus);
+
+// Runs fn on a short-lived thread confined to cpus and waits for it, so the
+// memory fn allocates and writes is first-touched on that CPU's node. Runs
+// inline when cpus is empty. Exceptions thrown by fn are rethrown here.
+void runOn(const std::vector<int>& cpus, const std::function<void()>& fn);
+
+}  // namespace numa
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "utils/CompilerHints.h"
+#include "utils/Config.h"
+#include "utils/Counters.h"
+#include "utils/LatencyStats.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+struct WaitCounters {
+    uint64_t spins = 0;
+    uint64_t yields = 0;
+    uint64_t sleeps = 0;
+    uint64_t parks = 0;
+    uint64_t wakeups = 0;
+    uint64_t wake_latency_total_ns = 0;
+    uint64_t wake_latency_max_ns = 0;
+
+    WaitCounters& operator+=(const WaitCounters& other);
+    uint64_t averageWakeLatencyNs() const { return wakeups ? wake_latency_total_ns / wakeups : 0; }
+};
+
+/**
+ * @brief Idle policy of one polling thread, plus the wake-up channel its
+ *        producers signal.
+ *
+ * The owning thread calls idle() after every empty poll and reset() once it
+ * finds work. Producers call notify() after publishing; that is free unless
+ * the owner runs SPIN_PARK, and a single load unless it is actually parked.
+ * Parking follows the eventcount protocol: the owner registers as a sleeper,
+ * re-evaluates `ready`, and only then sleeps, so a publish racing with the
+ * empty poll is never lost. park_timeout_us bounds every sleep, which covers
+ * waits nobody notifies (a producer waiting for queue space).
+ *
+ * Counters are written by the owner and may be read from any thread.
+ */
+class WaitStrategy {
+public:
+    explicit WaitStrategy(const WaitSettings& settings = {});
+
+    WaitStrategy(const WaitStrategy&) = delete;
+    WaitStrategy& operator=(const WaitStrategy&) = delete;
+
+    template <typename Ready>
+    void idle(Ready&& ready) {
+        if (mode_ == WaitMode::BUSY_SPIN || ++idle_polls_ < spin_limit_) {
+            stats::bump(spins_);
+            cpuRelax();
+            return;
+        }
+        switch (mode_) {
+            case WaitMode::SPIN_PARK:
+                park(ready);
+                break;
+            case WaitMode::BACKOFF:
+                backoff();
+                break;
+            default:
+                yield();
+                break;
+        }
+    }
+
+    void idle() {
+        idle([] { return false; });
+    }
+
+    void reset() {
+        idle_polls_ = 0;
+        backoff_ns_ = kMinBackoffNs;
+    }
+
+    void notify() {
+        if (mode_ != WaitMode::SPIN_PARK) {
+            return;
+        }
+        // Orders the caller's publish before the sleeper check; pairs with
+        // the seq_cst registration in park().
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (LIKELY(sleepers_.load(std::memory_order_relaxed) == 0)) {
+            return;
+        }
+        wake();
+    }
+
+    WaitMode mode() const { return mode_; }
+    WaitCounters counters() const;
+
+private:
+    static constexpr uint64_t kMinBackoffNs = 1'000;
+
+    template <typename Ready>
+    void park(Ready& ready) {
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        const uint32_t key = epoch_.load(std::memory_order_seq_cst);
+        if (!ready()) {
+            stats::bump(parks_);
+            sleep(key);
+        }
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void yield();
+    void backoff();
+    void sleep(uint32_t key);
+    void wake();
+
+    const WaitMode mode_;
+    const uint32_t spin_limit_;
+    const uint64_t park_timeout_ns_;
+    const uint64_t backoff_max_ns_;
+
+    // Owner side.
+    uint32_t idle_polls_ = 0;
+    uint64_t backoff_ns_ = kMinBackoffNs;
+    std::atomic<uint64_t> spins_{0};
+    std::atomic<uint64_t> yields_{0};
+    std::atomic<uint64_t> sleeps_{0};
+    std::atomic<uint64_t> parks_{0};
+    LatencyStats wake_latency_;
+
+    // Producer side.
+    alignas(64) std::atomic<uint32_t> epoch_{0};
+    std::atomic<uint32_t> sleepers_{0};
+    std::atomic<int64_t> notified_ns_{0};
+};
@@ -0,0 +1,86 @@
+#include "core/ExecReportPublisher.h"
+
+#include <utility>
+
+#include "utils/Affinity.h"
+#include "utils/Counters.h"
+
+ExecReportPublisher::ExecReportPublisher(const Options& options, Transport transport)
+    : options_(options),
+      transport_(std::move(transport)),
+      ring_(options.capacity, 1),
+      wait_(options.wait) {}
+
+ExecReportPublisher::~ExecReportPublisher() {
+    running_.store(false, std::memory_order_release);
+    wait_.notify();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ExecReportPublisher::start() {
+    if (started_) {
+        return;
+    }
+    started_ = true;
+    thread_ = std::thread([this] { run(); });
+}
+
+void ExecReportPublisher::publish(const execution::ExecutionReport& report) {
+    if (UNLIKELY(!started_)) {
+        start();
+    }
+    if (LIKELY(ring_.tryPublish(report))) {
+        stats::bump(published_);
+        wait_.notify();
+        return;
+    }
+    if (options_.overflow == TradeOverflow::DROP) {
+        stats::bump(dropped_);
+        return;
+    }
+    stats::bump(stalls_);
+    uint32_t spins = 0;
+    while (!ring_.tryPublish(report)) {
+        if (++spins % 1000 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    stats::bump(published_);
+    wait_.notify();
+}
+
+std::size_t ExecReportPublisher::sendBatch() {
+    const uint64_t sequence = ring_.cursor(0);
+    const auto reports = ring_.peek(0, execution::kMaxReportsPerDatagram);
+    if (reports.empty()) {
+        return 0;
+    }
+    const std::size_t len = execution::encodeReports(options_.stream, sequence, reports, datagram_.data());
+    transport_(datagram_.data(), len);
+    ring_.release(0, reports.size());
+    stats::bump(datagrams_);
+    return reports.size();
+}
+
+void ExecReportPublisher::run() {
+    if (options_.core >= 0) {
+        cpu::setCurrentThreadAffinity(std::vector<int>{options_.core});
+    } else if (!options_.cpus.empty()) {
+        cpu::setCurrentThreadAffinity(options_.cpus);
+    }
+    while (true) {
+        if (sendBatch() > 0) {
+            wait_.reset();
+            continue;
+        }
+        if (!running_.load(std::memory_order_acquire)) {
+            // Anything published before shutdown is visible now; send it and exit.
+            while (sendBatch() > 0) {
+            }
+            return;
+        }
+        wait_.idle([this] { return !running_.load(std::memory_order_acquire) || ring_.lag(0) > 0; });
+    }
+}
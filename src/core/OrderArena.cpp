@@ -52,6 +52,12 @@ void OrderArena::erase(OrderId id) {
     }
 }
 
+void OrderArena::reserve(std::size_t orders) {
+    if (orders > 0) {
+        ensureCapacity(static_cast<OrderId>(orders - 1));
+    }
+}
+
 void OrderArena::ensureCapacity(OrderId id) {
     if (id < slots_.size()) {
         return;
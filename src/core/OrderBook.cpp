@@ -1,13 +1,15 @@
 #include "core/OrderBook.h"
 
 #include <algorithm>
+#include <chrono>
 #include <iomanip>
 #include <limits>
 #include <sstream>
-#include <thread>
+#include <stdexcept>
 #include <vector>
 
-#include "utils/Affinity.h"
+#include "core/ExecReportPublisher.h"
+#include "core/TradePublisher.h"
 #include "utils/LogMacros.h"
 
 #define COLOR_RESET   "\033[0m"
@@ -16,48 +18,80 @@
 #define COLOR_BOLD    "\033[1m"
 #define COLOR_DIM     "\033[2m"
 
-OrderBook::OrderBook(bool use_std_map)
-    : bids_(Side::BUY),
-      asks_(Side::SELL),
-      trade_ring_(2048),
-      trade_thread_([this] { tradeWorker(); }) {
-    (void)use_std_map;
+namespace {
+int64_t toNanos(HrtTime ts) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(ts.time_since_epoch()).count();
+}
 
-    trade_listener_ = [](const TradeEvent& event) {
+struct TradeLog {
+    void onTrades(TradeBatch trades) const {
 #if defined(ENABLE_INFO_LOGS)
-        LOG_INFO(
-            "TRADE: token={} {} matched with {} @ {} for {} qty",
-            event.instrument,
-            (event.aggressorSide == Side::BUY ? "BUY" : "SELL"),
-            (event.restingSide == Side::BUY ? "BUY" : "SELL"),
-            event.price,
-            event.quantity);
+        for (const TradeEvent& event : trades) {
+            LOG_INFO(
+                "TRADE: token={} {} matched with {} @ {} for {} qty",
+                event.instrument,
+                (event.aggressorSide == Side::BUY ? "BUY" : "SELL"),
+                (event.restingSide == Side::BUY ? "BUY" : "SELL"),
+                event.price,
+                event.quantity);
+        }
 #else
-        (void)event;
+        (void)trades;
 #endif
-    };
-}
+    }
+};
 
-OrderBook::~OrderBook() {
-    trade_running_.store(false, std::memory_order_release);
-    trade_head_.store(UINT32_MAX, std::memory_order_release);
-    if (trade_thread_.joinable()) {
-        trade_thread_.join();
+const TradeLog kTradeLog{};
+}  // namespace
+
+OrderBook::OrderBook(bool use_std_map)
+    : OrderBook(use_std_map ? BookBackend::STD_MAP : BookBackend::RING) {}
+
+OrderBook::OrderBook(BookBackend backend)
+    : OrderBook(backend, TradePublishMode::THREAD) {}
+
+OrderBook::OrderBook(BookBackend backend, TradePublishMode dispatch)
+    : backend_(backend),
+      dispatch_(dispatch),
+      bids_(Side::BUY, backend),
+      asks_(Side::SELL, backend) {
+    if (dispatch_ == TradePublishMode::THREAD) {
+        sinks_.add(kTradeLog);
     }
 }
 
+OrderBook::~OrderBook() = default;
+
 void OrderBook::addOrder(std::unique_ptr<Order> order) {
     if (!order) {
         return;
     }
 
     const OrderId orderId = order->orderId();
+    sequence_ = order->sequence();
+    if (sequence_ != 0) {
+        last_sequence_ = sequence_;
+    }
     orders_.store(std::move(order));
     processOrder(orderId);
 }
 
 void OrderBook::processOrder(OrderId orderId) {
     Order& order = orders_.require(orderId);
+    if (UNLIKELY(bands_.active())) {
+        const ExecReason refused = admitBands(order);
+        if (refused != ExecReason::NONE) {
+            report(order, ExecType::REJECT, refused);
+            releaseOrderInternal(orderId);
+            return;
+        }
+    }
+    if (UNLIKELY(order.type() > OrderType::ICEBERG)) {
+        report(order, ExecType::REJECT, ExecReason::INVALID);
+        releaseOrderInternal(orderId);
+        return;
+    }
+    report(order, ExecType::ACK);
     MatchParams params{};
     switch (order.type()) {
         case OrderType::LIMIT:
@@ -65,7 +99,8 @@ void OrderBook::processOrder(OrderId orderId) {
             executeMatch(orderId, params);
             break;
         case OrderType::MARKET:
-            params = {.respectPrice = false, .allowRest = false};
+            // With bands active the market order carries its protection price.
+            params = {.respectPrice = bands_.active(), .allowRest = false};
             executeMatch(orderId, params);
             break;
         case OrderType::IOC:
@@ -74,6 +109,7 @@ void OrderBook::processOrder(OrderId orderId) {
             break;
         case OrderType::FOK:
             if (!ensureFokLiquidity(order)) {
+                report(order, ExecType::CANCEL, ExecReason::UNFILLED);
                 releaseOrderInternal(orderId);
                 return;
             }
@@ -86,18 +122,17 @@ void OrderBook::processOrder(OrderId orderId) {
             executeMatch(orderId, params);
             break;
         default:
+            report(order, ExecType::CANCEL, ExecReason::INVALID);
             releaseOrderInternal(orderId);
             break;
     }
 }
 
-void OrderBook::setTradeListener(TradeListener listener) {
-    trade_listener_ = std::move(listener);
-}
-
 bool OrderBook::cancelOrder(OrderId orderId) {
+    sequence_ = 0;
     auto* ref = findOrderRef(orderId);
     if (!ref) {
+        reportReject(orderId, ExecReason::UNKNOWN_ORDER);
         return false;
     }
 
@@ -129,14 +164,17 @@ bool OrderBook::cancelOrder(OrderId orderId) {
         }
     }
 
+    report(orders_.require(orderId), ExecType::CANCEL);
     orders_.erase(orderId);
     return true;
 }
 
 void OrderBook::modifyOrder(OrderId orderId, Price newPrice, Qty newQty) {
+    sequence_ = 0;
     auto* ref = findOrderRef(orderId);
     if (!ref) {
         LOG_WARN("Modify failed: order {} not found", orderId);
+        reportReject(orderId, ExecReason::UNKNOWN_ORDER);
         return;
     }
 
@@ -152,17 +190,27 @@ void OrderBook::modifyOrder(OrderId orderId, Price newPrice, Qty newQty) {
 
     const bool priceChanged = newPrice != order.price();
     const bool qtyIncrease = newQty > order.quantity();
+    const Qty beforeLeaves = order.remaining_quantity();
 
     if (!priceChanged && !qtyIncrease) {
         const Qty beforePending = order.pending_quantity();
         if (!order.modifyQty(newQty)) {
             LOG_WARN("Modify failed: invalid quantity {} for order {}", newQty, orderId);
+            reportReject(orderId, ExecReason::INVALID);
             return;
         }
+        leavesChanged(orderId, beforeLeaves, order.remaining_quantity());
+        // An iceberg keeps its current slice; a reduction must not refill it in place.
+        order.capPendingQuantity(beforePending);
         const Qty afterPending = order.pending_quantity();
         if (afterPending < beforePending) {
             level->decOpenQty(beforePending - afterPending);
         }
+        if (order.remaining_quantity() == 0) {
+            cancelOrder(orderId);
+        } else {
+            report(order, ExecType::ACK);
+        }
         return;
     }
 
@@ -180,9 +228,11 @@ void OrderBook::modifyOrder(OrderId orderId, Price newPrice, Qty newQty) {
 
     if (!order.modifyQty(newQty)) {
         LOG_WARN("Modify failed: invalid quantity {} for order {}", newQty, orderId);
+        report(order, ExecType::CANCEL, ExecReason::INVALID);
         orders_.erase(orderId);
         return;
     }
+    leavesChanged(orderId, beforeLeaves, order.remaining_quantity());
     if (priceChanged) {
         order.modifyPrice(newPrice);
     }
@@ -223,6 +273,7 @@ void OrderBook::restOrderInternal(OrderId orderId) {
     PriceLevel* level = ensureLevel(order.side(), order.price());
     if (!level) {
         LOG_ERROR("Failed to allocate price level for order {}", orderId);
+        report(order, ExecType::CANCEL, ExecReason::OVERLOADED);
         releaseOrderInternal(orderId);
         return;
     }
@@ -230,6 +281,7 @@ void OrderBook::restOrderInternal(OrderId orderId) {
     const size_t slot = level->addOrder(orderId, orders_);
     if (slot == PriceLevel::kInvalidSlot) {
         LOG_ERROR("Failed to reserve slot for order {}", orderId);
+        report(order, ExecType::CANCEL, ExecReason::OVERLOADED);
         releaseOrderInternal(orderId);
         return;
     }
@@ -240,7 +292,8 @@ void OrderBook::restOrderInternal(OrderId orderId) {
             bids_.markLevelNonEmpty(order.price());
         } else if (order.side() == Side::SELL) {
             asks_.markLevelNonEmpty(order.price());
-        }    }
+        }
+    }
 }
 
 void OrderBook::removeRestingOrderInternal(Side restingSide, Price price, PriceLevel& level, OrderId orderId) {
@@ -268,7 +321,7 @@ void OrderBook::releaseOrderInternal(OrderId orderId) {
 
 Qty OrderBook::liquidityForBuy(Price limitPrice) const {
     Qty total = 0;
-    asks_.forEachAscending([&](Price px, const PriceLevel& level) {
+    asks_.forEachLevel([&](Price px, const PriceLevel& level) {
         if (px <= limitPrice) {
             total += level.openQty();
         }
@@ -278,7 +331,7 @@ Qty OrderBook::liquidityForBuy(Price limitPrice) const {
 
 Qty OrderBook::liquidityForSell(Price limitPrice) const {
     Qty total = 0;
-    bids_.forEachAscending([&](Price px, const PriceLevel& level) {
+    bids_.forEachLevel([&](Price px, const PriceLevel& level) {
         if (px >= limitPrice) {
             total += level.openQty();
         }
@@ -296,6 +349,17 @@ Qty OrderBook::availableLiquidityAgainst(Side incomingSide, Price limitPrice) co
     return 0;
 }
 
+void OrderBook::reserve(std::size_t orders, std::size_t level_orders) {
+    if (orders > 0) {
+        orders_.reserve(orders);
+        ensureOrderIndexCapacity(static_cast<OrderId>(orders - 1));
+    }
+    if (level_orders > 0) {
+        bids_.reserveLevels(level_orders);
+        asks_.reserveLevels(level_orders);
+    }
+}
+
 void OrderBook::ensureOrderIndexCapacity(OrderId orderId) {
     const size_t required = static_cast<size_t>(orderId) + 1;
     if (required <= order_index_.size()) {
@@ -341,10 +405,71 @@ bool OrderBook::ensureFokLiquidity(const Order& order) const {
     return available >= required;
 }
 
+ExecReason OrderBook::admitBands(Order& order) {
+    if (!bands_.admitsTrading(toNanos(order.timestamp()))) {
+        ++band_rejects_;
+        return ExecReason::HALTED;
+    }
+    if (order.type() == OrderType::MARKET) {
+        order.modifyPrice(bands_.protectionPrice(order.side()));
+        return ExecReason::NONE;
+    }
+    if (!bands_.admitsPrice(order.price())) {
+        ++band_rejects_;
+        return ExecReason::PRICE_BAND;
+    }
+    return ExecReason::NONE;
+}
+
+void OrderBook::report(const Order& order, ExecType type, ExecReason reason, Price price, Qty last_qty) {
+    if (type == ExecType::CANCEL || type == ExecType::REJECT) {
+        leavesChanged(order.orderId(), order.remaining_quantity(), 0);
+    }
+    if (reports_ == nullptr) {
+        return;
+    }
+    execution::ExecutionReport out;
+    out.order_id = order.orderId();
+    out.price = (last_qty > 0) ? price : order.price();
+    out.timestamp_ns = static_cast<uint64_t>(toNanos(order.timestamp()));
+    out.instrument = instrument_token_;
+    out.last_qty = last_qty;
+    out.cum_qty = order.filled_quantity();
+    // Whatever is not resting after a cancel or reject is gone.
+    out.leaves_qty = (type == ExecType::CANCEL || type == ExecType::REJECT) ? 0 : order.remaining_quantity();
+    out.type = type;
+    out.side = static_cast<uint8_t>(order.side());
+    out.reason = reason;
+    out.sequence = sequence_;
+    reports_->publish(out);
+}
+
+void OrderBook::leavesChanged(OrderId orderId, Qty before, Qty after) {
+    if (leaves_hook_ != nullptr && before != after) {
+        leaves_hook_(leaves_context_, orderId, static_cast<int64_t>(after) - static_cast<int64_t>(before));
+    }
+}
+
+void OrderBook::reportReject(OrderId orderId, ExecReason reason) {
+    if (reports_ == nullptr) {
+        return;
+    }
+    execution::ExecutionReport out;
+    out.order_id = orderId;
+    out.timestamp_ns = static_cast<uint64_t>(toNanos(std::chrono::system_clock::now()));
+    out.instrument = instrument_token_;
+    out.type = ExecType::REJECT;
+    out.reason = reason;
+    out.sequence = sequence_;
+    reports_->publish(out);
+}
+
 void OrderBook::executeMatch(OrderId orderId, const MatchParams& params) {
     Order& order = orders_.require(orderId);
     const Side incomingSide = order.side();
     const Side oppositeSide = (incomingSide == Side::BUY) ? Side::SELL : Side::BUY;
+    const int64_t nowNs = UNLIKELY(bands_.active()) ? toNanos(order.timestamp()) : 0;
+    bool halted = false;
 
     while (order.pending_quantity() > 0) {
         Price bestPrice = 0;
@@ -382,35 +507,46 @@ void OrderBook::executeMatch(OrderId orderId, const MatchParams& params) {
                 oppositeSide,
                 restingId,
                 tradePrice,
-                tradeQty};
+                tradeQty,
+                sequence_};
             dispatchTrade(event);
+            if (reports_ != nullptr) {
+                report(order, order.remaining_quantity() == 0 ? ExecType::FILL : ExecType::PARTIAL_FILL,
+                       ExecReason::NONE, tradePrice, tradeQty);
+                report(headOrder, headOrder.remaining_quantity() == 0 ? ExecType::FILL : ExecType::PARTIAL_FILL,
+                       ExecReason::NONE, tradePrice, tradeQty);
+            }
+            if (UNLIKELY(bands_.active()) && bands_.onTrade(tradePrice, nowNs)) {
+                LOG_WARN("Volatility interruption on token {} at price {}", instrument_token_, tradePrice);
+                halted = true;
+            }
         }
 
         if (headOrder.pending_quantity() == 0) {
             removeRestingOrderInternal(oppositeSide, tradePrice, *oppositeLevel, restingId);
         }
+        // An aggressive iceberg sweeps with its hidden quantity, not just one slice.
+        if (order.pending_quantity() == 0 && order.hasDisplayQuantity() && order.remaining_quantity() > 0) {
+            order.refreshWorkingQuantity();
+        }
+        if (UNLIKELY(halted)) {
+            break;
+        }
     }
 
-    if (params.allowRest && order.pending_quantity() > 0) {
+    // A halt mid-sweep cancels the remainder rather than resting it crossed.
+    if (params.allowRest && !halted && order.pending_quantity() > 0) {
         restOrderInternal(orderId);
     } else {
+        if (order.remaining_quantity() > 0) {
+            report(order, ExecType::CANCEL, halted ? ExecReason::HALTED : ExecReason::UNFILLED);
+        }
         releaseOrderInternal(orderId);
     }
 }
 
-void OrderBook::emitTrade(const TradeEvent& event) const {
-    if (trade_listener_) {
-        trade_listener_(event);
-    }
-
-    for (auto it = observers_.begin(); it != observers_.end();) {
-        if (auto obs = it->lock()) {
-            obs->onTrade(*this, event);
-            ++it;
-        } else {
-            it = observers_.erase(it);
-        }
-    }
+void OrderBook::emitTrades(TradeBatch trades) const {
+    sinks_(trades);
 }
 
 const Order* OrderBook::bestBid() const {
@@ -445,10 +581,10 @@ void OrderBook::printBook() const {
     std::vector<std::pair<Price, const PriceLevel*>> asks;
     std::vector<std::pair<Price, const PriceLevel*>> bids;
 
-    asks_.forEachAscending([&](Price price, const PriceLevel& level) {
+    asks_.forEachLevel([&](Price price, const PriceLevel& level) {
         asks.emplace_back(price, &level);
     });
-    bids_.forEachAscending([&](Price price, const PriceLevel& level) {
+    bids_.forEachLevel([&](Price price, const PriceLevel& level) {
         bids.emplace_back(price, &level);
     });
 
@@ -526,37 +662,21 @@ void OrderBook::printBook() const {
     LOG_INFO("{}", out.str());
 }
 
-void OrderBook::tradeWorker() {
-    const uint32_t mask = static_cast<uint32_t>(trade_ring_.size() - 1);
-    while (trade_running_.load(std::memory_order_acquire) ||
-           trade_tail_.load(std::memory_order_acquire) != trade_head_.load(std::memory_order_acquire)) {
-        const uint32_t tail = trade_tail_.load(std::memory_order_acquire);
-        const uint32_t head = trade_head_.load(std::memory_order_acquire);
-        if (tail == head) {
-            std::this_thread::yield();
-            continue;
-        }
-        TradeEvent event = trade_ring_[tail & mask];
-        trade_tail_.store(tail + 1, std::memory_order_release);
-        emitTrade(event);
-    }
-}
-
 void OrderBook::dispatchTrade(const TradeEvent& event) {
     last_trade_price_.store(event.price, std::memory_order_relaxed);
     last_trade_qty_.store(event.quantity, std::memory_order_relaxed);
-    const uint32_t mask = static_cast<uint32_t>(trade_ring_.size() - 1);
-    while (true) {
-        const uint32_t tail = trade_tail_.load(std::memory_order_acquire);
-        const uint32_t head = trade_head_.load(std::memory_order_relaxed);
-        if (head - tail >= trade_ring_.size()) {
-            trade_tail_.store(tail + 1, std::memory_order_release);
-            continue;
-        }
-        trade_ring_[head & mask] = event;
-        trade_head_.store(head + 1, std::memory_order_release);
-        break;
+    if (LIKELY(publisher_ != nullptr)) {
+        publisher_->publish(*this, event);
+        return;
     }
+    emitTrades(TradeBatch(&event, 1));
+}
+
+void OrderBook::setTradePublisher(TradePublisher* publisher) {
+    if (publisher != nullptr && dispatch_ == TradePublishMode::INLINE) {
+        throw std::runtime_error("An inline order book does not take a trade publisher");
+    }
+    publisher_ = publisher;
 }
 
 void OrderBook::setInstrumentToken(InstrumentToken token) {
@@ -567,23 +687,26 @@ InstrumentToken OrderBook::instrument_token() const {
     return instrument_token_;
 }
 
-void OrderBook::addObserver(const std::shared_ptr<OrderBookObserver>& observer) {
-    if (!observer) {
-        return;
-    }
-    observers_.push_back(observer);
+void OrderBook::addTradeSink(TradeSink sink) {
+    sinks_.add(sink);
+}
+
+void OrderBook::clearTradeSinks() {
+    sinks_.clear();
 }
 
 void OrderBook::snapshot(std::vector<std::pair<Price, Qty>>& bids, std::vector<std::pair<Price, Qty>>& asks) const {
     bids.clear();
     asks.clear();
 
-    bids_.forEachAscending([&](Price price, const PriceLevel& level) {
+    bids_.forEachLevel([&](Price price, const PriceLevel& level) {
         bids.emplace_back(price, level.openQty());
     });
-    asks_.forEachAscending([&](Price price, const PriceLevel& level) {
+    asks_.forEachLevel([&](Price price, const PriceLevel& level) {
         asks.emplace_back(price, level.openQty());
     });
+    std::sort(bids.begin(), bids.end(), [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+    std::sort(asks.begin(), asks.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
 }
 
 Price OrderBook::last_trade_price() const {
@@ -594,9 +717,14 @@ Qty OrderBook::last_trade_quantity() const {
     return last_trade_qty_.load(std::memory_order_relaxed);
 }
 
-void OrderBook::bindTradeThreadToCores(const std::vector<int>& cores) {
-    if (cores.empty() || !trade_thread_.joinable()) {
-        return;
-    }
-    cpu::setThreadAffinity(trade_thread_, cores);
+void OrderBook::setPriceBands(const PriceBandSettings& settings) {
+    bands_ = PriceBandGuard(settings);
+}
+
+TradingState OrderBook::tradingState() const {
+    return bands_.state();
+}
+
+uint64_t OrderBook::bandRejects() const {
+    return band_rejects_;
 }
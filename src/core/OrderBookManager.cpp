@@ -60,8 +60,8 @@ Qty OrderBookManager::totalOpenQtyAt(InstrumentToken token, Side side, Price pri
     return 0;
 }
 
-void OrderBookManager::setTradeListener(InstrumentToken token, OrderBook::TradeListener listener) {
-    ensureBook(token).setTradeListener(std::move(listener));
+void OrderBookManager::addTradeSink(InstrumentToken token, TradeSink sink) {
+    ensureBook(token).addTradeSink(sink);
 }
 
 OrderBook* OrderBookManager::findBook(InstrumentToken token) {
@@ -0,0 +1,61 @@
+#include "core/PriceBands.h"
+
+#include <algorithm>
+
+namespace {
+constexpr uint64_t kBpsDenominator = 10'000;
+constexpr int64_t kNanosPerMilli = 1'000'000;
+}  // namespace
+
+PriceBandGuard::PriceBandGuard(const PriceBandSettings& settings)
+    : settings_(settings),
+      active_(settings.static_band_bps != 0 || settings.dynamic_band_bps != 0 ||
+              settings.volatility_move_bps != 0),
+      static_reference_(settings.reference_price) {
+    recomputeWindow();
+}
+
+bool PriceBandGuard::onTrade(Price price, int64_t now_ns) {
+    last_price_ = price;
+    if (static_reference_ == 0) {
+        static_reference_ = price;
+    }
+    recomputeWindow();
+
+    if (settings_.volatility_move_bps == 0) {
+        return false;
+    }
+    const int64_t window_ns = static_cast<int64_t>(settings_.volatility_window_ms) * kNanosPerMilli;
+    if (anchor_price_ == 0 || now_ns - anchor_ns_ >= window_ns) {
+        anchor_price_ = price;
+        anchor_ns_ = now_ns;
+        return false;
+    }
+
+    const Price move = (price > anchor_price_) ? price - anchor_price_ : anchor_price_ - price;
+    if (move <= offset(anchor_price_, settings_.volatility_move_bps)) {
+        return false;
+    }
+    state_ = TradingState::Halted;
+    halt_until_ns_ = now_ns + static_cast<int64_t>(settings_.halt_ms) * kNanosPerMilli;
+    return true;
+}
+
+void PriceBandGuard::recomputeWindow() {
+    low_ = 0;
+    high_ = std::numeric_limits<Price>::max();
+    if (settings_.static_band_bps != 0 && static_reference_ != 0) {
+        const Price width = offset(static_reference_, settings_.static_band_bps);
+        low_ = std::max(low_, static_reference_ > width ? static_reference_ - width : 0);
+        high_ = std::min(high_, static_reference_ + width);
+    }
+    if (settings_.dynamic_band_bps != 0 && last_price_ != 0) {
+        const Price width = offset(last_price_, settings_.dynamic_band_bps);
+        low_ = std::max(low_, last_price_ > width ? last_price_ - width : 0);
+        high_ = std::min(high_, last_price_ + width);
+    }
+}
+
+Price PriceBandGuard::offset(Price reference, uint32_t bps) {
+    return reference / kBpsDenominator * bps + (reference % kBpsDenominator) * bps / kBpsDenominator;
+}
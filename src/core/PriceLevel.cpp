@@ -79,6 +79,17 @@ void PriceLevel::decOpenQty(Qty qty) {
     }
 }
 
+void PriceLevel::reserve(size_t nodes) {
+    if (nodes <= nodes_.size()) {
+        return;
+    }
+    const size_t first = nodes_.size();
+    nodes_.resize(nodes);
+    for (size_t slot = nodes; slot-- > first;) {
+        releaseSlot(slot);
+    }
+}
+
 void PriceLevel::clear() {
     if (!nodes_.empty()) {
         resetFreeList();
@@ -17,9 +17,12 @@ PriceRingBuffer::PriceRingBuffer(Side side)
 }
 
 PriceLevel* PriceRingBuffer::findLevel(Price price) {
-    if (UNLIKELY(!base_initialized_ || !priceInWindow(price))) {
+    if (UNLIKELY(!base_initialized_)) {
         return nullptr;
     }
+    if (UNLIKELY(!priceInWindow(price))) {
+        return overflow_.empty() ? nullptr : overflow_.find(price);
+    }
     const size_t idx = slotIndex(price);
     auto& slot = slots_[idx];
     if (UNLIKELY(!slot.active || slot.price != price)) {
@@ -29,9 +32,12 @@ PriceLevel* PriceRingBuffer::findLevel(Price price) {
 }
 
 const PriceLevel* PriceRingBuffer::findLevel(Price price) const {
-    if (UNLIKELY(!base_initialized_ || !priceInWindow(price))) {
+    if (UNLIKELY(!base_initialized_)) {
         return nullptr;
     }
+    if (UNLIKELY(!priceInWindow(price))) {
+        return overflow_.empty() ? nullptr : overflow_.find(price);
+    }
     const size_t idx = slotIndex(price);
     const auto& slot = slots_[idx];
     if (UNLIKELY(!slot.active || slot.price != price)) {
@@ -46,13 +52,18 @@ PriceLevel* PriceRingBuffer::ensureLevel(Price price) {
     }
 
     if (UNLIKELY(!priceInWindow(price))) {
+        // Follow the touch when the price becomes the new best; park anything
+        // worse in the overflow tree instead of dragging the window to it.
+        if (!improvesBest(price)) {
+            if (PriceLevel* parked = overflow_.find(price)) {
+                return parked;
+            }
+            overflow_.insert(price, PriceLevel{});
+            return overflow_.find(price);
+        }
         rebalanceWindow(price);
     }
 
-    if (UNLIKELY(!priceInWindow(price))) {
-        return nullptr;
-    }
-
     const size_t idx = slotIndex(price);
     auto& slot = slots_[idx];
     if (LIKELY(!slot.active)) {
@@ -72,6 +83,10 @@ PriceLevel* PriceRingBuffer::ensureLevel(Price price) {
 }
 
 void PriceRingBuffer::eraseLevel(Price price) {
+    if (UNLIKELY(base_initialized_ && !priceInWindow(price))) {
+        overflow_.erase(price);
+        return;
+    }
     auto* level = findLevel(price);
     if (!level) {
         return;
@@ -87,6 +102,17 @@ void PriceRingBuffer::eraseLevel(Price price) {
         best_slot_ = kInvalidSlot;
         recomputeBestInternal();
     }
+    if (UNLIKELY(active_levels_ == 0 && !overflow_.empty())) {
+        Price next_best = 0;
+        overflowBest(next_best);
+        rebalanceWindow(next_best);
+    }
+}
+
+void PriceRingBuffer::reserveLevels(size_t orders) {
+    for (auto& slot : slots_) {
+        slot.level.reserve(orders);
+    }
 }
 
 void PriceRingBuffer::markLevelNonEmpty(Price price) {
@@ -103,8 +129,8 @@ PriceLevel* PriceRingBuffer::bestLevel() {
 }
 
 PriceLevel* PriceRingBuffer::bestLevel(Price& out_price) {
-    if (!ensureBestSlot()) {
-        return nullptr;
+    if (UNLIKELY(!ensureBestSlot())) {
+        return overflowBest(out_price);
     }
     out_price = best_price_;
     return &slots_[best_slot_].level;
@@ -116,8 +142,8 @@ const PriceLevel* PriceRingBuffer::bestLevel() const {
 }
 
 const PriceLevel* PriceRingBuffer::bestLevel(Price& out_price) const {
-    if (!ensureBestSlot()) {
-        return nullptr;
+    if (UNLIKELY(!ensureBestSlot())) {
+        return overflowBest(out_price);
     }
     out_price = best_price_;
     return &slots_[best_slot_].level;
@@ -172,89 +198,102 @@ Price PriceRingBuffer::clampBase(Price candidate) const {
     return (candidate > max_base) ? max_base : candidate;
 }
 
+bool PriceRingBuffer::improvesBest(Price price) const {
+    Price current = 0;
+    if (!bestLevel(current)) {
+        return true;
+    }
+    return (side_ == Side::BUY) ? price > current : price < current;
+}
+
+PriceLevel* PriceRingBuffer::overflowBest(Price& out_price) const {
+    if (overflow_.empty()) {
+        return nullptr;
+    }
+    return (side_ == Side::BUY) ? overflow_.findMax(&out_price) : overflow_.findMin(&out_price);
+}
+
 void PriceRingBuffer::rebalanceWindow(Price focus_price) {
     if (UNLIKELY(!base_initialized_)) {
         initializeBase(focus_price);
         return;
     }
 
-    ensureBestSlot();
-    Price reference_price = focus_price;
-    if (best_slot_ != kInvalidSlot) {
-        reference_price = best_price_;
+    const Price new_base = clampBase((focus_price > kHalfCapacity) ? focus_price - kHalfCapacity : 0);
+    if (new_base != base_price_) {
+        shiftWindow(new_base);
     }
 
-    Price new_base = (reference_price > kHalfCapacity)
-        ? reference_price - kHalfCapacity
-        : 0;
-    new_base = clampBase(new_base);
-
-    const Price span_minus_one = static_cast<Price>(kCapacity - 1);
-
-    auto focusAnchoredBase = [&](Price price) -> Price {
-        if (price <= span_minus_one) {
-            return 0;
-        }
-        return clampBase(price - span_minus_one);
-    };
-
-    if (focus_price < new_base) {
-        const Price diff = new_base - focus_price;
-        if (diff > span_minus_one) {
-            new_base = focusAnchoredBase(focus_price);
-        } else {
-            new_base -= diff;
-        }
-    } else {
-        const Price upper_inclusive = new_base + span_minus_one;
-        if (focus_price > upper_inclusive) {
-            const Price diff = focus_price - upper_inclusive;
-            if (diff > span_minus_one) {
-                new_base = focusAnchoredBase(focus_price);
-            } else {
-                new_base += diff;
-            }
+    // Pull parked levels that the new window now covers back into the ring.
+    const Price upper_inclusive = base_price_ + static_cast<Price>(kCapacity - 1);
+    Price parked_price = 0;
+    while (PriceLevel* parked = overflow_.lowerBound(base_price_, &parked_price)) {
+        if (parked_price > upper_inclusive) {
+            break;
         }
+        auto& slot = slots_[slotIndex(parked_price)];
+        slot.level = std::move(*parked);
+        slot.price = parked_price;
+        slot.active = true;
+        ++active_levels_;
+        overflow_.erase(parked_price);
     }
 
-    new_base = clampBase(new_base);
-    const Price new_upper_inclusive = new_base + span_minus_one;
-
-    if (UNLIKELY(new_base == base_price_ && priceInWindow(focus_price))) {
-        return;
-    }
+    best_slot_ = kInvalidSlot;
+    recomputeBestInternal();
+}
 
-    std::array<Slot, kCapacity> new_slots;
-    for (size_t i = 0; i < kCapacity; ++i) {
-        new_slots[i].price = new_base + static_cast<Price>(i);
-        new_slots[i].active = false;
-    }
+void PriceRingBuffer::shiftWindow(Price new_base) {
+    const Price new_upper_inclusive = new_base + static_cast<Price>(kCapacity - 1);
 
-    size_t new_active_count = 0;
+    // Park active levels that leave the window; nothing is dropped.
     for (auto& slot : slots_) {
         if (!slot.active) {
             continue;
         }
-        const Price slot_price = slot.price;
-        if (slot_price < new_base || slot_price > new_upper_inclusive) {
+        if (slot.price < new_base || slot.price > new_upper_inclusive) {
+            overflow_.insert(slot.price, std::move(slot.level));
             slot.level.clear();
             slot.active = false;
-            continue;
+            --active_levels_;
         }
-        const size_t new_idx = static_cast<size_t>(slot_price - new_base);
-        auto& dest = new_slots[new_idx];
-        dest.level = std::move(slot.level);
-        dest.price = slot_price;
+    }
+
+    // Slot index equals price - base, so survivors shift in place; walk in
+    // the direction that never overwrites an unread slot.
+    auto relocate = [&](size_t idx) {
+        auto& slot = slots_[idx];
+        if (!slot.active) {
+            return;
+        }
+        const size_t dest_idx = static_cast<size_t>(slot.price - new_base);
+        if (dest_idx == idx) {
+            return;
+        }
+        auto& dest = slots_[dest_idx];
+        // Swapped, not moved, so the vacated slot keeps dest's node pool.
+        std::swap(dest.level, slot.level);
+        dest.price = slot.price;
         dest.active = true;
-        ++new_active_count;
+        slot.level.clear();
+        slot.active = false;
+    };
+    if (new_base > base_price_) {
+        for (size_t idx = 0; idx < kCapacity; ++idx) {
+            relocate(idx);
+        }
+    } else {
+        for (size_t idx = kCapacity; idx > 0; --idx) {
+            relocate(idx - 1);
+        }
     }
 
-    slots_ = std::move(new_slots);
+    for (size_t idx = 0; idx < kCapacity; ++idx) {
+        if (!slots_[idx].active) {
+            slots_[idx].price = new_base + static_cast<Price>(idx);
+        }
+    }
     base_price_ = new_base;
-    active_levels_ = new_active_count;
-    best_slot_ = kInvalidSlot;
-    best_price_ = (side_ == Side::BUY) ? 0 : std::numeric_limits<Price>::max();
-    recomputeBestInternal();
 }
 
 void PriceRingBuffer::updateBestCandidate(size_t slotIdx) {
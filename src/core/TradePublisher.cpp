@@ -0,0 +1,243 @@
+#include "core/TradePublisher.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include "core/OrderBook.h"
+#include "utils/Affinity.h"
+#include "utils/Counters.h"
+
+TradePublisher::TradePublisher() : TradePublisher(Options{}) {}
+
+TradePublisher::TradePublisher(const Options& options) : options_(options), fanout_{this} {
+    addConsumer("books", fanout_, options_.core);
+}
+
+TradePublisher::~TradePublisher() {
+    if (ring_) {
+        // Lossless teardown: whatever spilled still goes out before the threads stop.
+        uint32_t spins = 0;
+        while (flush() > 0) {
+            if (++spins % 1000 == 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    running_.store(false, std::memory_order_release);
+    for (auto& consumer : consumers_) {
+        consumer->wait.notify();
+        if (consumer->thread.joinable()) {
+            consumer->thread.join();
+        }
+    }
+}
+
+void TradePublisher::ensureNotStarted(const char* what) const {
+    if (ring_) {
+        throw std::runtime_error(std::string(what) + " must happen before the trade publisher starts");
+    }
+}
+
+void TradePublisher::attach(InstrumentToken token, OrderBook& book) {
+    track(token, book);
+    book.setTradePublisher(this);
+}
+
+void TradePublisher::track(InstrumentToken token, const OrderBook& book) {
+    // books_ belongs to consumer 0, which may already be running.
+    std::lock_guard<std::mutex> lock(tracked_mutex_);
+    tracked_.emplace_back(token, &book);
+    tracked_pending_.store(true, std::memory_order_release);
+}
+
+void TradePublisher::mergeTracked() {
+    std::lock_guard<std::mutex> lock(tracked_mutex_);
+    for (const auto& [token, book] : tracked_) {
+        books_[token] = book;
+    }
+    tracked_.clear();
+    tracked_pending_.store(false, std::memory_order_relaxed);
+}
+
+std::size_t TradePublisher::addConsumer(std::string name, TradeSink sink, int core) {
+    ensureNotStarted("Adding a trade consumer");
+    consumers_.push_back(std::make_unique<Consumer>(std::move(name), sink, core, options_.wait));
+    return consumers_.size() - 1;
+}
+
+void TradePublisher::start() {
+    if (ring_ || options_.mode == Mode::INLINE) {
+        return;
+    }
+    ring_ = std::make_unique<SequencedRing<TradeEvent>>(options_.capacity, consumers_.size());
+    for (std::size_t idx = 0; idx < consumers_.size(); ++idx) {
+        consumers_[idx]->thread = std::thread([this, idx] { run(idx); });
+    }
+}
+
+void TradePublisher::publish(const OrderBook& book, const TradeEvent& event) {
+    stats::bump(published_);
+    if (options_.mode == Mode::INLINE) {
+        const TradeBatch trades(&event, 1);
+        book.emitTrades(trades);
+        stats::bump(consumers_.front()->consumed);
+        for (std::size_t idx = 1; idx < consumers_.size(); ++idx) {
+            consumers_[idx]->sink(trades);
+            stats::bump(consumers_[idx]->consumed);
+        }
+        return;
+    }
+    if (UNLIKELY(!ring_)) {
+        start();
+    }
+    enqueue(event);
+}
+
+void TradePublisher::enqueue(const TradeEvent& event) {
+    // Once anything has spilled, later events queue behind it to keep sequence order.
+    if (UNLIKELY(!spill_.empty()) && flush() > 0) {
+        spill_.push_back(event);
+        stats::bump(spilled_);
+        return;
+    }
+    if (LIKELY(ring_->tryPublish(event))) {
+        notifyConsumers();
+        return;
+    }
+    switch (options_.overflow) {
+        case Overflow::BLOCK: {
+            stats::bump(stalls_);
+            uint32_t spins = 0;
+            while (!ring_->tryPublish(event)) {
+                if (++spins % 1000 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            notifyConsumers();
+            return;
+        }
+        case Overflow::DROP:
+            stats::bump(dropped_);
+            return;
+        case Overflow::SPILL:
+            spill_.push_back(event);
+            stats::bump(spilled_);
+            return;
+    }
+}
+
+std::size_t TradePublisher::flush() {
+    if (LIKELY(spill_.empty())) {
+        return 0;
+    }
+    std::size_t moved = 0;
+    while (!spill_.empty() && ring_->tryPublish(spill_.front())) {
+        spill_.pop_front();
+        ++moved;
+    }
+    if (moved > 0) {
+        notifyConsumers();
+    }
+    return spill_.size();
+}
+
+bool TradePublisher::drained() const {
+    if (!ring_) {
+        return true;
+    }
+    if (!spill_.empty()) {
+        return false;
+    }
+    const uint64_t published = ring_->published();
+    for (std::size_t idx = 0; idx < consumers_.size(); ++idx) {
+        if (ring_->cursor(idx) != published) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TradePublisher::notifyConsumers() {
+    for (auto& consumer : consumers_) {
+        consumer->wait.notify();
+    }
+}
+
+std::size_t TradePublisher::drain(std::size_t index) {
+    Consumer& consumer = *consumers_[index];
+    const uint64_t lag = ring_->lag(index);
+    if (lag > consumer.max_lag.load(std::memory_order_relaxed)) {
+        consumer.max_lag.store(lag, std::memory_order_relaxed);
+    }
+    std::size_t handled = 0;
+    while (handled < kMaxBurst) {
+        const TradeBatch trades = ring_->peek(index, kMaxBurst - handled);
+        if (trades.empty()) {
+            break;
+        }
+        consumer.sink(trades);
+        ring_->release(index, trades.size());
+        handled += trades.size();
+    }
+    stats::bump(consumer.consumed, handled);
+    return handled;
+}
+
+void TradePublisher::BookFanout::onTrades(TradeBatch trades) const {
+    if (UNLIKELY(owner->tracked_pending_.load(std::memory_order_acquire))) {
+        owner->mergeTracked();
+    }
+    std::size_t begin = 0;
+    while (begin < trades.size()) {
+        const InstrumentToken token = trades[begin].instrument;
+        std::size_t end = begin + 1;
+        while (end < trades.size() && trades[end].instrument == token) {
+            ++end;
+        }
+        const auto it = owner->books_.find(token);
+        if (LIKELY(it != owner->books_.end())) {
+            it->second->emitTrades(trades.subspan(begin, end - begin));
+        }
+        begin = end;
+    }
+}
+
+void TradePublisher::run(std::size_t index) {
+    Consumer& consumer = *consumers_[index];
+    if (consumer.core >= 0) {
+        cpu::setCurrentThreadAffinity(std::vector<int>{consumer.core});
+    } else if (!options_.cpus.empty()) {
+        cpu::setCurrentThreadAffinity(options_.cpus);
+    }
+    while (true) {
+        if (drain(index) > 0) {
+            consumer.wait.reset();
+            continue;
+        }
+        if (!running_.load(std::memory_order_acquire)) {
+            // Anything published before stop is visible now; drain it and exit.
+            while (drain(index) > 0) {
+            }
+            return;
+        }
+        consumer.wait.idle([this, index] {
+            return !running_.load(std::memory_order_acquire) || ring_->lag(index) > 0;
+        });
+    }
+}
+
+std::vector<TradePublisher::ConsumerStats> TradePublisher::consumerStats() const {
+    std::vector<ConsumerStats> stats;
+    stats.reserve(consumers_.size());
+    for (std::size_t idx = 0; idx < consumers_.size(); ++idx) {
+        const Consumer& consumer = *consumers_[idx];
+        ConsumerStats entry;
+        entry.name = consumer.name;
+        entry.consumed = consumer.consumed.load(std::memory_order_relaxed);
+        entry.lag = ring_ ? ring_->lag(idx) : 0;
+        entry.max_lag = consumer.max_lag.load(std::memory_order_relaxed);
+        entry.waits = consumer.wait.counters();
+        stats.push_back(std::move(entry));
+    }
+    return stats;
+}
@@ -0,0 +1,257 @@
+#include "engine/EngineShard.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <utility>
+
+#include "core/OrderBuilder.h"
+#include "snapshot/SnapshotPublisher.h"
+#include "utils/Affinity.h"
+#include "utils/LogMacros.h"
+
+namespace engine {
+
+EngineShard::EngineShard(std::size_t id, int core, std::size_t queue_capacity, const WaitSettings& wait,
+                         const TradePublisher::Options& trade)
+    : id_(id),
+      core_(core),
+      queue_capacity_(queue_capacity),
+      trade_publisher_(trade),
+      wait_(wait) {}
+
+EngineShard::Instrument EngineShard::makeInstrument(InstrumentToken token, std::unique_ptr<OrderBook> book,
+                                                    bool multi_producer) {
+    Instrument instrument;
+    instrument.token = token;
+    instrument.queue = std::make_unique<Queue>(queue_capacity_, multi_producer);
+    instrument.book = std::move(book);
+    instrument.book->setInstrumentToken(token);
+    instrument.load = std::make_unique<InstrumentLoad>();
+    instrument.load->token = token;
+    instrument.load->queue = instrument.queue.get();
+    instrument.load->shard.store(id_, std::memory_order_relaxed);
+    instrument.queue->setConsumer(&wait_);
+    if (publisher_) {
+        instrument.snapshot = publisher_->regionFor(token);
+    }
+    return instrument;
+}
+
+OrderBook& EngineShard::addInstrument(InstrumentToken token, std::unique_ptr<OrderBook> book, bool multi_producer) {
+    Instrument instrument = makeInstrument(token, std::move(book), multi_producer);
+    trade_publisher_.attach(token, *instrument.book);
+    instrument.book->setExecReportPublisher(exec_reports_.get());
+    instruments_.push_back(std::move(instrument));
+    return *instruments_.back().book;
+}
+
+InstrumentLoad& EngineShard::onboard(InstrumentToken token, std::unique_ptr<OrderBook> book, bool multi_producer,
+                                     const Prepare& prepare) {
+    Instrument instrument = makeInstrument(token, std::move(book), multi_producer);
+    trade_publisher_.track(token, *instrument.book);
+    if (prepare) {
+        prepare(*instrument.book, *instrument.queue);
+    }
+    InstrumentLoad& load = *instrument.load;
+    Command command;
+    command.kind = Command::Kind::ONBOARD;
+    command.token = token;
+    command.instrument = std::move(instrument);
+    post(std::move(command));
+    return load;
+}
+
+void EngineShard::enableExecReports(const ExecReportPublisher::Options& options,
+                                    ExecReportPublisher::Transport transport) {
+    ExecReportPublisher::Options stream = options;
+    stream.stream = static_cast<uint32_t>(id_);
+    exec_reports_ = std::make_unique<ExecReportPublisher>(stream, std::move(transport));
+    for (auto& instrument : instruments_) {
+        instrument.book->setExecReportPublisher(exec_reports_.get());
+    }
+}
+
+void EngineShard::setSnapshotPublisher(SnapshotPublisher* publisher) {
+    publisher_ = publisher;
+    for (auto& instrument : instruments_) {
+        instrument.snapshot = publisher_ ? publisher_->regionFor(instrument.token) : nullptr;
+    }
+}
+
+EngineShard::Queue* EngineShard::queueFor(InstrumentToken token) {
+    for (auto& instrument : instruments_) {
+        if (instrument.token == token) {
+            return instrument.queue.get();
+        }
+    }
+    return nullptr;
+}
+
+OrderBook* EngineShard::bookFor(InstrumentToken token) {
+    for (auto& instrument : instruments_) {
+        if (instrument.token == token) {
+            return instrument.book.get();
+        }
+    }
+    return nullptr;
+}
+
+void EngineShard::run() {
+    if (core_ >= 0) {
+        cpu::setCurrentThreadAffinity(std::vector<int>{core_});
+    }
+    trade_publisher_.start();
+    if (exec_reports_) {
+        exec_reports_->start();
+    }
+    while (running_.load(std::memory_order_relaxed)) {
+        if (UNLIKELY(control_pending_.load(std::memory_order_acquire))) {
+            applyControl(false);
+        }
+        std::size_t handled = 0;
+        for (auto& instrument : instruments_) {
+            handled += drain(instrument);
+        }
+        if (handled == 0) {
+            // Quiet input is the moment to replay trades spilled while consumers lagged.
+            trade_publisher_.flush();
+            wait_.idle([this] { return hasInput(); });
+            continue;
+        }
+        wait_.reset();
+        processed_.fetch_add(handled, std::memory_order_relaxed);
+    }
+    // Instruments already handed over still land here; new releases are refused.
+    applyControl(true);
+}
+
+void EngineShard::stop() {
+    running_.store(false, std::memory_order_relaxed);
+    wait_.notify();
+}
+
+bool EngineShard::hasInput() const {
+    if (!running_.load(std::memory_order_relaxed) || control_pending_.load(std::memory_order_acquire)) {
+        return true;
+    }
+    for (const auto& instrument : instruments_) {
+        if (instrument.queue->read_available() > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::size_t EngineShard::drain(Instrument& instrument) {
+    // Orders are built straight from the queue slots.
+    const std::size_t handled = instrument.queue->consume(kMaxBurst, [&](const ingress::WireOrder& inbound) {
+        OrderBuilder builder;
+        builder.setOrderId(inbound.order_id)
+            .setInstrumentToken(inbound.instrument)
+            .setSide(inbound.side)
+            .setPrice(inbound.price)
+            .setQuantity(inbound.quantity)
+            .setOrderType(inbound.type)
+            .setSequence(inbound.sequence)
+            .setTimestamp(std::chrono::high_resolution_clock::now());
+        if (inbound.display > 0) {
+            builder.setDisplayQuantity(inbound.display);
+        }
+        instrument.book->addOrder(builder.build());
+    });
+    instrument.load->processed.fetch_add(handled, std::memory_order_relaxed);
+    if (handled > 0 && publisher_) {
+        publisher_->maybePublish(instrument.snapshot, *instrument.book);
+    }
+    return handled;
+}
+
+void EngineShard::requestRelease(InstrumentToken token, EngineShard& target) {
+    Command command;
+    command.kind = Command::Kind::RELEASE;
+    command.token = token;
+    command.target = &target;
+    post(std::move(command));
+}
+
+void EngineShard::post(Command command) {
+    {
+        std::lock_guard<std::mutex> lock(control_mutex_);
+        control_.push_back(std::move(command));
+        control_pending_.store(true, std::memory_order_release);
+    }
+    wait_.notify();
+}
+
+void EngineShard::applyControl(bool stopping) {
+    std::vector<Command> commands;
+    {
+        std::lock_guard<std::mutex> lock(control_mutex_);
+        commands.swap(control_);
+        control_pending_.store(false, std::memory_order_relaxed);
+    }
+    for (auto& command : commands) {
+        if (command.kind != Command::Kind::RELEASE) {
+            // Even while stopping: the book is already this shard's to keep.
+            adopt(std::move(command.instrument), command.kind == Command::Kind::ONBOARD);
+        } else if (stopping || command.target == this) {
+            migration_aborts_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            release(command.token, *command.target);
+        }
+    }
+}
+
+void EngineShard::release(InstrumentToken token, EngineShard& target) {
+    auto it = std::find_if(instruments_.begin(), instruments_.end(),
+                           [token](const Instrument& instrument) { return instrument.token == token; });
+    if (it == instruments_.end()) {
+        migration_aborts_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // Trades and reports this book already produced must leave before it
+    // trades on another shard's publishers, or they could overtake each other.
+    const auto start = std::chrono::steady_clock::now();
+    uint32_t spins = 0;
+    while (trade_publisher_.flush() > 0 || !trade_publisher_.drained() ||
+           (exec_reports_ && !exec_reports_->drained())) {
+        if (++spins % 1000 == 0) {
+            std::this_thread::yield();
+            if (std::chrono::steady_clock::now() - start > migration_pause_) {
+                LOG_WARN("Shard {} kept instrument {}: trades not drained within {}us", id_, token,
+                         migration_pause_.count());
+                migration_aborts_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+    const auto pause = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    if (pause > max_migration_pause_ns_.load(std::memory_order_relaxed)) {
+        max_migration_pause_ns_.store(pause, std::memory_order_relaxed);
+    }
+
+    Command command;
+    command.kind = Command::Kind::ADOPT;
+    command.token = token;
+    command.instrument = std::move(*it);
+    instruments_.erase(it);
+    migrated_out_.fetch_add(1, std::memory_order_relaxed);
+    target.post(std::move(command));
+}
+
+void EngineShard::adopt(Instrument instrument, bool onboarded) {
+    instrument.book->setTradePublisher(&trade_publisher_);
+    instrument.book->setExecReportPublisher(exec_reports_.get());
+    // From here on producers wake this shard; whatever they pushed meanwhile
+    // is picked up by the next sweep.
+    instrument.queue->setConsumer(&wait_);
+    instrument.load->shard.store(id_, std::memory_order_release);
+    LOG_INFO("Shard {} {} instrument {} ({} queued)", id_, onboarded ? "onboarded" : "adopted", instrument.token,
+             instrument.queue->read_available());
+    instruments_.push_back(std::move(instrument));
+    (onboarded ? onboarded_ : migrated_in_).fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace engine
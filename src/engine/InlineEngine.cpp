@@ -0,0 +1,65 @@
+#include "engine/InlineEngine.h"
+
+#include <stdexcept>
+
+#include "core/OrderBuilder.h"
+
+namespace engine {
+
+InlineEngine::InlineEngine(const AppConfig& config) : config_(config) {}
+
+void InlineEngine::addTradeSink(TradeSink sink) {
+    if (!books_.empty()) {
+        throw std::runtime_error("Trade sinks must be added before the first order");
+    }
+    sinks_.push_back(sink);
+}
+
+bool InlineEngine::handle(std::string_view payload, HrtTime timestamp) {
+    ingress::WireOrder order{};
+    if (!ingress::parseWireOrder(payload, order)) {
+        return false;
+    }
+    handle(order, timestamp);
+    return true;
+}
+
+void InlineEngine::handle(const ingress::WireOrder& order, HrtTime timestamp) {
+    // Built the way EngineShard::drain builds it, with the caller's clock.
+    OrderBuilder builder;
+    builder.setOrderId(order.order_id)
+        .setInstrumentToken(order.instrument)
+        .setSide(order.side)
+        .setPrice(order.price)
+        .setQuantity(order.quantity)
+        .setOrderType(order.type)
+        .setSequence(++sequence_)
+        .setTimestamp(timestamp);
+    if (order.display > 0) {
+        builder.setDisplayQuantity(order.display);
+    }
+    bookFor(order.instrument).addOrder(builder.build());
+}
+
+OrderBook* InlineEngine::book(InstrumentToken token) {
+    const auto it = books_.find(token);
+    return it != books_.end() ? it->second.get() : nullptr;
+}
+
+OrderBook& InlineEngine::bookFor(InstrumentToken token) {
+    auto [it, inserted] = books_.try_emplace(token);
+    if (inserted) {
+        it->second = std::make_unique<OrderBook>(config_.bookBackendFor(token), TradePublishMode::INLINE);
+        it->second->setInstrumentToken(token);
+        it->second->setPriceBands(config_.priceBandsFor(token));
+        if (config_.warmup.enabled) {
+            it->second->reserve(config_.warmup.expected_orders, config_.warmup.level_orders);
+        }
+        for (const TradeSink& sink : sinks_) {
+            it->second->addTradeSink(sink);
+        }
+    }
+    return *it->second;
+}
+
+}  // namespace engine
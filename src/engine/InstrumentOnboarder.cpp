@@ -0,0 +1,87 @@
+#include "engine/InstrumentOnboarder.h"
+
+#include <chrono>
+#include <memory>
+#include <utility>
+
+#include "engine/ShardBalancer.h"
+#include "utils/Counters.h"
+#include "utils/LogMacros.h"
+#include "utils/Numa.h"
+
+namespace engine {
+
+InstrumentOnboarder::InstrumentOnboarder(std::vector<EngineShard*> shards, ingress::OnboardingChannel& channel,
+                                         const AppConfig& config, ShardAssignmentPolicy& assignment,
+                                         SnapshotPublisher* snapshots, bool multi_producer)
+    : shards_(std::move(shards)),
+      channel_(channel),
+      config_(config),
+      assignment_(assignment),
+      snapshots_(snapshots),
+      multi_producer_(multi_producer) {}
+
+void InstrumentOnboarder::run() {
+    std::vector<ingress::OnboardingChannel::Request> requests;
+    while (channel_.waitRequests(requests, std::chrono::milliseconds(100))) {
+        for (const auto& request : requests) {
+            handle(request);
+        }
+        requests.clear();
+    }
+}
+
+void InstrumentOnboarder::stop() {
+    channel_.close();
+}
+
+void InstrumentOnboarder::handle(const ingress::OnboardingChannel::Request& request) {
+    auto it = routes_.find(request.token);
+    if (it == routes_.end()) {
+        it = routes_.emplace(request.token, create(request.token)).first;
+    }
+    channel_.reply(request.dispatcher, {request.token, it->second.queue});
+}
+
+InstrumentOnboarder::Route InstrumentOnboarder::create(InstrumentToken token) {
+    if (shards_.empty() || onboarded() >= config_.ingress.onboarding_max_instruments) {
+        LOG_WARN("Refusing instrument {}: {} instruments already onboarded", token, onboarded());
+        stats::bump(refused_);
+        return {};
+    }
+    InstrumentSpec spec;
+    spec.token = token;
+    EngineShard& shard = *shards_[assignment_.assign(spec, shards_.size())];
+    if (snapshots_) {
+        snapshots_->addInstrument(token);
+    }
+
+    Route route;
+    InstrumentLoad* load = nullptr;
+    // Built on the shard's core so the book and queue pages are local to it.
+    numa::runOn(shard.core() >= 0 ? std::vector<int>{shard.core()} : std::vector<int>{}, [&] {
+        auto book = std::make_unique<OrderBook>(config_.bookBackendFor(token));
+        book->setInstrumentToken(token);
+        book->setPriceBands(config_.priceBandsFor(token));
+        if (config_.warmup.enabled) {
+            book->reserve(config_.warmup.expected_orders, config_.warmup.level_orders);
+        }
+        load = &shard.onboard(token, std::move(book), multi_producer_, [&](OrderBook& live, EngineShard::Queue& queue) {
+            for (EngineShard* other : shards_) {
+                if (other != &shard) {
+                    other->tradePublisher().track(token, live);
+                }
+            }
+            route = hook_ ? hook_(token, live, Route{&queue}) : Route{&queue};
+        });
+    });
+    if (balancer_) {
+        balancer_->watch(*load);
+    }
+    stats::bump(onboarded_);
+    LOG_INFO("Onboarded instrument {} on shard {} ({} backend)", token, shard.id(),
+             toString(config_.bookBackendFor(token)));
+    return route;
+}
+
+}  // namespace engine
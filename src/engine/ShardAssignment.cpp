@@ -0,0 +1,52 @@
+#include "engine/ShardAssignment.h"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace engine {
+
+std::size_t RoundRobinAssignment::assign(const InstrumentSpec&, std::size_t shard_count) {
+    return next_++ % shard_count;
+}
+
+std::size_t HashAssignment::assign(const InstrumentSpec& instrument, std::size_t shard_count) {
+    // Fibonacci hashing spreads runs of consecutive tokens across shards.
+    const uint64_t mixed = static_cast<uint64_t>(instrument.token) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<std::size_t>((mixed >> 32) % shard_count);
+}
+
+PinnedAssignment::PinnedAssignment(std::unordered_map<InstrumentToken, std::size_t> pins,
+                                   std::unique_ptr<ShardAssignmentPolicy> fallback)
+    : pins_(std::move(pins)),
+      fallback_(std::move(fallback)) {}
+
+std::size_t PinnedAssignment::assign(const InstrumentSpec& instrument, std::size_t shard_count) {
+    auto it = pins_.find(instrument.token);
+    if (it == pins_.end()) {
+        return fallback_->assign(instrument, shard_count);
+    }
+    if (it->second >= shard_count) {
+        throw std::runtime_error("Instrument " + std::to_string(instrument.token) + " pinned to shard " +
+                                 std::to_string(it->second) + " but only " + std::to_string(shard_count) +
+                                 " shards are configured");
+    }
+    return it->second;
+}
+
+std::unique_ptr<ShardAssignmentPolicy> makeAssignmentPolicy(const EngineSettings& settings) {
+    std::unique_ptr<ShardAssignmentPolicy> policy;
+    if (settings.assignment == "round_robin") {
+        policy = std::make_unique<RoundRobinAssignment>();
+    } else if (settings.assignment == "hash") {
+        policy = std::make_unique<HashAssignment>();
+    } else {
+        throw std::runtime_error("Unknown shard assignment policy: " + settings.assignment);
+    }
+    if (settings.pins.empty()) {
+        return policy;
+    }
+    return std::make_unique<PinnedAssignment>(settings.pins, std::move(policy));
+}
+
+}  // namespace engine
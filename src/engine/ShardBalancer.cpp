@@ -0,0 +1,126 @@
+#include "engine/ShardBalancer.h"
+
+#include <algorithm>
+
+#include "utils/LogMacros.h"
+
+namespace engine {
+
+ShardBalancer::ShardBalancer(const std::vector<EngineShard*>& shards, const EngineSettings& settings)
+    : shards_(shards),
+      interval_(settings.rebalance_interval_ms),
+      ratio_(settings.rebalance_ratio),
+      min_load_(settings.rebalance_min_load) {
+    for (const auto& [token, shard] : settings.pins) {
+        (void)shard;
+        pinned_.insert(token);
+    }
+    for (EngineShard* owner : shards_) {
+        owner->forEachBook([this, owner](InstrumentToken token, OrderBook& book) {
+            for (EngineShard* other : shards_) {
+                if (other != owner) {
+                    other->tradePublisher().track(token, book);
+                }
+            }
+        });
+        owner->forEachLoad([this](InstrumentLoad& load) { samples_.push_back({&load, 0}); });
+    }
+}
+
+void ShardBalancer::watch(InstrumentLoad& load) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    watched_.push_back(&load);
+}
+
+bool ShardBalancer::rebalance() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (InstrumentLoad* load : watched_) {
+            samples_.push_back({load, 0});
+        }
+        watched_.clear();
+    }
+    std::vector<uint64_t> shardLoad(shards_.size(), 0);
+    std::vector<uint64_t> instrumentLoad(samples_.size(), 0);
+    std::vector<std::size_t> perShard(shards_.size(), 0);
+    for (std::size_t idx = 0; idx < samples_.size(); ++idx) {
+        Sample& sample = samples_[idx];
+        const uint64_t processed = sample.load->processed.load(std::memory_order_relaxed);
+        instrumentLoad[idx] = (processed - sample.last_processed) + sample.load->queue->read_available();
+        sample.last_processed = processed;
+        const std::size_t owner = sample.load->shard.load(std::memory_order_acquire);
+        shardLoad[owner] += instrumentLoad[idx];
+        ++perShard[owner];
+    }
+
+    if (pending_) {
+        if (pending_->shard.load(std::memory_order_acquire) != pending_target_ && ++pending_age_ < kPendingIntervals) {
+            return false;
+        }
+        pending_ = nullptr;
+    }
+    if (shards_.size() < 2) {
+        return false;
+    }
+
+    const auto [coldIt, hotIt] = std::minmax_element(shardLoad.begin(), shardLoad.end());
+    const auto hot = static_cast<std::size_t>(hotIt - shardLoad.begin());
+    const auto cold = static_cast<std::size_t>(coldIt - shardLoad.begin());
+    if (hot == cold || perShard[hot] < 2 || *hotIt < min_load_ ||
+        static_cast<double>(*hotIt) <= static_cast<double>(*coldIt) * ratio_) {
+        return false;
+    }
+
+    // Moving load L leaves max(hot - L, cold + L); the best L is closest to half the gap.
+    const uint64_t gap = *hotIt - *coldIt;
+    std::size_t best = samples_.size();
+    uint64_t bestMiss = gap;
+    for (std::size_t idx = 0; idx < samples_.size(); ++idx) {
+        const InstrumentLoad& load = *samples_[idx].load;
+        const uint64_t moved = instrumentLoad[idx];
+        if (moved == 0 || moved >= gap || load.shard.load(std::memory_order_relaxed) != hot ||
+            pinned_.count(load.token) > 0) {
+            continue;
+        }
+        const uint64_t miss = moved * 2 > gap ? moved * 2 - gap : gap - moved * 2;
+        if (miss < bestMiss) {
+            bestMiss = miss;
+            best = idx;
+        }
+    }
+    if (best == samples_.size()) {
+        return false;
+    }
+
+    pending_ = samples_[best].load;
+    pending_target_ = cold;
+    pending_age_ = 0;
+    requested_.fetch_add(1, std::memory_order_relaxed);
+    LOG_INFO("Rebalance: moving instrument {} (load {}) from shard {} (load {}) to shard {} (load {})",
+             pending_->token, instrumentLoad[best], hot, *hotIt, cold, *coldIt);
+    shards_[hot]->requestRelease(pending_->token, *shards_[cold]);
+    return true;
+}
+
+void ShardBalancer::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        wake_.wait_for(lock, interval_);
+        if (!running_) {
+            break;
+        }
+        lock.unlock();
+        rebalance();
+        lock.lock();
+    }
+}
+
+void ShardBalancer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_all();
+}
+
+}  // namespace engine
@@ -0,0 +1,92 @@
+#include "engine/Warmup.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "core/OrderBook.h"
+#include "core/OrderBuilder.h"
+
+namespace engine {
+
+namespace {
+
+constexpr Price kSyntheticMid = 100000;
+
+std::unique_ptr<Order> syntheticOrder(OrderId id, Side side, Price price, Qty qty, OrderType type) {
+    return OrderBuilder()
+        .setOrderId(id)
+        .setSide(side)
+        .setPrice(price)
+        .setQuantity(qty)
+        .setOrderType(type)
+        .setTimestamp(std::chrono::high_resolution_clock::now())
+        .build();
+}
+
+}  // namespace
+
+uint64_t runSyntheticFlow(BookBackend backend, std::size_t orders) {
+    uint64_t trades = 0;
+    const auto count = [&trades](TradeBatch batch) { trades += batch.size(); };
+    OrderBook book(backend, TradePublishMode::INLINE);
+    book.addTradeSink(count);
+    book.reserve(orders + 1, 0);
+
+    for (std::size_t i = 0; i < orders; ++i) {
+        const auto id = static_cast<OrderId>(i + 1);
+        const auto offset = static_cast<Price>(1 + i % 4);
+        switch (i % 8) {
+            case 0:
+            case 2:
+                book.addOrder(syntheticOrder(id, Side::BUY, kSyntheticMid - offset, 2, OrderType::LIMIT));
+                break;
+            case 1:
+            case 3:
+                book.addOrder(syntheticOrder(id, Side::SELL, kSyntheticMid + offset, 2, OrderType::LIMIT));
+                break;
+            case 4:
+                book.addOrder(syntheticOrder(id, Side::BUY, kSyntheticMid + 4, 4, OrderType::LIMIT));
+                break;
+            case 5:
+                book.addOrder(syntheticOrder(id, Side::SELL, kSyntheticMid - 4, 5, OrderType::IOC));
+                break;
+            case 6:
+                // May already be filled: the reject path is worth warming too.
+                book.cancelOrder(id - 3);
+                break;
+            default:
+                if (const Order* bid = book.bestBid()) {
+                    book.modifyOrder(bid->orderId(), bid->price(), bid->quantity() + 1);
+                }
+                break;
+        }
+    }
+    return trades;
+}
+
+WarmupResult warmUpShard(EngineShard& shard, const WarmupSettings& settings) {
+    WarmupResult result;
+    std::vector<BookBackend> backends;
+    shard.forEachBook([&](InstrumentToken, OrderBook& book) {
+        book.reserve(settings.expected_orders, settings.level_orders);
+        ++result.books;
+        bool seen = false;
+        for (BookBackend backend : backends) {
+            seen = seen || backend == book.backend();
+        }
+        if (!seen) {
+            backends.push_back(book.backend());
+        }
+    });
+    if (settings.synthetic_orders == 0) {
+        return result;
+    }
+    for (BookBackend backend : backends) {
+        result.synthetic_trades += runSyntheticFlow(backend, settings.synthetic_orders);
+        result.synthetic_orders += settings.synthetic_orders;
+    }
+    return result;
+}
+
+}  // namespace engine
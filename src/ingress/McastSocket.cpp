@@ -58,9 +58,9 @@ public:
     }
 
     int socket_fd_ = -1;
-    std::vector<char> outbound_data_;
+    Buffer outbound_data_;
     size_t next_send_valid_index_ = 0;
-    std::vector<char> inbound_data_;
+    Buffer inbound_data_;
     size_t next_rcv_valid_index_ = 0;
     std::function<void(McastSocket*)> recv_callback_;
     std::string time_str_;
@@ -78,8 +78,9 @@ McastSocket& McastSocket::operator=(McastSocket&&) noexcept = default;
 auto McastSocket::init(const std::string& ip,
                        const std::string& iface,
                        int port,
-                       bool is_listening) -> int {
-    const SocketCfg socket_cfg{ip, iface, port, true, is_listening, false};
+                       bool is_listening,
+                       bool reuse_port) -> int {
+    const SocketCfg socket_cfg{ip, iface, port, true, is_listening, false, reuse_port};
     impl_->socket_fd_ = createSocket(socket_cfg);
     impl_->iface_ = iface;
     return impl_->socket_fd_;
@@ -198,11 +199,11 @@ int McastSocket::fd() const noexcept {
     return impl_->socket_fd_;
 }
 
-std::vector<char>& McastSocket::outboundBuffer() noexcept {
+McastSocket::Buffer& McastSocket::outboundBuffer() noexcept {
     return impl_->outbound_data_;
 }
 
-std::vector<char>& McastSocket::inboundBuffer() noexcept {
+McastSocket::Buffer& McastSocket::inboundBuffer() noexcept {
     return impl_->inbound_data_;
 }
 
@@ -0,0 +1,81 @@
+#include "ingress/OnboardingChannel.h"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace ingress {
+
+OnboardingChannel::OnboardingChannel(std::size_t dispatchers) {
+    for (std::size_t idx = 0; idx < std::max<std::size_t>(dispatchers, 1); ++idx) {
+        auto mailbox = std::make_unique<Mailbox>();
+        mailbox->event_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (mailbox->event_fd == -1) {
+            throw std::runtime_error(std::string("eventfd failed: ") + std::strerror(errno));
+        }
+        mailboxes_.push_back(std::move(mailbox));
+    }
+}
+
+OnboardingChannel::~OnboardingChannel() {
+    for (auto& mailbox : mailboxes_) {
+        ::close(mailbox->event_fd);
+    }
+}
+
+void OnboardingChannel::request(std::size_t dispatcher, InstrumentToken token) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requests_.push_back({token, dispatcher});
+    }
+    wake_.notify_one();
+}
+
+int OnboardingChannel::replyFd(std::size_t dispatcher) const {
+    return mailboxes_.at(dispatcher)->event_fd;
+}
+
+std::vector<OnboardingChannel::Reply> OnboardingChannel::takeReplies(std::size_t dispatcher) {
+    Mailbox& mailbox = *mailboxes_.at(dispatcher);
+    uint64_t count = 0;
+    // Reset before taking, so a reply posted after the swap re-arms the fd.
+    [[maybe_unused]] const auto ignored = ::read(mailbox.event_fd, &count, sizeof(count));
+    std::vector<Reply> out;
+    std::lock_guard<std::mutex> lock(mailbox.mutex);
+    out.swap(mailbox.replies);
+    return out;
+}
+
+bool OnboardingChannel::waitRequests(std::vector<Request>& out, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    wake_.wait_for(lock, timeout, [this] { return closed_ || !requests_.empty(); });
+    out.swap(requests_);
+    requests_.clear();
+    return !closed_;
+}
+
+void OnboardingChannel::reply(std::size_t dispatcher, const Reply& reply) {
+    Mailbox& mailbox = *mailboxes_.at(dispatcher);
+    {
+        std::lock_guard<std::mutex> lock(mailbox.mutex);
+        mailbox.replies.push_back(reply);
+    }
+    const uint64_t one = 1;
+    [[maybe_unused]] const auto ignored = ::write(mailbox.event_fd, &one, sizeof(one));
+}
+
+void OnboardingChannel::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    wake_.notify_all();
+}
+
+}  // namespace ingress
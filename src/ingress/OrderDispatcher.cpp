@@ -1,22 +1,73 @@
 #include "ingress/OrderDispatcher.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cerrno>
 #include <sys/epoll.h>
 #include <string>
-#include <thread>
 
+#include "utils/CompilerHints.h"
+#include "utils/Counters.h"
 #include "utils/LogMacros.h"
 
-OrderDispatcher::OrderDispatcher(SocketUtils::McastSocket& socket, QueueMap queues)
+namespace {
+
+// The throttle's clock.
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+}  // namespace
+
+OrderDispatcher::OrderDispatcher(SocketUtils::McastSocket& socket, RouteMap routes, const WaitSettings& wait)
     : socket_(socket),
-      queues_(std::move(queues)) {}
+      wait_(wait) {
+    for (const auto& [token, route] : routes) {
+        RouteState& state = routes_[token];
+        state.route = route;
+        if (route.queue != nullptr) {
+            attach(token, state);
+        }
+    }
+    dirty_.reserve(routes_.size());
+}
+
+void OrderDispatcher::setBackpressure(Backpressure backpressure) {
+    backpressure_ = std::move(backpressure);
+    for (auto& [token, state] : routes_) {
+        if (state.route.queue != nullptr) {
+            attach(token, state);
+        }
+    }
+}
+
+void OrderDispatcher::setThrottle(ingress::Throttle* throttle) {
+    throttle_ = throttle;
+    for (auto& [token, state] : routes_) {
+        if (state.route.queue != nullptr) {
+            attach(token, state);
+        }
+    }
+}
+
+std::vector<OrderDispatcher::QueueStats> OrderDispatcher::queueStats() const {
+    std::lock_guard<std::mutex> lock(counters_mutex_);
+    std::vector<QueueStats> stats;
+    stats.reserve(counters_.size());
+    for (const auto& counters : counters_) {
+        stats.push_back({counters->token, counters->capacity, counters->overflow,
+                         counters->high_water.load(std::memory_order_relaxed),
+                         counters->spilled.load(std::memory_order_relaxed),
+                         counters->dropped.load(std::memory_order_relaxed)});
+    }
+    return stats;
+}
 
 void OrderDispatcher::run() {
     socket_.setRecvCallback([this](SocketUtils::McastSocket* sock) {
-        const std::string payload(sock->inboundBuffer().data(), sock->recvSize());
+        handlePayload(std::string_view(sock->inboundBuffer().data(), sock->recvSize()));
         sock->resetRecvSize();
-        handlePayload(payload);
     });
 
     const int fd = socket_.fd();
@@ -33,10 +84,28 @@ void OrderDispatcher::run() {
         ::close(epfd);
         return;
     }
+    const int reply_fd = onboarding_.channel ? onboarding_.channel->replyFd(onboarding_.index) : -1;
+    if (reply_fd != -1) {
+        epoll_event reply_ev{};
+        reply_ev.events = EPOLLIN;
+        reply_ev.data.fd = reply_fd;
+        if (::epoll_ctl(epfd, EPOLL_CTL_ADD, reply_fd, &reply_ev) == -1) {
+            LOG_WARN("Failed to add onboarding fd to epoll: {}", errno);
+            ::close(epfd);
+            return;
+        }
+    }
 
     while (running_) {
-        epoll_event events[1];
-        const int rc = ::epoll_wait(epfd, events, 1, 100);
+        epoll_event events[2];
+        // A backlog is retried on every pass instead of waiting for the next datagram,
+        // and a delayed order wakes the loop when it is due.
+        int timeout_ms = spilling_.empty() ? 100 : 0;
+        if (UNLIKELY(!delayed_.empty()) && timeout_ms > 0) {
+            const int64_t due_ns = delayed_.top().release_ns - nowNs();
+            timeout_ms = static_cast<int>(std::clamp<int64_t>(due_ns / 1'000'000, 0, timeout_ms));
+        }
+        const int rc = ::epoll_wait(epfd, events, 2, timeout_ms);
         if (rc < 0) {
             if (errno == EINTR) {
                 continue;
@@ -44,11 +113,20 @@ void OrderDispatcher::run() {
             LOG_WARN("epoll_wait failed on dispatcher socket: {}", errno);
             break;
         }
-        if (rc == 0) {
-            continue;
+        for (int idx = 0; idx < rc; ++idx) {
+            if (events[idx].data.fd == reply_fd) {
+                applyReplies();
+            } else if (events[idx].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+                for (std::size_t n = 0; n < kMaxDatagramsPerWake && socket_.sendAndRecv(); ++n) {
+                }
+                flush();
+            }
+        }
+        if (UNLIKELY(!pending_.empty())) {
+            expirePending();
         }
-        if (events[0].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
-            socket_.sendAndRecv();
+        if (UNLIKELY(!spilling_.empty() || !delayed_.empty())) {
+            flush();
         }
     }
     ::close(epfd);
@@ -63,26 +141,341 @@ void OrderDispatcher::handlePayload(std::string_view payload) {
         return;
     }
 
+    InstrumentToken instrument = 0;
+    if (!ingress::peekWireInstrument(payload, instrument)) {
+        LOG_WARN("Failed to parse incoming payload '{}'", payload);
+        return;
+    }
+
+    auto it = routes_.find(instrument);
+    if (UNLIKELY(it == routes_.end())) {
+        handleUnknown(instrument, payload);
+        return;
+    }
+
+    RouteState& state = it->second;
+    if (state.route.queue == nullptr) {
+        if (UNLIKELY(state.refused)) {
+            stats::bump(dropped_);
+        }
+        return;  // owned by another dispatcher on the same group
+    }
+    if (LIKELY(state.route.queue->single() != nullptr && state.spill.empty())) {
+        if (ingress::WireOrder* slot = nextSlot(state)) {
+            if (!decode(payload, state, *slot)) {
+                return;  // the slot stays claimed and is simply reused by the next datagram
+            }
+            wrote(state);
+        } else {
+            ingress::WireOrder order{};
+            if (!decode(payload, state, order)) {
+                return;
+            }
+            overflow(state, order);
+        }
+    } else {
+        ingress::WireOrder order{};
+        if (!decode(payload, state, order)) {
+            return;
+        }
+        enqueue(state, order);
+    }
+    if (seen_instruments_.insert(instrument).second) {
+        LOG_INFO("Receiving orders for instrument {}", instrument);
+    }
+}
+
+void OrderDispatcher::handleUnknown(InstrumentToken instrument, std::string_view payload) {
+    const Onboarding& onboarding = onboarding_;
+    const std::size_t owners = std::max<std::size_t>(onboarding.owners, 1);
+    if (onboarding.channel == nullptr) {
+        refuse(instrument, 1);
+        return;
+    }
+    if (instrument % owners != onboarding.index % owners) {
+        routes_[instrument];  // another dispatcher onboards it
+        return;
+    }
+
+    auto [it, inserted] = pending_.try_emplace(instrument);
+    Pending& pending = it->second;
+    if (inserted) {
+        pending.orders.reserve(std::min<std::size_t>(onboarding.buffer, 64));
+        pending.deadline = std::chrono::steady_clock::now() + onboarding.timeout;
+        onboarding.channel->request(onboarding.index, instrument);
+        LOG_INFO("Onboarding instrument {}", instrument);
+    }
     ingress::WireOrder order{};
+    if (pending.expired || pending.orders.size() >= onboarding.buffer || !ingress::parseWireOrder(payload, order)) {
+        stats::bump(dropped_);
+        return;
+    }
+    stamp(order);
+    pending.orders.push_back(order);
+}
+
+bool OrderDispatcher::decode(std::string_view payload, RouteState& state, ingress::WireOrder& order) {
     if (!ingress::parseWireOrder(payload, order)) {
         LOG_WARN("Failed to parse incoming payload '{}'", payload);
-        return;
+        return false;
+    }
+    if (throttle_ != nullptr && !admit(state, order)) {
+        return false;
     }
+    stamp(order);
+    return true;
+}
 
-    auto it = queues_.find(order.instrument);
-    if (it == queues_.end()) {
-        LOG_WARN("No queue registered for instrument {}", order.instrument);
+bool OrderDispatcher::admit(RouteState& state, const ingress::WireOrder& order) {
+    const ThrottleSettings& limits = throttle_->settings();
+    const int64_t now = nowNs();
+    const int64_t max_wait = (limits.action == ThrottleAction::DELAY && delayed_.size() < limits.delay_capacity)
+        ? static_cast<int64_t>(limits.max_delay_us) * 1000
+        : 0;
+    const int64_t at = throttle_->admit(order, state.limit, now, max_wait);
+    if (LIKELY(at == now)) {
+        return true;
+    }
+    if (at == ingress::Throttle::kRejected) {
+        reject(order, ExecReason::THROTTLED);
+    } else {
+        delayed_.push({at, delay_arrivals_++, &state, order});
+    }
+    return false;
+}
+
+void OrderDispatcher::releaseDelayed() {
+    const int64_t now = nowNs();
+    while (!delayed_.empty() && delayed_.top().release_ns <= now) {
+        Delayed next = delayed_.top();
+        delayed_.pop();
+        stamp(next.order);
+        enqueue(*next.state, next.order);
+    }
+}
+
+void OrderDispatcher::reject(const ingress::WireOrder& order, ExecReason reason) {
+    if (reject_sink_) {
+        reject_sink_(order, reason);
+    }
+}
+
+void OrderDispatcher::stamp(ingress::WireOrder& order) {
+    order.sequence = (sequencer_ != nullptr) ? sequencer_->next() : 0;
+}
+
+void OrderDispatcher::attach(InstrumentToken token, RouteState& state) {
+    const auto it = backpressure_.overrides.find(token);
+    state.overflow = (it != backpressure_.overrides.end()) ? it->second : backpressure_.overflow;
+    state.limit = throttle_ != nullptr ? throttle_->bucketFor(token) : nullptr;
+    if (state.route.queue->single() != nullptr) {
+        Claim& claim = claims_[state.route.queue];
+        claim.queue = state.route.queue;
+        state.claim = &claim;
+    }
+    std::lock_guard<std::mutex> lock(counters_mutex_);
+    if (state.counters == nullptr) {
+        counters_.push_back(std::make_unique<Counters>());
+        state.counters = counters_.back().get();
+        state.counters->token = token;
+    }
+    state.counters->capacity = state.route.queue->capacity();
+    state.counters->overflow = state.overflow;
+}
+
+void OrderDispatcher::enqueue(RouteState& state, const ingress::WireOrder& order) {
+    // Once an instrument spills, its later orders queue behind the backlog.
+    if (UNLIKELY(!state.spill.empty()) || !tryPush(state, order)) {
+        overflow(state, order);
+    }
+}
+
+bool OrderDispatcher::tryPush(RouteState& state, const ingress::WireOrder& order) {
+    auto* queue = state.route.queue;
+    if (queue->single() != nullptr) {
+        ingress::WireOrder* slot = nextSlot(state);
+        if (slot == nullptr) {
+            return false;
+        }
+        *slot = order;
+        wrote(state);
+        return true;
+    }
+    if (UNLIKELY(!queue->push(order))) {
+        if (state.overflow != IngressOverflow::BLOCK) {
+            return false;
+        }
+        do {
+            wait_.idle([queue] { return queue->write_available() > 0; });
+        } while (!queue->push(order));
+    }
+    wait_.reset();
+    noteDepth(state);
+    queue->notifyConsumer();
+    return true;
+}
+
+void OrderDispatcher::overflow(RouteState& state, const ingress::WireOrder& order) {
+    const bool spill =
+        state.overflow == IngressOverflow::SPILL && state.spill.size() < backpressure_.spill_capacity;
+    if (!state.overflowing) {
+        state.overflowing = true;
+        LOG_WARN("Queue of instrument {} is full ({} orders); {} its orders", order.instrument,
+                 state.route.queue->capacity(), spill ? "spilling" : "dropping");
+    }
+    if (spill) {
+        if (state.spill.empty()) {
+            spilling_.push_back(&state);
+        }
+        state.spill.push_back(order);
+        stats::bump(state.counters->spilled);
         return;
     }
+    stats::bump(state.counters->dropped);
+    reject(order, ExecReason::OVERLOADED);
+}
 
-    auto* queue = it->second;
-    std::size_t spins = 0;
-    while (!queue->push(order)) {
-        if (++spins % 1000 == 0) {
-            std::this_thread::yield();
+void OrderDispatcher::drainSpills() {
+    for (auto it = spilling_.begin(); it != spilling_.end();) {
+        RouteState& state = **it;
+        while (!state.spill.empty() && tryPush(state, state.spill.front())) {
+            state.spill.pop_front();
         }
+        it = state.spill.empty() ? spilling_.erase(it) : it + 1;
     }
-    if (seen_instruments_.insert(order.instrument).second) {
-        LOG_INFO("Receiving orders for instrument {}", order.instrument);
+}
+
+void OrderDispatcher::applyReplies() {
+    for (const auto& reply : onboarding_.channel->takeReplies(onboarding_.index)) {
+        auto it = pending_.find(reply.token);
+        const std::size_t held = it == pending_.end() ? 0 : it->second.orders.size();
+        if (reply.queue == nullptr) {
+            refuse(reply.token, held);
+        } else {
+            RouteState& state = routes_[reply.token];
+            state.route.queue = reply.queue;
+            attach(reply.token, state);
+            if (it != pending_.end()) {
+                for (const auto& order : it->second.orders) {
+                    enqueue(state, order);
+                }
+            }
+            stats::bump(onboarded_);
+            LOG_INFO("Instrument {} onboarded, {} held orders replayed", reply.token, held);
+        }
+        if (it != pending_.end()) {
+            pending_.erase(it);
+        }
+    }
+    flush();
+}
+
+void OrderDispatcher::expirePending() {
+    const auto now = std::chrono::steady_clock::now();
+    for (auto& [token, pending] : pending_) {
+        if (!pending.expired && now >= pending.deadline) {
+            // The book may still come; until then its orders are dropped rather than held stale.
+            LOG_WARN("Onboarding instrument {} timed out, dropping {} held orders", token, pending.orders.size());
+            stats::bump(dropped_, pending.orders.size());
+            pending.orders.clear();
+            pending.orders.shrink_to_fit();
+            pending.expired = true;
+        }
+    }
+}
+
+void OrderDispatcher::refuse(InstrumentToken instrument, std::size_t orders) {
+    RouteState& state = routes_[instrument];
+    state.refused = true;
+    stats::bump(dropped_, orders);
+    LOG_WARN("No queue for instrument {}; dropping its orders", instrument);
+}
+
+ingress::WireOrder* OrderDispatcher::nextSlot(RouteState& state) {
+    Claim& claim = *state.claim;
+    if (claim.used == claim.slots.size()) {
+        if (claim.used > 0) {
+            publish(claim);
+        }
+        auto* queue = claim.queue->single();
+        claim.slots = queue->claim(kClaimBatch);
+        if (UNLIKELY(claim.slots.empty())) {
+            if (state.overflow != IngressOverflow::BLOCK) {
+                return nullptr;
+            }
+            while ((claim.slots = queue->claim(kClaimBatch)).empty()) {
+                wait_.idle([queue] { return queue->write_available() > 0; });
+            }
+        }
+        wait_.reset();
+    }
+    return &claim.slots[claim.used];
+}
+
+void OrderDispatcher::wrote(RouteState& state) {
+    Claim& claim = *state.claim;
+    if (claim.used++ == 0) {
+        dirty_.push_back(&claim);
+    }
+    if (!state.writing) {
+        state.writing = true;
+        claim.writers.push_back(&state);
+    }
+}
+
+void OrderDispatcher::publish(Claim& claim) {
+    claim.queue->single()->commit(claim.used);
+    claim.slots = claim.slots.subspan(claim.used);
+    claim.used = 0;
+    for (RouteState* state : claim.writers) {
+        state->writing = false;
+        noteDepth(*state);
+    }
+    claim.writers.clear();
+    claim.queue->notifyConsumer();
+}
+
+void OrderDispatcher::noteDepth(RouteState& state) {
+    const std::size_t depth = state.route.queue->read_available();
+    if (depth > state.high_water) {
+        state.high_water = depth;
+        state.counters->high_water.store(depth, std::memory_order_relaxed);
+    }
+    if (UNLIKELY(state.overflowing) && state.spill.empty()) {
+        state.overflowing = false;
+    }
+}
+
+void OrderDispatcher::flush() {
+    if (UNLIKELY(!delayed_.empty())) {
+        releaseDelayed();
+    }
+    if (UNLIKELY(!spilling_.empty())) {
+        drainSpills();
+    }
+    for (Claim* claim : dirty_) {
+        if (claim->used > 0) {
+            publish(*claim);
+        }
+    }
+    dirty_.clear();
+}
+
+std::vector<OrderDispatcher::RouteMap> partitionRoutes(const OrderDispatcher::RouteMap& routes,
+                                                       const std::vector<InstrumentToken>& tokens,
+                                                       std::size_t parts) {
+    std::vector<OrderDispatcher::RouteMap> out(std::max<std::size_t>(parts, 1));
+    std::unordered_set<InstrumentToken> assigned;
+    std::size_t next = 0;
+    for (InstrumentToken token : tokens) {
+        auto it = routes.find(token);
+        if (it == routes.end() || !assigned.insert(token).second) {
+            continue;
+        }
+        const std::size_t owner = next++ % out.size();
+        for (std::size_t part = 0; part < out.size(); ++part) {
+            out[part].emplace(token, part == owner ? it->second : OrderDispatcher::Route{});
+        }
     }
+    return out;
 }
@@ -0,0 +1,93 @@
+#include "ingress/Throttle.h"
+
+#include <algorithm>
+
+#include "utils/CompilerHints.h"
+
+namespace ingress {
+
+void Throttle::Bucket::configure(uint64_t rate, uint32_t burst) {
+    interval_ns_ = rate == 0 ? 0 : std::max<int64_t>(1, static_cast<int64_t>(1'000'000'000ULL / rate));
+    tolerance_ns_ = interval_ns_ * (static_cast<int64_t>(std::max<uint32_t>(burst, 1)) - 1);
+}
+
+int64_t Throttle::Bucket::acquire(int64_t now_ns, int64_t max_wait_ns) {
+    int64_t tat = tat_ns_.load(std::memory_order_relaxed);
+    for (;;) {
+        // A full bucket is a theoretical arrival time `tolerance` or more in the past.
+        const int64_t at = std::max(now_ns, tat - tolerance_ns_);
+        if (at - now_ns > max_wait_ns) {
+            return kRejected;
+        }
+        if (tat_ns_.compare_exchange_weak(tat, std::max(tat, now_ns) + interval_ns_, std::memory_order_relaxed)) {
+            return at;
+        }
+    }
+}
+
+Throttle::Throttle(const ThrottleSettings& settings)
+    : settings_(settings),
+      participants_(static_cast<std::size_t>(settings.max_participants) + 1) {
+    for (auto& participant : participants_) {
+        participant.bucket.configure(settings_.participant_rate, settings_.participant_burst);
+    }
+    for (const auto& [id, rate] : settings_.participant_rates) {
+        if (id < settings_.max_participants) {
+            participants_[id].bucket.configure(rate, settings_.participant_burst);
+        }
+    }
+}
+
+Throttle::Bucket* Throttle::bucketFor(InstrumentToken token) {
+    if (settings_.instrument_rate == 0) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(instruments_mutex_);
+    auto [it, inserted] = instruments_.try_emplace(token, nullptr);
+    if (inserted) {
+        it->second = &instrument_buckets_.emplace_back(settings_.instrument_rate, settings_.instrument_burst);
+    }
+    return it->second;
+}
+
+int64_t Throttle::admit(const WireOrder& order, Bucket* instrument, int64_t now_ns, int64_t max_wait_ns) {
+    Participant& participant =
+        participants_[std::min<std::size_t>(order.participant, participants_.size() - 1)];
+    int64_t at = now_ns;
+    if (participant.bucket.limited()) {
+        at = participant.bucket.acquire(now_ns, max_wait_ns);
+        if (at == kRejected) {
+            participant.rejected.fetch_add(1, std::memory_order_relaxed);
+            return kRejected;
+        }
+    }
+    if (instrument != nullptr) {
+        const int64_t instrument_at = instrument->acquire(now_ns, max_wait_ns);
+        if (instrument_at == kRejected) {
+            if (participant.bucket.limited()) {
+                participant.bucket.refund();
+            }
+            participant.rejected.fetch_add(1, std::memory_order_relaxed);
+            return kRejected;
+        }
+        at = std::max(at, instrument_at);
+    }
+    if (UNLIKELY(at > now_ns)) {
+        participant.delayed.fetch_add(1, std::memory_order_relaxed);
+    }
+    return at;
+}
+
+std::vector<Throttle::ParticipantStats> Throttle::throttled() const {
+    std::vector<ParticipantStats> stats;
+    for (std::size_t id = 0; id < participants_.size(); ++id) {
+        const uint64_t rejected = participants_[id].rejected.load(std::memory_order_relaxed);
+        const uint64_t delayed = participants_[id].delayed.load(std::memory_order_relaxed);
+        if (rejected > 0 || delayed > 0) {
+            stats.push_back({static_cast<ParticipantId>(id), rejected, delayed});
+        }
+    }
+    return stats;
+}
+
+}  // namespace ingress
@@ -1,20 +1,37 @@
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <stdexcept>
+#include <string>
 #include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
-#include "boost/lockfree/spsc_queue.hpp"
+#include "core/ExecReportPublisher.h"
 #include "core/OrderBook.h"
-#include "core/OrderBuilder.h"
+#include "engine/EngineShard.h"
+#include "engine/InstrumentOnboarder.h"
+#include "engine/ShardAssignment.h"
+#include "engine/ShardBalancer.h"
+#include "engine/Warmup.h"
 #include "ingress/McastSocket.h"
+#include "ingress/OnboardingChannel.h"
 #include "ingress/OrderDispatcher.h"
+#include "ingress/Sequencer.h"
+#include "ingress/Throttle.h"
 #include "ingress/WireOrder.h"
+#include "risk/RiskStage.h"
 #include "snapshot/SnapshotPublisher.h"
 #include "utils/Affinity.h"
 #include "utils/Config.h"
+#include "utils/HugePages.h"
+#include "utils/InstrumentUniverse.h"
 #include "utils/Logger.h"
+#include "utils/LowJitter.h"
 #include "utils/LogMacros.h"
+#include "utils/Numa.h"
+#include "utils/WaitStrategy.h"
 
 namespace {
 #ifdef PROJECT_ROOT
@@ -23,24 +40,108 @@ constexpr const char* kConfigPath = PROJECT_ROOT "/config/app.ini";
 constexpr const char* kConfigPath = "config/app.ini";
 #endif
 
-using WireOrder = ingress::WireOrder;
-using Queue = boost::lockfree::spsc_queue<WireOrder>;
-constexpr std::size_t kQueueCapacity = 10240;
+void logWaitCounters(const std::string& role, WaitMode mode, const WaitCounters& c) {
+    LOG_INFO("Wait {} ({}): spins={} yields={} sleeps={} parks={} wakeups={} wake_latency_avg_ns={} "
+             "wake_latency_max_ns={}",
+             role, toString(mode), c.spins, c.yields, c.sleeps, c.parks, c.wakeups, c.averageWakeLatencyNs(),
+             c.wake_latency_max_ns);
+}
+
+// Orders refused before they reach a book leave as REJECT reports on `sender`.
+OrderDispatcher::RejectSink rejectReports(ExecReportPublisher& sender) {
+    return [&sender](const ingress::WireOrder& order, ExecReason reason) {
+        execution::ExecutionReport report;
+        report.order_id = order.order_id;
+        report.price = order.price;
+        const auto now = std::chrono::system_clock::now().time_since_epoch();
+        report.timestamp_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+        report.instrument = order.instrument;
+        report.type = ExecType::REJECT;
+        report.side = static_cast<uint8_t>(order.side);
+        report.reason = reason;
+        report.sequence = order.sequence;
+        sender.publish(report);
+    };
+}
 }  // namespace
 
 int main() {
     try {
         const AppConfig config = loadConfig(kConfigPath);
+        // Before any book, queue or socket exists: regions keep the mode they allocated with.
+        memory::configureHugePages(config.memory);
         logging::LoggerOptions logger_opts;
         logger_opts.queue_size = config.logging.queue_size;
         logger_opts.worker_threads = config.logging.worker_threads;
         logger_opts.affinity = config.affinity.logging_cores;
         logging::configureLogger(logger_opts);
-        const std::vector<InstrumentToken> instruments = {26000, 35000};
+        const LowJitterSettings& low_jitter = config.low_jitter;
+        if (low_jitter.enabled || (config.warmup.enabled && config.warmup.lock_memory)) {
+            // MCL_FUTURE: every book, queue and buffer built from here on is faulted in as it is mapped.
+            memory::lockProcessMemory();
+        }
+        if (low_jitter.enabled) {
+            // Huge page regions (hugetlb falls back to thp) keep THP; the rest of the process drops it
+            // so no fault ever waits on compaction and khugepaged never collapses engine pages.
+            const HugePageSettings& regions = config.memory;
+            const bool wants_thp = regions.ladders != HugePageMode::OFF || regions.arenas != HugePageMode::OFF ||
+                                   regions.queues != HugePageMode::OFF || regions.sockets != HugePageMode::OFF;
+            const std::string defrag = jitter::thpDefrag(config.numa.sys_root);
+            if (!wants_thp) {
+                jitter::disableTransparentHugePages();
+            } else if (defrag == "always" || defrag == "madvise") {
+                LOG_WARN("THP defrag is '{}': huge page faults may compact synchronously; prefer defer", defrag);
+            }
+            const jitter::Isolation isolation = jitter::readIsolation(config.numa.sys_root);
+            if (config.affinity.engine_cores.empty()) {
+                LOG_WARN("Low-jitter profile without [affinity] engine_cores: the engine thread is not pinned");
+            }
+            const bool isolated = jitter::checkIsolation("engine", config.affinity.engine_cores, isolation);
+            LOG_INFO("Low-jitter profile: THP {}, engine cores {}, SCHED_FIFO engine {} dispatcher {}",
+                     wants_thp ? "kept for [memory] regions" : "off", isolated ? "isolated" : "NOT isolated",
+                     low_jitter.engine_priority, low_jitter.dispatcher_priority);
+        }
+        const std::vector<InstrumentSpec> universe = loadInstrumentUniverse(config.instruments);
+        if (universe.empty()) {
+            throw std::runtime_error("No instruments configured");
+        }
+        std::vector<InstrumentToken> instruments;
+        instruments.reserve(universe.size());
+        for (const auto& spec : universe) {
+            instruments.push_back(spec.token);
+        }
 
-        std::unordered_map<InstrumentToken, std::unique_ptr<Queue>> queue_storage;
-        OrderDispatcher::QueueMap dispatcher_queues;
-        std::unordered_map<InstrumentToken, std::unique_ptr<OrderBook>> books;
+        // Threads with a configured core are built and run there; with
+        // [numa] policy=nic the rest stay on the NIC's node.
+        const numa::Topology topology = numa::discover(config.numa.sys_root);
+        int numa_node = -1;
+        if (config.numa.policy == NumaPolicy::NIC) {
+            numa_node = config.numa.node >= 0 ? config.numa.node
+                                              : numa::nicNode(config.mcast_iface, config.numa.sys_root);
+            if (numa_node < 0) {
+                LOG_WARN("No NUMA node known for iface {}; leaving unpinned threads to the scheduler",
+                         config.mcast_iface);
+            }
+            const std::pair<const char*, const std::vector<int>*> roles[] = {
+                {"engine_cores", &config.affinity.engine_cores},
+                {"dispatcher_cores", &config.affinity.dispatcher_cores},
+                {"trade_cores", &config.affinity.trade_cores},
+                {"risk_cores", &config.affinity.risk_cores},
+                {"exec_report_cores", &config.affinity.exec_report_cores},
+            };
+            for (const auto& [role, cores] : roles) {
+                const auto remote = numa::remoteCpus(topology, numa_node, *cores);
+                if (!remote.empty()) {
+                    LOG_WARN("[affinity] {} {} are not on NUMA node {} of {}", role, cpu::formatCpus(remote), numa_node,
+                             config.mcast_iface);
+                }
+            }
+        }
+        const auto placement = [&](const std::vector<int>& pinned) {
+            return numa::placeOnNode(topology, numa_node, pinned);
+        };
+        LOG_INFO("NUMA: {} nodes, policy {}, node {} ({})", topology.nodeCount(), toString(config.numa.policy),
+                 numa_node, cpu::formatCpus(placement({})));
 
         SnapshotConfig snapshot_cfg;
         snapshot_cfg.shm_prefix = config.snapshot.shm_prefix;
@@ -48,95 +149,432 @@ int main() {
         snapshot_cfg.max_levels = config.snapshot.levels;
         SnapshotPublisher publisher(snapshot_cfg, instruments);
 
-        const auto& engineCores = config.affinity.engine_cores;
-        size_t nextEngineCore = 0;
+        // One shard per engine core; a single unpinned shard when none are configured.
+        std::vector<int> shardCores = config.affinity.engine_cores;
+        if (shardCores.empty()) {
+            shardCores.push_back(-1);
+        }
+        // Declared before the shards: its feedback sinks must outlive their trade publishers,
+        // and the report sockets their report senders.
+        std::unique_ptr<risk::RiskStage> risk_stage;
+        std::vector<std::unique_ptr<SocketUtils::McastSocket>> report_sockets;
+        std::unique_ptr<ExecReportPublisher> risk_reports;
+        std::vector<std::unique_ptr<engine::EngineShard>> shards;
+        for (std::size_t idx = 0; idx < shardCores.size(); ++idx) {
+            TradePublisher::Options trade;
+            trade.mode = config.engine.trade_publisher;
+            trade.capacity = config.engine.trade_ring_capacity;
+            trade.overflow = config.engine.trade_overflow;
+            trade.wait = config.wait.trade;
+            if (idx < config.affinity.trade_cores.size()) {
+                trade.core = config.affinity.trade_cores[idx];
+            }
+            trade.cpus = placement({});
+            shards.push_back(std::make_unique<engine::EngineShard>(idx, shardCores[idx], config.engine.queue_capacity,
+                                                                  config.wait.engine, trade));
+            shards.back()->setSnapshotPublisher(&publisher);
+            shards.back()->setMigrationPause(std::chrono::microseconds(config.engine.migration_max_pause_us));
+            if (config.exec_reports.enabled) {
+                ExecReportPublisher::Options reports;
+                reports.capacity = config.exec_reports.ring_capacity;
+                reports.overflow = config.exec_reports.overflow;
+                reports.wait = config.wait.trade;
+                if (idx < config.affinity.exec_report_cores.size()) {
+                    reports.core = config.affinity.exec_report_cores[idx];
+                }
+                reports.cpus = placement({});
+                numa::runOn(placement(reports.core >= 0 ? std::vector<int>{reports.core} : std::vector<int>{}), [&] {
+                    report_sockets.push_back(std::make_unique<SocketUtils::McastSocket>());
+                    report_sockets.back()->init(config.exec_reports.mcast_ip, config.mcast_iface,
+                                                config.exec_reports.mcast_port, false);
+                });
+                auto* socket = report_sockets.back().get();
+                shards.back()->enableExecReports(reports, [socket](const char* data, std::size_t len) {
+                    socket->send(data, len);
+                    socket->sendAndRecv();
+                });
+            }
+        }
+
+        // Instruments must keep a single producer unless their queues are MPSC.
+        // Reuseport dispatchers partition instruments; group dispatchers may
+        // all see any instrument, and several dispatchers share the risk inbound.
+        const IngressSettings& ingress = config.ingress;
+        const bool shared_groups = ingress.dispatchers > 1 && ingress.mode == "groups";
+        if (shared_groups && ingress.groups.size() < ingress.dispatchers) {
+            throw std::runtime_error("[ingress] mode=groups needs one group per dispatcher");
+        }
+        const bool engine_multi_producer =
+            config.engine.multi_producer_queues || (shared_groups && !config.risk.enabled);
+        const bool risk_multi_producer = config.engine.multi_producer_queues || ingress.dispatchers > 1;
 
-        for (const auto token : instruments) {
-            auto queue = std::make_unique<Queue>(kQueueCapacity);
-            dispatcher_queues[token] = queue.get();
-            queue_storage[token] = std::move(queue);
-            books[token] = std::make_unique<OrderBook>(config.use_std_map);
-            books[token]->setInstrumentToken(token);
-            if (!engineCores.empty()) {
-                const int tradeCore = engineCores[nextEngineCore % engineCores.size()];
-                ++nextEngineCore;
-                books[token]->bindTradeThreadToCores(std::vector<int>{tradeCore});
+        auto assignment = engine::makeAssignmentPolicy(config.engine);
+        std::vector<std::vector<const InstrumentSpec*>> shard_specs(shards.size());
+        for (const auto& spec : universe) {
+            shard_specs[assignment->assign(spec, shards.size())].push_back(&spec);
+        }
+        // Books and queues are built on the shard's own core so their pages
+        // are first-touched on the node that matches on them.
+        OrderDispatcher::RouteMap dispatcher_routes;
+        std::vector<OrderBook*> books;
+        books.reserve(universe.size());
+        for (std::size_t idx = 0; idx < shards.size(); ++idx) {
+            auto& shard = *shards[idx];
+            const auto cpus = placement(shard.core() >= 0 ? std::vector<int>{shard.core()} : std::vector<int>{});
+            numa::runOn(cpus, [&] {
+                for (const InstrumentSpec* spec : shard_specs[idx]) {
+                    auto& book = shard.addInstrument(
+                        spec->token, std::make_unique<OrderBook>(config.bookBackendFor(spec->token)),
+                        engine_multi_producer);
+                    book.setInstrumentToken(spec->token);
+                    book.setPriceBands(config.priceBandsFor(spec->token));
+                    dispatcher_routes[spec->token] = shard.routeFor(spec->token);
+                    books.push_back(&book);
+                }
+            });
+        }
+
+        // With risk enabled the dispatcher feeds a single inbound queue and the
+        // risk stage forwards accepted orders to the per-instrument queues.
+        std::thread risk_thread;
+        OrderDispatcher::RouteMap ingress_routes = dispatcher_routes;
+        if (config.risk.enabled) {
+            const auto risk_cpus = placement(config.affinity.risk_cores);
+            numa::runOn(risk_cpus, [&] {
+                risk_stage = std::make_unique<risk::RiskStage>(config.risk, dispatcher_routes,
+                                                               config.engine.queue_capacity, config.wait.risk,
+                                                               risk_multi_producer);
+            });
+            for (auto* book : books) {
+                risk_stage->attachFeedback(*book);
+                ingress_routes[book->instrument_token()] = risk_stage->inboundRoute();
+            }
+            if (config.exec_reports.enabled) {
+                // Risk rejects get the stream after the dispatchers' reject streams.
+                ExecReportPublisher::Options reports;
+                reports.stream = static_cast<uint32_t>(shards.size() + ingress.dispatchers);
+                reports.capacity = config.exec_reports.ring_capacity;
+                // A reject must never hold up the orders behind it.
+                reports.overflow = TradeOverflow::DROP;
+                reports.wait = config.wait.trade;
+                reports.cpus = placement({});
+                numa::runOn(risk_cpus, [&] {
+                    report_sockets.push_back(std::make_unique<SocketUtils::McastSocket>());
+                    report_sockets.back()->init(config.exec_reports.mcast_ip, config.mcast_iface,
+                                                config.exec_reports.mcast_port, false);
+                });
+                auto* socket = report_sockets.back().get();
+                risk_reports = std::make_unique<ExecReportPublisher>(
+                    reports, [socket](const char* data, std::size_t len) {
+                        socket->send(data, len);
+                        socket->sendAndRecv();
+                    });
+                risk_stage->setRejectSink(rejectReports(*risk_reports));
+            }
+            risk_thread = std::thread([&risk_stage] {
+                risk_stage->run();
+            });
+            if (!risk_cpus.empty()) {
+                cpu::setThreadAffinity(risk_thread, risk_cpus);
             }
         }
 
-        std::vector<std::thread> workers;
-        workers.reserve(instruments.size());
+        // Load-aware migration; the balancer must be built before the shards run.
+        std::unique_ptr<engine::ShardBalancer> balancer;
+        std::thread balancer_thread;
+        if (config.engine.rebalance_interval_ms > 0 && shards.size() > 1) {
+            std::vector<engine::EngineShard*> shard_ptrs;
+            for (auto& shard : shards) {
+                shard_ptrs.push_back(shard.get());
+            }
+            balancer = std::make_unique<engine::ShardBalancer>(shard_ptrs, config.engine);
+        }
 
-        for (std::size_t idx = 0; idx < instruments.size(); ++idx) {
-            const InstrumentToken token = instruments[idx];
-            Queue* queue = dispatcher_queues[token];
-            OrderBook* book = books[token].get();
+        // Warm-up on each shard's core while nothing is live yet; the dispatchers join multicast after it.
+        if (config.warmup.enabled) {
+            for (auto& shard : shards) {
+                const auto started = std::chrono::steady_clock::now();
+                engine::WarmupResult warm;
+                numa::runOn(placement(shard->core() >= 0 ? std::vector<int>{shard->core()} : std::vector<int>{}),
+                            [&] { warm = engine::warmUpShard(*shard, config.warmup); });
+                LOG_INFO("Shard {} warmed up: {} books sized for {} orders, {} synthetic orders ({} trades) in {}ms",
+                         shard->id(), warm.books, config.warmup.expected_orders, warm.synthetic_orders,
+                         warm.synthetic_trades,
+                         std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                               started).count());
+            }
+        }
 
-            int workerCore = -1;
-            if (!engineCores.empty()) {
-                workerCore = engineCores[nextEngineCore % engineCores.size()];
-                ++nextEngineCore;
+        // OS jitter on each engine core, measured before anything runs there.
+        if (low_jitter.enabled && low_jitter.probe_ms > 0) {
+            for (int core : config.affinity.engine_cores) {
+                jitter::Probe probe;
+                numa::runOn({core}, [&] {
+                    probe = jitter::measure(std::chrono::milliseconds(low_jitter.probe_ms),
+                                            std::chrono::nanoseconds(low_jitter.probe_threshold_ns));
+                });
+                LOG_INFO("Core {} jitter: {} interruptions above {}ns in {}ms, max {}ns, {:.3f}% lost", core,
+                         probe.interruptions, low_jitter.probe_threshold_ns, probe.elapsed_ns / 1000000,
+                         probe.max_ns, probe.lostPercent());
             }
+        }
 
-            workers.emplace_back([queue, book, token, &publisher, workerCore] {
-                if (workerCore >= 0) {
-                    cpu::setCurrentThreadAffinity(std::vector<int>{workerCore});
-                }
-                while (true) {
-                    WireOrder inbound;
-                    std::size_t spins = 0;
-                    while (!queue->pop(inbound)) {
-                        if (++spins % 1000 == 0) {
-                            std::this_thread::yield();
-                        }
-                    }
-
-                    OrderBuilder builder;
-                    builder.setOrderId(inbound.order_id)
-                        .setInstrumentToken(inbound.instrument)
-                        .setSide(inbound.side)
-                        .setPrice(inbound.price)
-                        .setQuantity(inbound.quantity)
-                        .setOrderType(inbound.type)
-                        .setTimestamp(std::chrono::high_resolution_clock::now());
-
-                    if (inbound.display > 0) {
-                        builder.setDisplayQuantity(inbound.display);
-                    }
-
-                    auto order = builder.build();
-
-                    book->addOrder(std::move(order));
-                    publisher.maybePublish(token, *book);
-                }
-            });
-            if (workerCore >= 0) {
-                cpu::setThreadAffinity(workers.back(), workerCore);
+        // Shards start once every trade sink is registered.
+        std::vector<std::thread> workers;
+        workers.reserve(shards.size());
+        for (auto& shard : shards) {
+            LOG_INFO("Engine shard {} on core {} owns {} instruments", shard->id(), shard->core(), shard->instrumentCount());
+            workers.emplace_back([&shard] { shard->run(); });
+            if (shard->core() < 0 && numa_node >= 0) {
+                cpu::setThreadAffinity(workers.back(), placement({}));
             }
+            // A spinning FIFO thread owns its CPU, so only pinned threads get one.
+            if (low_jitter.enabled && low_jitter.engine_priority > 0 && shard->core() >= 0 &&
+                !cpu::setThreadRealtime(workers.back(), low_jitter.engine_priority)) {
+                LOG_WARN("Shard {} stays SCHED_OTHER: SCHED_FIFO {} refused", shard->id(), low_jitter.engine_priority);
+            }
+        }
+        if (balancer) {
+            balancer_thread = std::thread([&balancer] { balancer->run(); });
         }
 
-        SocketUtils::McastSocket socket;
-        socket.init(config.mcast_ip, config.mcast_iface, config.mcast_port, true);
-        socket.join(config.mcast_ip);
+        // Unknown instruments get a book at runtime, on the shard the assignment policy picks.
+        std::unique_ptr<ingress::OnboardingChannel> onboarding_channel;
+        std::unique_ptr<engine::InstrumentOnboarder> onboarder;
+        std::thread onboarder_thread;
+        if (ingress.onboarding) {
+            onboarding_channel = std::make_unique<ingress::OnboardingChannel>(ingress.dispatchers);
+            std::vector<engine::EngineShard*> shard_ptrs;
+            for (auto& shard : shards) {
+                shard_ptrs.push_back(shard.get());
+            }
+            onboarder = std::make_unique<engine::InstrumentOnboarder>(shard_ptrs, *onboarding_channel, config,
+                                                                      *assignment, &publisher, engine_multi_producer);
+            if (risk_stage) {
+                onboarder->setHook([&risk_stage](InstrumentToken token, OrderBook& book,
+                                                 OrderDispatcher::Route engine_route) {
+                    risk_stage->addInstrument(token, engine_route, book);
+                    return risk_stage->inboundRoute();
+                });
+            }
+            onboarder->setBalancer(balancer.get());
+            onboarder_thread = std::thread([&onboarder] { onboarder->run(); });
+            if (numa_node >= 0) {
+                cpu::setThreadAffinity(onboarder_thread, placement({}));
+            }
+        }
+
+        // One sequence across every dispatcher, so orders of all instruments are totally ordered.
+        std::unique_ptr<ingress::Sequencer> sequencer;
+        if (ingress.sequencer) {
+            sequencer = std::make_unique<ingress::Sequencer>();
+        }
+
+        // Rate limits span the dispatchers: a participant's buckets are the same whichever group it sends on.
+        std::unique_ptr<ingress::Throttle> throttle;
+        if (config.throttle.enabled) {
+            throttle = std::make_unique<ingress::Throttle>(config.throttle);
+        }
 
-        OrderDispatcher dispatcher(socket, dispatcher_queues);
-        std::thread dispatcher_thread([&dispatcher] {
-            dispatcher.run();
-        });
+        const std::vector<OrderDispatcher::RouteMap> dispatcher_route_sets = shared_groups
+            ? std::vector<OrderDispatcher::RouteMap>(ingress.dispatchers, ingress_routes)
+            : partitionRoutes(ingress_routes, instruments, ingress.dispatchers);
+        std::vector<std::unique_ptr<SocketUtils::McastSocket>> sockets;
+        // Ingress rejects leave on a report stream per dispatcher, numbered after the shards' streams;
+        // declared before the dispatchers, which publish into them.
+        std::vector<std::unique_ptr<ExecReportPublisher>> reject_reports;
+        std::vector<std::unique_ptr<OrderDispatcher>> dispatchers;
+        std::vector<std::thread> dispatcher_threads;
+        for (std::size_t idx = 0; idx < ingress.dispatchers; ++idx) {
+            const std::string& group = shared_groups ? ingress.groups[idx] : config.mcast_ip;
+            const auto cpus = placement(idx < config.affinity.dispatcher_cores.size()
+                                            ? std::vector<int>{config.affinity.dispatcher_cores[idx]}
+                                            : std::vector<int>{});
+            // The socket's receive and send buffers are first-touched on the dispatcher's node.
+            numa::runOn(cpus, [&] {
+                sockets.push_back(std::make_unique<SocketUtils::McastSocket>());
+                sockets.back()->init(group, config.mcast_iface, config.mcast_port, true, ingress.dispatchers > 1);
+                sockets.back()->join(group);
+                dispatchers.push_back(std::make_unique<OrderDispatcher>(*sockets.back(), dispatcher_route_sets[idx],
+                                                                        config.wait.dispatcher));
+                if (config.exec_reports.enabled) {
+                    report_sockets.push_back(std::make_unique<SocketUtils::McastSocket>());
+                    report_sockets.back()->init(config.exec_reports.mcast_ip, config.mcast_iface,
+                                                config.exec_reports.mcast_port, false);
+                }
+            });
+            auto* dispatcher = dispatchers.back().get();
+            OrderDispatcher::Backpressure backpressure;
+            backpressure.overflow = ingress.overflow;
+            backpressure.spill_capacity = ingress.spill_capacity;
+            backpressure.overrides = ingress.instrument_overflow;
+            if (config.exec_reports.enabled) {
+                ExecReportPublisher::Options reports;
+                reports.stream = static_cast<uint32_t>(shards.size() + idx);
+                reports.capacity = config.exec_reports.ring_capacity;
+                // A reject must never hold up the dispatcher it is relieving.
+                reports.overflow = TradeOverflow::DROP;
+                reports.wait = config.wait.trade;
+                reports.cpus = placement({});
+                auto* socket = report_sockets.back().get();
+                reject_reports.push_back(std::make_unique<ExecReportPublisher>(
+                    reports, [socket](const char* data, std::size_t len) {
+                        socket->send(data, len);
+                        socket->sendAndRecv();
+                    }));
+                dispatcher->setRejectSink(rejectReports(*reject_reports.back()));
+            }
+            dispatcher->setBackpressure(std::move(backpressure));
+            dispatcher->setThrottle(throttle.get());
+            if (onboarding_channel) {
+                OrderDispatcher::Onboarding onboarding;
+                onboarding.channel = onboarding_channel.get();
+                onboarding.index = idx;
+                // Group dispatchers may all see a new instrument; reuseport ones split them by token.
+                onboarding.owners = shared_groups ? 1 : ingress.dispatchers;
+                onboarding.buffer = ingress.onboarding_buffer;
+                onboarding.timeout = std::chrono::milliseconds(ingress.onboarding_timeout_ms);
+                dispatcher->setOnboarding(onboarding);
+            }
+            dispatcher->setSequencer(sequencer.get());
+            dispatcher_threads.emplace_back([dispatcher] {
+                dispatcher->run();
+            });
+            if (!cpus.empty()) {
+                cpu::setThreadAffinity(dispatcher_threads.back(), cpus);
+            }
+            if (low_jitter.enabled && low_jitter.dispatcher_priority > 0 &&
+                idx < config.affinity.dispatcher_cores.size() &&
+                !cpu::setThreadRealtime(dispatcher_threads.back(), low_jitter.dispatcher_priority)) {
+                LOG_WARN("Dispatcher {} stays SCHED_OTHER: SCHED_FIFO {} refused", idx,
+                         low_jitter.dispatcher_priority);
+            }
+            const auto owned = std::count_if(dispatcher_route_sets[idx].begin(), dispatcher_route_sets[idx].end(),
+                                             [](const auto& entry) { return entry.second.queue != nullptr; });
+            LOG_INFO("Dispatcher {} on group {} routes {} instruments", idx, group, owned);
+        }
 
-        LOG_INFO("Engine ready on {}:{} via iface {} (orderbook backend: {})",
+        memory::logHugePageReport();
+        LOG_INFO("Engine ready on {}:{} via iface {} ({} instruments on {} shards, {} assignment, "
+                 "{} dispatchers ({}), default orderbook backend: {}, {} overrides, pre-trade risk: {}, "
+                 "onboarding: {}, sequencer: {}, throttle: {}, exec reports: {}, engine wait: {})",
                  config.mcast_ip,
                  config.mcast_port,
                  config.mcast_iface,
-                 config.use_std_map ? "std::pmr::map" : "RingBuffer");
+                 universe.size(),
+                 shards.size(),
+                 assignment->name(),
+                 ingress.dispatchers,
+                 ingress.mode,
+                 toString(config.book_backend),
+                 config.instrument_book_backends.size(),
+                 config.risk.enabled ? "on" : "off",
+                 ingress.onboarding ? "on" : "off",
+                 ingress.sequencer ? "on" : "off",
+                 config.throttle.enabled ? toString(config.throttle.action) : "off",
+                 config.exec_reports.enabled
+                     ? config.exec_reports.mcast_ip + ":" + std::to_string(config.exec_reports.mcast_port)
+                     : std::string("off"),
+                 toString(config.wait.engine.mode));
 
         std::atomic<bool> running{true};
 
-        dispatcher_thread.join();
+        for (auto& thread : dispatcher_threads) {
+            thread.join();
+        }
         running.store(false, std::memory_order_relaxed);
+        if (onboarder) {
+            onboarder->stop();
+            onboarder_thread.join();
+        }
+        if (balancer) {
+            balancer->stop();
+            balancer_thread.join();
+        }
+        if (risk_stage) {
+            risk_stage->stop();
+            risk_thread.join();
+        }
+        for (auto& shard : shards) {
+            shard->stop();
+        }
         for (auto& worker : workers) {
             worker.join();
         }
+
+        for (const auto& shard : shards) {
+            logWaitCounters("engine shard " + std::to_string(shard->id()), config.wait.engine.mode,
+                            shard->waitStrategy().counters());
+            if (balancer) {
+                LOG_INFO("Shard {} migrations: {} in, {} out, {} aborted, max pause {}ns", shard->id(),
+                         shard->migratedIn(), shard->migratedOut(), shard->migrationAborts(),
+                         shard->maxMigrationPauseNs());
+            }
+        }
+        if (sequencer) {
+            LOG_INFO("Sequencer: {} orders stamped", sequencer->last());
+        }
+        if (onboarder) {
+            LOG_INFO("Onboarding: {} instruments created, {} refused", onboarder->onboarded(), onboarder->refused());
+        }
+        for (std::size_t idx = 0; idx < dispatchers.size(); ++idx) {
+            if (dispatchers[idx]->dropped() > 0 || dispatchers[idx]->onboarded() > 0) {
+                LOG_INFO("Dispatcher {}: {} instruments onboarded, {} orders dropped without a route", idx,
+                         dispatchers[idx]->onboarded(), dispatchers[idx]->dropped());
+            }
+            logWaitCounters("dispatcher " + std::to_string(idx), config.wait.dispatcher.mode,
+                            dispatchers[idx]->waitStrategy().counters());
+            // Only the instruments that overflowed or came within half a queue of it.
+            for (const auto& queue : dispatchers[idx]->queueStats()) {
+                if (queue.spilled > 0 || queue.dropped > 0 || queue.high_water * 2 >= queue.capacity) {
+                    LOG_INFO("  instrument {} queue ({}, overflow={}): high water {}, {} spilled, {} dropped",
+                             queue.token, queue.capacity, toString(queue.overflow), queue.high_water, queue.spilled,
+                             queue.dropped);
+                }
+            }
+            if (idx < reject_reports.size() && reject_reports[idx]->published() > 0) {
+                LOG_INFO("Dispatcher {} sent {} ingress rejects: {} dropped", idx, reject_reports[idx]->published(),
+                         reject_reports[idx]->dropped());
+            }
+        }
+        if (throttle) {
+            auto throttled = throttle->throttled();
+            std::sort(throttled.begin(), throttled.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.rejected + lhs.delayed > rhs.rejected + rhs.delayed;
+            });
+            LOG_INFO("Throttle ({}): {} participants over their rate", toString(config.throttle.action),
+                     throttled.size());
+            for (std::size_t i = 0; i < throttled.size() && i < 10; ++i) {
+                LOG_INFO("  participant {}: {} rejected, {} delayed", throttled[i].participant, throttled[i].rejected,
+                         throttled[i].delayed);
+            }
+        }
+        if (risk_stage) {
+            logWaitCounters("risk", config.wait.risk.mode, risk_stage->waitStrategy().counters());
+        }
+        if (risk_reports && risk_reports->published() > 0) {
+            LOG_INFO("Risk stage sent {} rejects: {} dropped", risk_reports->published(), risk_reports->dropped());
+        }
+        for (const auto& shard : shards) {
+            const TradePublisher& trades = shard->tradePublisher();
+            LOG_INFO("Shard {} published {} trades ({}, overflow={}): {} stalls, {} dropped, {} spilled",
+                     shard->id(), trades.published(), toString(trades.mode()), toString(trades.overflow()),
+                     trades.stalls(), trades.dropped(), trades.spilled());
+            if (const ExecReportPublisher* reports = shard->execReports()) {
+                LOG_INFO("Shard {} sent {} execution reports in {} datagrams: {} stalls, {} dropped", shard->id(),
+                         reports->published(), reports->datagrams(), reports->stalls(), reports->dropped());
+                logWaitCounters("exec report sender (shard " + std::to_string(shard->id()) + ")",
+                                config.wait.trade.mode, reports->waitStrategy().counters());
+            }
+            for (const auto& consumer : trades.consumerStats()) {
+                LOG_INFO("  trade consumer {}: {} consumed, lag {}, max lag {}", consumer.name, consumer.consumed,
+                         consumer.lag, consumer.max_lag);
+                if (trades.mode() == TradePublishMode::THREAD) {
+                    logWaitCounters("trade consumer " + consumer.name + " (shard " + std::to_string(shard->id()) + ")",
+                                    config.wait.trade.mode, consumer.waits);
+                }
+            }
+        }
     } catch (const std::exception& ex) {
         LOG_ERROR("Engine crashed: {}", ex.what());
         return 1;
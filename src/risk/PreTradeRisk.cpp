@@ -0,0 +1,224 @@
+#include "risk/PreTradeRisk.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "utils/CompilerHints.h"
+
+namespace risk {
+
+const char* toString(RiskResult result) {
+    switch (result) {
+        case RiskResult::Accepted: return "ACCEPTED";
+        case RiskResult::UnknownParticipant: return "UNKNOWN_PARTICIPANT";
+        case RiskResult::MaxOrderQty: return "MAX_ORDER_QTY";
+        case RiskResult::MaxNotional: return "MAX_NOTIONAL";
+        case RiskResult::MaxOpenOrders: return "MAX_OPEN_ORDERS";
+        case RiskResult::MaxPosition: return "MAX_POSITION";
+        case RiskResult::OrderTableFull: return "ORDER_TABLE_FULL";
+        default: return "UNKNOWN";
+    }
+}
+
+PreTradeRisk::PreTradeRisk(const RiskSettings& settings)
+    : settings_(settings),
+      participants_(settings.max_participants) {
+    const std::size_t slots = std::bit_ceil(2 * std::max<std::size_t>(settings.max_live_orders, 1));
+    orders_.resize(slots);
+    order_mask_ = slots - 1;
+    order_shift_ = 64u - static_cast<unsigned>(std::countr_zero(slots));
+}
+
+RiskResult PreTradeRisk::check(const ingress::WireOrder& order) {
+    if (UNLIKELY(order.participant >= participants_.size())) {
+        counters_[static_cast<std::size_t>(RiskResult::UnknownParticipant)].fetch_add(1, std::memory_order_relaxed);
+        return RiskResult::UnknownParticipant;
+    }
+
+    ParticipantState& state = participants_[order.participant];
+    RiskResult result = evaluate(order, state);
+    OrderState* entry = nullptr;
+    if (LIKELY(result == RiskResult::Accepted)) {
+        entry = insertOrder(order.order_id);
+        if (UNLIKELY(entry == nullptr)) {
+            result = RiskResult::OrderTableFull;
+        }
+    }
+    counters_[static_cast<std::size_t>(result)].fetch_add(1, std::memory_order_relaxed);
+    if (UNLIKELY(result != RiskResult::Accepted)) {
+        return result;
+    }
+
+    if (UNLIKELY(entry->used)) {
+        // A reused live id replaces the old order; drop what it still held.
+        release(*entry, entry->remaining);
+        entry = insertOrder(order.order_id);
+    }
+
+    // Only resting order types hold open exposure; IOC/FOK/MARKET remainders
+    // are cancelled by the engine and would otherwise leak reservations.
+    const bool rests = order.type == OrderType::LIMIT || order.type == OrderType::ICEBERG;
+    if (rests) {
+        ++state.open_orders;
+        if (order.side == Side::BUY) {
+            state.open_buy_qty += order.quantity;
+        } else {
+            state.open_sell_qty += order.quantity;
+        }
+    }
+
+    *entry = {order.order_id, order.participant, order.quantity, order.side, rests, true};
+    ++live_orders_;
+    return RiskResult::Accepted;
+}
+
+RiskResult PreTradeRisk::evaluate(const ingress::WireOrder& order, const ParticipantState& state) const {
+    const uint64_t qty = order.quantity;
+    if (settings_.max_order_qty != 0 && qty > settings_.max_order_qty) {
+        return RiskResult::MaxOrderQty;
+    }
+    if (settings_.max_notional != 0 && order.price != 0 && qty > settings_.max_notional / order.price) {
+        return RiskResult::MaxNotional;
+    }
+    if (settings_.max_open_orders != 0 && state.open_orders >= settings_.max_open_orders) {
+        return RiskResult::MaxOpenOrders;
+    }
+    if (settings_.max_position != 0) {
+        // Worst case: every open order on this side fills along with the new one.
+        const auto limit = static_cast<int64_t>(settings_.max_position);
+        if (order.side == Side::BUY) {
+            const int64_t worst = state.position + static_cast<int64_t>(state.open_buy_qty + qty);
+            if (worst > limit) {
+                return RiskResult::MaxPosition;
+            }
+        } else {
+            const int64_t worst = state.position - static_cast<int64_t>(state.open_sell_qty + qty);
+            if (worst < -limit) {
+                return RiskResult::MaxPosition;
+            }
+        }
+    }
+    return RiskResult::Accepted;
+}
+
+void PreTradeRisk::onTrade(const TradeEvent& event) {
+    applyFill(event.aggressorId, event.quantity);
+    applyFill(event.restingOrderId, event.quantity);
+}
+
+void PreTradeRisk::onLeavesChange(OrderId orderId, int64_t delta) {
+    OrderState* order = findOrder(orderId);
+    if (order == nullptr) {
+        return;
+    }
+    if (delta < 0) {
+        // Unseen fills only leave risk holding more than the engine gave up.
+        const auto given_up = static_cast<uint64_t>(-delta);
+        release(*order, given_up < order->remaining ? static_cast<Qty>(given_up) : order->remaining);
+        return;
+    }
+    const auto added = static_cast<Qty>(delta);
+    order->remaining += added;
+    if (order->rests) {
+        ParticipantState& state = participants_[order->participant];
+        if (order->side == Side::BUY) {
+            state.open_buy_qty += added;
+        } else {
+            state.open_sell_qty += added;
+        }
+    }
+}
+
+void PreTradeRisk::applyFill(OrderId orderId, Qty qty) {
+    OrderState* order = findOrder(orderId);
+    if (order == nullptr) {
+        return;
+    }
+    const Qty filled = std::min(qty, order->remaining);
+    ParticipantState& state = participants_[order->participant];
+    if (order->side == Side::BUY) {
+        state.position += filled;
+    } else {
+        state.position -= filled;
+    }
+    release(*order, filled);
+}
+
+void PreTradeRisk::release(OrderState& order, Qty qty) {
+    order.remaining -= qty;
+    ParticipantState& state = participants_[order.participant];
+    if (order.rests) {
+        if (order.side == Side::BUY) {
+            state.open_buy_qty -= qty;
+        } else {
+            state.open_sell_qty -= qty;
+        }
+        if (order.remaining == 0 && state.open_orders > 0) {
+            --state.open_orders;
+        }
+    }
+    if (order.remaining == 0) {
+        eraseOrder(order);
+    }
+}
+
+int64_t PreTradeRisk::position(ParticipantId participant) const {
+    return participant < participants_.size() ? participants_[participant].position : 0;
+}
+
+uint32_t PreTradeRisk::openOrders(ParticipantId participant) const {
+    return participant < participants_.size() ? participants_[participant].open_orders : 0;
+}
+
+uint64_t PreTradeRisk::rejected(RiskResult reason) const {
+    if (reason == RiskResult::Accepted) {
+        return 0;
+    }
+    return counters_[static_cast<std::size_t>(reason)].load(std::memory_order_relaxed);
+}
+
+uint64_t PreTradeRisk::accepted() const {
+    return counters_[static_cast<std::size_t>(RiskResult::Accepted)].load(std::memory_order_relaxed);
+}
+
+std::size_t PreTradeRisk::homeSlot(OrderId orderId) const {
+    return static_cast<std::size_t>((static_cast<uint64_t>(orderId) * 0x9E3779B97F4A7C15ull) >> order_shift_);
+}
+
+PreTradeRisk::OrderState* PreTradeRisk::findOrder(OrderId orderId) {
+    for (std::size_t slot = homeSlot(orderId); orders_[slot].used; slot = (slot + 1) & order_mask_) {
+        if (orders_[slot].order_id == orderId) {
+            return &orders_[slot];
+        }
+    }
+    return nullptr;
+}
+
+PreTradeRisk::OrderState* PreTradeRisk::insertOrder(OrderId orderId) {
+    std::size_t slot = homeSlot(orderId);
+    for (; orders_[slot].used; slot = (slot + 1) & order_mask_) {
+        if (orders_[slot].order_id == orderId) {
+            return &orders_[slot];
+        }
+    }
+    if (live_orders_ >= std::max<std::size_t>(settings_.max_live_orders, 1)) {
+        return nullptr;
+    }
+    return &orders_[slot];
+}
+
+void PreTradeRisk::eraseOrder(OrderState& order) {
+    // Backward-shift deletion keeps every probe chain unbroken without tombstones.
+    auto hole = static_cast<std::size_t>(&order - orders_.data());
+    for (std::size_t next = (hole + 1) & order_mask_; orders_[next].used; next = (next + 1) & order_mask_) {
+        const std::size_t home = homeSlot(orders_[next].order_id);
+        if (((next - home) & order_mask_) >= ((next - hole) & order_mask_)) {
+            orders_[hole] = orders_[next];
+            hole = next;
+        }
+    }
+    orders_[hole] = OrderState{};
+    --live_orders_;
+}
+
+}  // namespace risk
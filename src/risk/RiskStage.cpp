@@ -0,0 +1,182 @@
+#include "risk/RiskStage.h"
+
+#include <thread>
+#include <utility>
+
+#include "utils/LogMacros.h"
+
+namespace risk {
+
+RiskStage::RiskStage(const RiskSettings& settings, RouteMap routes, std::size_t queue_capacity,
+                     const WaitSettings& wait, bool multi_producer_inbound)
+    : risk_(settings),
+      routes_(std::move(routes)),
+      inbound_(queue_capacity, multi_producer_inbound),
+      wait_(wait),
+      queue_capacity_(queue_capacity) {
+    inbound_.setConsumer(&wait_);
+}
+
+RiskStage::FeedbackSink& RiskStage::makeFeedbackSink(FeedbackQueue& queue, LeavesQueue& leaves) {
+    feedback_sinks_.push_back(std::make_unique<FeedbackSink>(FeedbackSink{queue, leaves, wait_}));
+    return *feedback_sinks_.back();
+}
+
+void RiskStage::attachFeedback(OrderBook& book) {
+    feedback_.push_back(std::make_unique<FeedbackQueue>(queue_capacity_));
+    leaves_.push_back(std::make_unique<LeavesQueue>(queue_capacity_));
+    FeedbackSink& sink = makeFeedbackSink(*feedback_.back(), *leaves_.back());
+    book.addTradeSink(sink);
+    book.setLeavesHook(&FeedbackSink::onLeaves, &sink);
+}
+
+void RiskStage::addInstrument(InstrumentToken token, OrderDispatcher::Route route, OrderBook& book) {
+    auto queue = std::make_unique<FeedbackQueue>(queue_capacity_);
+    auto leaves = std::make_unique<LeavesQueue>(queue_capacity_);
+    std::lock_guard<std::mutex> lock(added_mutex_);
+    FeedbackSink& sink = makeFeedbackSink(*queue, *leaves);
+    book.addTradeSink(sink);
+    book.setLeavesHook(&FeedbackSink::onLeaves, &sink);
+    added_feedback_.push_back(std::move(queue));
+    added_leaves_.push_back(std::move(leaves));
+    added_routes_.emplace_back(token, route);
+    added_pending_.store(true, std::memory_order_release);
+}
+
+bool RiskStage::mergeAdded() {
+    if (!added_pending_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(added_mutex_);
+    for (const auto& [token, route] : added_routes_) {
+        routes_[token] = route;
+    }
+    for (auto& queue : added_feedback_) {
+        feedback_.push_back(std::move(queue));
+    }
+    for (auto& queue : added_leaves_) {
+        leaves_.push_back(std::move(queue));
+    }
+    added_routes_.clear();
+    added_feedback_.clear();
+    added_leaves_.clear();
+    added_pending_.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+void RiskStage::FeedbackSink::onTrades(TradeBatch trades) {
+    // Fills must not be lost, so a full queue holds the trade thread.
+    std::size_t pushed = 0;
+    std::size_t spins = 0;
+    while (pushed < trades.size()) {
+        pushed += queue.try_push_n(trades.data() + pushed, trades.size() - pushed);
+        if (pushed < trades.size() && ++spins % 1000 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    consumer.notify();
+}
+
+void RiskStage::FeedbackSink::onLeaves(void* context, OrderId orderId, int64_t delta) {
+    auto& sink = *static_cast<FeedbackSink*>(context);
+    // Like fills, a lost change would leave the reservation wrong for good.
+    std::size_t spins = 0;
+    while (!sink.leaves.push(LeavesChange{orderId, delta})) {
+        if (++spins % 1000 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    sink.consumer.notify();
+}
+
+void RiskStage::run() {
+    while (running_.load(std::memory_order_relaxed)) {
+        mergeAdded();
+        drainFeedback();
+
+        ingress::WireOrder order;
+        if (!inbound_.pop(order)) {
+            wait_.idle([this] { return hasInput(); });
+            continue;
+        }
+        wait_.reset();
+
+        // Route first: check() reserves exposure that only the engine releases.
+        auto it = routes_.find(order.instrument);
+        if (it == routes_.end()) {
+            // The dispatcher may have learned the route before this loop merged it.
+            if (!mergeAdded() || (it = routes_.find(order.instrument)) == routes_.end()) {
+                continue;
+            }
+        }
+
+        const RiskResult result = risk_.check(order);
+        if (result != RiskResult::Accepted) {
+            LOG_DEBUG("Risk reject order {} participant {}: {}", order.order_id, order.participant, toString(result));
+            if (reject_sink_) {
+                reject_sink_(order, ExecReason::RISK);
+            }
+            continue;
+        }
+
+        auto& route = it->second;
+        while (!route.queue->push(order)) {
+            drainFeedback();
+            wait_.idle([&route] { return route.queue->write_available() > 0; });
+        }
+        wait_.reset();
+        route.queue->notifyConsumer();
+    }
+}
+
+void RiskStage::stop() {
+    running_.store(false, std::memory_order_relaxed);
+    wait_.notify();
+}
+
+bool RiskStage::hasInput() const {
+    if (!running_.load(std::memory_order_relaxed) || inbound_.read_available() > 0 ||
+        added_pending_.load(std::memory_order_acquire)) {
+        return true;
+    }
+    for (const auto& queue : feedback_) {
+        if (queue->read_available() > 0) {
+            return true;
+        }
+    }
+    for (const auto& queue : leaves_) {
+        if (queue->read_available() > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RiskStage::drainFeedback() {
+    for (std::size_t i = 0; i < feedback_.size(); ++i) {
+        // Count the fills first: the matching thread queued every leaves
+        // change that precedes them, so applying the changes before those
+        // fills never lets a fill overtake a modify that added quantity.
+        FeedbackQueue& fills = *feedback_[i];
+        std::size_t ready = fills.read_available();
+
+        LeavesQueue& leaves = *leaves_[i];
+        for (auto changes = leaves.peek(leaves.capacity()); !changes.empty(); changes = leaves.peek(leaves.capacity())) {
+            for (const LeavesChange& change : changes) {
+                risk_.onLeavesChange(change.order_id, change.delta);
+            }
+            leaves.release(changes.size());
+        }
+
+        while (ready > 0) {
+            const auto events = fills.peek(ready);
+            for (const TradeEvent& event : events) {
+                risk_.onTrade(event);
+            }
+            fills.release(events.size());
+            ready -= events.size();
+        }
+    }
+}
+
+}  // namespace risk
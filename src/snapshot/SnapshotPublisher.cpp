@@ -24,60 +24,81 @@ SnapshotPublisher::SnapshotPublisher(const SnapshotConfig& config,
         config_.max_levels = 1;
     }
     for (auto token : tokens) {
-        Region region;
-        const std::string name = regionName(config_.shm_prefix, token);
-        region.size = snapshot::snapshotBytes(config_.max_levels);
-        region.fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0660);
-        if (region.fd == -1) {
-            LOG_WARN("Failed to open shm {}: {}", name, strerror(errno));
-            continue;
-        }
-        if (::ftruncate(region.fd, static_cast<off_t>(region.size)) == -1) {
-            LOG_WARN("ftruncate failed for {}: {}", name, strerror(errno));
-            ::close(region.fd);
-            continue;
-        }
-        void* addr = ::mmap(nullptr, region.size, PROT_READ | PROT_WRITE, MAP_SHARED, region.fd, 0);
-        if (addr == MAP_FAILED) {
-            LOG_WARN("mmap failed for {}: {}", name, strerror(errno));
-            ::close(region.fd);
-            continue;
-        }
-        region.ptr = static_cast<snapshot::SharedSnapshot*>(addr);
-        region.ptr->max_levels = static_cast<uint32_t>(config_.max_levels);
-        region.ptr->bid_count = 0;
-        region.ptr->ask_count = 0;
-        region.ptr->ltp = 0.0;
-        region.ptr->ltq = 0.0;
-        region.ptr->sequence.store(0, std::memory_order_relaxed);
-        region.next_publish = steady_clock::now();
-        regions_[token] = region;
+        addInstrument(token);
     }
 }
 
 SnapshotPublisher::~SnapshotPublisher() {
     for (auto& [token, region] : regions_) {
-        if (region.ptr && region.ptr != MAP_FAILED) {
-            ::munmap(region.ptr, region.size);
+        if (region->ptr && region->ptr != MAP_FAILED) {
+            ::munmap(region->ptr, region->size);
         }
-        if (region.fd != -1) {
-            ::close(region.fd);
+        if (region->fd != -1) {
+            ::close(region->fd);
         }
     }
 }
 
-void SnapshotPublisher::maybePublish(InstrumentToken token, const OrderBook& book) {
+SnapshotPublisher::Region* SnapshotPublisher::addInstrument(InstrumentToken token) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = regions_.find(token);
+    if (it != regions_.end()) {
+        return it->second.get();
+    }
+    auto region = openRegion(token);
+    if (!region) {
+        return nullptr;
+    }
+    return regions_.emplace(token, std::move(region)).first->second.get();
+}
+
+SnapshotPublisher::Region* SnapshotPublisher::regionFor(InstrumentToken token) {
+    std::lock_guard<std::mutex> lock(mutex_);
     auto it = regions_.find(token);
-    if (it == regions_.end()) {
+    return it == regions_.end() ? nullptr : it->second.get();
+}
+
+std::unique_ptr<SnapshotPublisher::Region> SnapshotPublisher::openRegion(InstrumentToken token) const {
+    auto region = std::make_unique<Region>();
+    const std::string name = regionName(config_.shm_prefix, token);
+    region->size = snapshot::snapshotBytes(config_.max_levels);
+    region->fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0660);
+    if (region->fd == -1) {
+        LOG_WARN("Failed to open shm {}: {}", name, strerror(errno));
+        return nullptr;
+    }
+    if (::ftruncate(region->fd, static_cast<off_t>(region->size)) == -1) {
+        LOG_WARN("ftruncate failed for {}: {}", name, strerror(errno));
+        ::close(region->fd);
+        return nullptr;
+    }
+    void* addr = ::mmap(nullptr, region->size, PROT_READ | PROT_WRITE, MAP_SHARED, region->fd, 0);
+    if (addr == MAP_FAILED) {
+        LOG_WARN("mmap failed for {}: {}", name, strerror(errno));
+        ::close(region->fd);
+        return nullptr;
+    }
+    region->ptr = static_cast<snapshot::SharedSnapshot*>(addr);
+    region->ptr->max_levels = static_cast<uint32_t>(config_.max_levels);
+    region->ptr->bid_count = 0;
+    region->ptr->ask_count = 0;
+    region->ptr->ltp = 0.0;
+    region->ptr->ltq = 0.0;
+    region->ptr->sequence.store(0, std::memory_order_relaxed);
+    region->next_publish = steady_clock::now();
+    return region;
+}
+
+void SnapshotPublisher::maybePublish(Region* region, const OrderBook& book) {
+    if (region == nullptr) {
         return;
     }
-    Region& region = it->second;
-    const auto now = std::chrono::steady_clock::now();
-    if (now < region.next_publish) {
+    const auto now = steady_clock::now();
+    if (now < region->next_publish) {
         return;
     }
-    region.next_publish = now + config_.interval;
-    publishNow(region, book);
+    region->next_publish = now + config_.interval;
+    publishNow(*region, book);
 }
 
 void SnapshotPublisher::publishNow(Region& region, const OrderBook& book) {
@@ -118,14 +139,18 @@ void SnapshotPublisher::publishNow(Region& region, const OrderBook& book) {
     header->timestamp_ns = static_cast<uint64_t>(ts);
     header->ltp = static_cast<double>(book.last_trade_price());
     header->ltq = static_cast<double>(book.last_trade_quantity());
+    header->last_sequence = book.lastSequence();
     header->sequence.fetch_add(1, std::memory_order_release);
 }
 
 std::string SnapshotPublisher::regionName(const std::string& prefix, InstrumentToken token) {
-    std::string name = prefix;
-    if (name.empty() || name[0] != '/') {
-        name = "/" + name;
+    // Built by appending only: GCC's -Wrestrict misfires on name = "/" + name at -O3.
+    std::string name;
+    if (prefix.empty() || prefix[0] != '/') {
+        name += '/';
     }
-    name += "_" + std::to_string(token);
+    name += prefix;
+    name += '_';
+    name += std::to_string(token);
     return name;
 }
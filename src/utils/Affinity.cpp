@@ -4,6 +4,7 @@
 #include <sched.h>
 
 #include <algorithm>
+#include <cctype>
 
 namespace {
 
@@ -26,6 +27,54 @@ inline bool applyAffinity(pthread_t handle, const std::vector<int>& cpus) {
 
 namespace cpu {
 
+std::vector<int> parseCpuList(const std::string& spec) {
+    const auto trim = [](const std::string& input) {
+        const auto begin = std::find_if_not(input.begin(), input.end(), [](unsigned char ch) {
+            return std::isspace(ch) != 0;
+        });
+        const auto end = std::find_if_not(input.rbegin(), input.rend(), [](unsigned char ch) {
+            return std::isspace(ch) != 0;
+        }).base();
+        return begin >= end ? std::string() : std::string(begin, end);
+    };
+    std::vector<int> cpus;
+    size_t start = 0;
+    while (start < spec.size()) {
+        size_t end = spec.find(',', start);
+        if (end == std::string::npos) {
+            end = spec.size();
+        }
+        std::string token = trim(spec.substr(start, end - start));
+        if (!token.empty()) {
+            const auto dash = token.find('-');
+            if (dash == std::string::npos) {
+                cpus.push_back(std::stoi(token));
+            } else {
+                const int begin = std::stoi(token.substr(0, dash));
+                const int finish = std::stoi(token.substr(dash + 1));
+                if (finish >= begin) {
+                    for (int cpu = begin; cpu <= finish; ++cpu) {
+                        cpus.push_back(cpu);
+                    }
+                }
+            }
+        }
+        start = end + 1;
+    }
+    return cpus;
+}
+
+std::string formatCpus(const std::vector<int>& cpus) {
+    std::string out;
+    for (int cpu : cpus) {
+        if (!out.empty()) {
+            out += ',';
+        }
+        out += std::to_string(cpu);
+    }
+    return out;
+}
+
 bool setCurrentThreadAffinity(const std::vector<int>& cpus) {
     return applyAffinity(pthread_self(), cpus);
 }
@@ -44,4 +93,14 @@ bool setThreadAffinity(std::thread& thread, int cpu) {
     return setThreadAffinity(thread, std::vector<int>{cpu});
 }
 
+bool setThreadRealtime(std::thread& thread, int priority) {
+    if (!thread.joinable() || priority < sched_get_priority_min(SCHED_FIFO) ||
+        priority > sched_get_priority_max(SCHED_FIFO)) {
+        return false;
+    }
+    sched_param param{};
+    param.sched_priority = priority;
+    return pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &param) == 0;
+}
+
 }  // namespace cpu
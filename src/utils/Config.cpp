@@ -2,10 +2,13 @@
 
 #include <algorithm>
 #include <cctype>
+#include <filesystem>
 #include <fstream>
 #include <stdexcept>
 #include <vector>
 
+#include "utils/Affinity.h"
+
 namespace {
 
 inline std::string trim(const std::string& input) {
@@ -25,34 +28,148 @@ inline bool startsWith(const std::string& text, char c) {
     return !text.empty() && text.front() == c;
 }
 
-} // namespace
+bool parsePriceBandKey(const std::string& key, const std::string& value, PriceBandSettings& bands) {
+    if (key == "reference_price") {
+        bands.reference_price = static_cast<Price>(std::stoull(value));
+    } else if (key == "static_band_bps") {
+        bands.static_band_bps = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "dynamic_band_bps") {
+        bands.dynamic_band_bps = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "volatility_move_bps") {
+        bands.volatility_move_bps = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "volatility_window_ms") {
+        bands.volatility_window_ms = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "halt_ms") {
+        bands.halt_ms = static_cast<uint32_t>(std::stoul(value));
+    } else {
+        return false;
+    }
+    return true;
+}
+
+BookBackend parseBookBackend(const std::string& value) {
+    if (value == "ring") return BookBackend::RING;
+    if (value == "rbtree") return BookBackend::RB_TREE;
+    if (value == "std_map") return BookBackend::STD_MAP;
+    if (value == "chunk_map") return BookBackend::CHUNK_MAP;
+    throw std::runtime_error("Unknown orderbook backend: " + value);
+}
+
+WaitMode parseWaitMode(const std::string& value) {
+    if (value == "busy_spin") return WaitMode::BUSY_SPIN;
+    if (value == "spin_yield") return WaitMode::SPIN_YIELD;
+    if (value == "spin_park") return WaitMode::SPIN_PARK;
+    if (value == "backoff") return WaitMode::BACKOFF;
+    throw std::runtime_error("Unknown wait strategy: " + value);
+}
+
+TradePublishMode parseTradePublishMode(const std::string& value) {
+    if (value == "thread") return TradePublishMode::THREAD;
+    if (value == "inline") return TradePublishMode::INLINE;
+    throw std::runtime_error("Unknown trade_publisher value: " + value);
+}
+
+TradeOverflow parseTradeOverflow(const std::string& value) {
+    if (value == "block") return TradeOverflow::BLOCK;
+    if (value == "drop") return TradeOverflow::DROP;
+    if (value == "spill") return TradeOverflow::SPILL;
+    throw std::runtime_error("Unknown trade_overflow value: " + value);
+}
+
+IngressOverflow parseIngressOverflow(const std::string& value) {
+    if (value == "block") return IngressOverflow::BLOCK;
+    if (value == "spill") return IngressOverflow::SPILL;
+    if (value == "drop") return IngressOverflow::DROP;
+    throw std::runtime_error("Unknown ingress overflow value: " + value);
+}
+
+ThrottleAction parseThrottleAction(const std::string& value) {
+    if (value == "reject") return ThrottleAction::REJECT;
+    if (value == "delay") return ThrottleAction::DELAY;
+    throw std::runtime_error("Unknown throttle action: " + value);
+}
 
-std::vector<int> parseCpuList(const std::string& spec) {
-    std::vector<int> cpus;
+HugePageMode parseHugePageMode(const std::string& value) {
+    if (value == "off") return HugePageMode::OFF;
+    if (value == "thp") return HugePageMode::THP;
+    if (value == "hugetlb") return HugePageMode::HUGETLB;
+    throw std::runtime_error("Unknown huge page mode: " + value);
+}
+
+NumaPolicy parseNumaPolicy(const std::string& value) {
+    if (value == "off") return NumaPolicy::OFF;
+    if (value == "nic") return NumaPolicy::NIC;
+    throw std::runtime_error("Unknown numa policy: " + value);
+}
+
+void parseWaitKey(const std::string& key, const std::string& value, WaitSettings& wait) {
+    if (key == "strategy") {
+        wait.mode = parseWaitMode(value);
+    } else if (key == "spin_limit") {
+        wait.spin_limit = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "park_timeout_us") {
+        wait.park_timeout_us = static_cast<uint32_t>(std::stoul(value));
+    } else if (key == "backoff_max_us") {
+        wait.backoff_max_us = static_cast<uint32_t>(std::stoul(value));
+    }
+}
+
+WaitSettings& waitRole(ThreadWaitSettings& wait, const std::string& role) {
+    if (role == "engine") return wait.engine;
+    if (role == "dispatcher") return wait.dispatcher;
+    if (role == "trade") return wait.trade;
+    if (role == "risk") return wait.risk;
+    throw std::runtime_error("Unknown wait role: " + role);
+}
+
+std::vector<std::string> parseStringList(const std::string& spec) {
+    std::vector<std::string> items;
     size_t start = 0;
     while (start < spec.size()) {
         size_t end = spec.find(',', start);
         if (end == std::string::npos) {
             end = spec.size();
         }
-        std::string token = trim(spec.substr(start, end - start));
+        std::string item = trim(spec.substr(start, end - start));
+        if (!item.empty()) {
+            items.push_back(std::move(item));
+        }
+        start = end + 1;
+    }
+    return items;
+}
+
+std::vector<InstrumentToken> parseTokenList(const std::string& spec) {
+    std::vector<InstrumentToken> tokens;
+    size_t start = 0;
+    while (start < spec.size()) {
+        size_t end = spec.find(',', start);
+        if (end == std::string::npos) {
+            end = spec.size();
+        }
+        const std::string token = trim(spec.substr(start, end - start));
         if (!token.empty()) {
-            const auto dash = token.find('-');
-            if (dash == std::string::npos) {
-                cpus.push_back(std::stoi(token));
-            } else {
-                const int begin = std::stoi(token.substr(0, dash));
-                const int finish = std::stoi(token.substr(dash + 1));
-                if (finish >= begin) {
-                    for (int cpu = begin; cpu <= finish; ++cpu) {
-                        cpus.push_back(cpu);
-                    }
-                }
-            }
+            tokens.push_back(static_cast<InstrumentToken>(std::stoul(token)));
         }
         start = end + 1;
     }
-    return cpus;
+    return tokens;
+}
+
+constexpr const char* kPriceBandOverridePrefix = "price_bands.";
+constexpr const char* kOrderBookOverridePrefix = "orderbook.";
+constexpr const char* kWaitRolePrefix = "wait.";
+
+} // namespace
+
+const PriceBandSettings& AppConfig::priceBandsFor(InstrumentToken token) const {
+    auto it = instrument_price_bands.find(token);
+    return it != instrument_price_bands.end() ? it->second : price_bands;
+}
+
+BookBackend AppConfig::bookBackendFor(InstrumentToken token) const {
+    auto it = instrument_book_backends.find(token);
+    return it != instrument_book_backends.end() ? it->second : book_backend;
 }
 
 AppConfig loadConfig(const std::string& path) {
@@ -104,6 +221,17 @@ AppConfig loadConfig(const std::string& path) {
         } else if (section == "orderbook") {
             if (key == "use_std_map") {
                 config.use_std_map = (value == "1" || value == "true" || value == "TRUE");
+                if (config.use_std_map) {
+                    config.book_backend = BookBackend::STD_MAP;
+                }
+            } else if (key == "backend") {
+                config.book_backend = parseBookBackend(value);
+            }
+        } else if (section.rfind(kOrderBookOverridePrefix, 0) == 0) {
+            const auto token = static_cast<InstrumentToken>(
+                std::stoul(section.substr(std::char_traits<char>::length(kOrderBookOverridePrefix))));
+            if (key == "backend") {
+                config.instrument_book_backends[token] = parseBookBackend(value);
             }
         } else if (section == "logging") {
             if (key == "queue_size") {
@@ -113,9 +241,194 @@ AppConfig loadConfig(const std::string& path) {
             }
         } else if (section == "affinity") {
             if (key == "logging_cores") {
-                config.affinity.logging_cores = parseCpuList(value);
+                config.affinity.logging_cores = cpu::parseCpuList(value);
             } else if (key == "engine_cores") {
-                config.affinity.engine_cores = parseCpuList(value);
+                config.affinity.engine_cores = cpu::parseCpuList(value);
+            } else if (key == "risk_cores") {
+                config.affinity.risk_cores = cpu::parseCpuList(value);
+            } else if (key == "dispatcher_cores") {
+                config.affinity.dispatcher_cores = cpu::parseCpuList(value);
+            } else if (key == "trade_cores") {
+                config.affinity.trade_cores = cpu::parseCpuList(value);
+            } else if (key == "exec_report_cores") {
+                config.affinity.exec_report_cores = cpu::parseCpuList(value);
+            }
+        } else if (section == "memory") {
+            if (key == "ladders") {
+                config.memory.ladders = parseHugePageMode(value);
+            } else if (key == "arenas") {
+                config.memory.arenas = parseHugePageMode(value);
+            } else if (key == "queues") {
+                config.memory.queues = parseHugePageMode(value);
+            } else if (key == "socket_buffers") {
+                config.memory.sockets = parseHugePageMode(value);
+            }
+        } else if (section == "numa") {
+            if (key == "policy") {
+                config.numa.policy = parseNumaPolicy(value);
+            } else if (key == "node") {
+                config.numa.node = std::stoi(value);
+            } else if (key == "sys_root") {
+                config.numa.sys_root = value;
+            }
+        } else if (section == "instruments") {
+            if (key == "tokens") {
+                config.instruments.tokens = parseTokenList(value);
+            } else if (key == "csv") {
+                std::filesystem::path csv(value);
+                if (csv.is_relative()) {
+                    csv = std::filesystem::path(path).parent_path() / csv;
+                }
+                config.instruments.csv_path = csv.string();
+            }
+        } else if (section == "engine") {
+            if (key == "assignment") {
+                config.engine.assignment = value;
+            } else if (key == "queue_capacity") {
+                config.engine.queue_capacity = static_cast<std::size_t>(std::stoul(value));
+            } else if (key == "queue_producers") {
+                if (value != "single" && value != "multi") {
+                    throw std::runtime_error("Unknown queue_producers value: " + value);
+                }
+                config.engine.multi_producer_queues = (value == "multi");
+            } else if (key == "trade_publisher") {
+                config.engine.trade_publisher = parseTradePublishMode(value);
+            } else if (key == "trade_ring_capacity") {
+                config.engine.trade_ring_capacity = static_cast<std::size_t>(std::stoul(value));
+            } else if (key == "trade_overflow") {
+                config.engine.trade_overflow = parseTradeOverflow(value);
+            } else if (key == "rebalance_interval_ms") {
+                config.engine.rebalance_interval_ms = static_cast<uint32_t>(std::stoul(value));
+            } else if (key == "rebalance_ratio") {
+                config.engine.rebalance_ratio = std::stod(value);
+            } else if (key == "rebalance_min_load") {
+                config.engine.rebalance_min_load = std::stoull(value);
+            } else if (key == "migration_max_pause_us") {
+                config.engine.migration_max_pause_us = static_cast<uint32_t>(std::stoul(value));
+            }
+        } else if (section == "engine.pins") {
+            config.engine.pins[static_cast<InstrumentToken>(std::stoul(key))] =
+                static_cast<std::size_t>(std::stoul(value));
+        } else if (section == "ingress.overflow") {
+            config.ingress.instrument_overflow[static_cast<InstrumentToken>(std::stoul(key))] =
+                parseIngressOverflow(value);
+        } else if (section == "ingress") {
+            if (key == "dispatchers") {
+                config.ingress.dispatchers = std::max<std::size_t>(1, static_cast<std::size_t>(std::stoul(value)));
+            } else if (key == "mode") {
+                if (value != "reuseport" && value != "groups") {
+                    throw std::runtime_error("Unknown ingress mode: " + value);
+                }
+                config.ingress.mode = value;
+            } else if (key == "groups") {
+                config.ingress.groups = parseStringList(value);
+            } else if (key == "onboarding") {
+                config.ingress.onboarding = (value == "1" || value == "true" || value == "TRUE");
+            } else if (key == "onboarding_buffer") {
+                config.ingress.onboarding_buffer = static_cast<std::size_t>(std::stoul(value));
+            } else if (key == "onboarding_timeout_ms") {
+                config.ingress.onboarding_timeout_ms = static_cast<uint32_t>(std::stoul(value));
+            } else if (key == "onboarding_max_instruments") {
+                config.ingress.onboarding_max_instruments = static_cast<std::size_t>(std::stoul(value));
+            } else if (key == "sequencer") {
+                config.ingress.sequencer = (value == "1" || value == "true" || value == "TRUE");
+            } else if (key == "overflow") {
+                config.ingress.overflow = parseIngressOverflow(value);
+            } else if (key == "spill_capacity") {
+                config.ingress.spill_capacity = static_cast<std::size_t>(std::stoul(value));
+            }
+        } else if (section == "throttle.participants") {
+            config.throttle.participant_rates[static_cast<ParticipantId>(std::stoul(key))] = std::stoull(value);
+        } else if (section == "throttle") {
+            if (key == "enabled") {
+                config.throttle.enabled = (value == "1" || value == "true" || value == "TRUE");
+            } else if (key == "max_participants") {
+                config.throttle.max_participants = static_cast<uint32_t>(std::stoul(value));
+            } else if (key == "participant_rate") {
+                config.throttle.participant_rate = std::stoull(value);
+            } else if (key == "participant_burst") {
+                config.throttle.participant_burst = static_cast<uint32_t>(std::stoul(value));
+            } else if (key == "instrument_rate") {
+                config.throttle.instrument_rate = std::stoull(value);
+            } else if (key == "instrument_burst") {
+                config.throttle.instrument_burst = static_cast<uint32_t>(std::stoul(value));
+            } else if (key == "action") {
+                config.throttle.action = parseThrottleAction(value);
+            } else if (key == "max_delay_us") {
+                config.throttle.max_delay_us = static_cast<uint32_t>(std::stoul(value));
+            } else if (key == "delay_capacity") {
+                config.throttle.delay_capacity = static_cast<std::size_t>(std::stoul(value));
+            }
+        } else if (section == "exec_reports") {
+            if (key == "enabled") {
+                config.exec_reports.enabled = (value == "1" || value == "true" || value == "TRUE");
+            } else if (key == "mcast_ip") {
+                config.exec_reports.mcast_ip = value;
+            } else if (key == "mcast_port") {
+                config.exec_reports.mcast_port = std::stoi(value);
+            } else if (key == "ring_capacity") {
+                config.exec_reports.ring_capacity = static_cast<std::size_t>(std::stoul(value));
+            } else if (key == "overflow") {
+                config.exec_reports.overflow = parseTradeOverflow(value);
+                if (config.exec_reports.overflow == TradeOverflow::SPILL) {
+                    throw std::runtime_error("[exec_reports] overflow must be block or drop");
+                }
+            }
+        } else if (section == "low_jitter") {
+            if (key == "enabled") {
+                config.low_jitter.enabled = (value == "1" || value == "true" || value == "TRUE");
+            } else if (key == "engine_priority") {
+                config.low_jitter.engine_priority = std::stoi(value);
+            } else if (key == "dispatcher_priority") {
+                config.low_jitter.dispatcher_priority = std::stoi(value);
+            } else if (key == "probe_ms") {
+                config.low_jitter.probe_ms = static_cast<uint32_t>(std::stoul(value));
+            } else if (key == "probe_threshold_ns") {
+                config.low_jitter.probe_threshold_ns = static_cast<uint32_t>(std::stoul(value));
+            }
+        } else if (section == "warmup") {
+            if (key == "enabled") {
+                config.warmup.enabled = (value == "1" || value == "true" || value == "TRUE");
+            } else if (key == "lock_memory") {
+                config.warmup.lock_memory = (value == "1" || value == "true" || value == "TRUE");
+            } else if (key == "expected_orders") {
+                config.warmup.expected_orders = static_cast<std::size_t>(std::stoull(value));
+            } else if (key == "level_orders") {
+                config.warmup.level_orders = static_cast<std::size_t>(std::stoul(value));
+            } else if (key == "synthetic_orders") {
+                config.warmup.synthetic_orders = static_cast<std::size_t>(std::stoull(value));
+            }
+        } else if (section == "wait") {
+            for (WaitSettings* role : {&config.wait.engine, &config.wait.dispatcher, &config.wait.trade,
+                                       &config.wait.risk}) {
+                parseWaitKey(key, value, *role);
+            }
+        } else if (section.rfind(kWaitRolePrefix, 0) == 0) {
+            parseWaitKey(key, value,
+                         waitRole(config.wait, section.substr(std::char_traits<char>::length(kWaitRolePrefix))));
+        } else if (section == "price_bands") {
+            parsePriceBandKey(key, value, config.price_bands);
+        } else if (section.rfind(kPriceBandOverridePrefix, 0) == 0) {
+            // [price_bands.<token>] starts from the [price_bands] defaults read so far.
+            const auto token = static_cast<InstrumentToken>(
+                std::stoul(section.substr(std::char_traits<char>::length(kPriceBandOverridePrefix))));
+            auto [it, inserted] = config.instrument_price_bands.try_emplace(token, config.price_bands);
+            parsePriceBandKey(key, value, it->second);
+        } else if (section == "risk") {
+            if (key == "enabled") {
+                config.risk.enabled = (value == "1" || value == "true" || value == "TRUE");
+            } else if (key == "max_participants") {
+                config.risk.max_participants = static_cast<uint32_t>(std::stoul(value));
+            } else if (key == "max_order_qty") {
+                config.risk.max_order_qty = std::stoull(value);
+            } else if (key == "max_notional") {
+                config.risk.max_notional = std::stoull(value);
+            } else if (key == "max_open_orders") {
+                config.risk.max_open_orders = static_cast<uint32_t>(std::stoul(value));
+            } else if (key == "max_position") {
+                config.risk.max_position = std::stoull(value);
+            } else if (key == "max_live_orders") {
+                config.risk.max_live_orders = static_cast<uint32_t>(std::stoul(value));
             }
         }
     }
@@ -0,0 +1,306 @@
+#include "utils/HugePages.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/CompilerHints.h"
+#include "utils/LogMacros.h"
+
+namespace {
+
+using memory::Region;
+
+constexpr std::size_t kMinClassShift = 6;  // 64-byte blocks, one cache line
+// Requests of half a huge page or more get a mapping of their own.
+constexpr std::size_t kDirectThreshold = memory::kHugePageSize / 2;
+constexpr std::size_t kClassCount = std::bit_width(kDirectThreshold) - kMinClassShift;
+
+enum class Backing : uint8_t { HUGETLB, THP, SMALL };
+
+struct RegionState {
+    std::atomic<HugePageMode> mode{HugePageMode::OFF};
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> live_bytes{0};
+    std::atomic<uint64_t> hugetlb_bytes{0};
+    std::atomic<uint64_t> thp_bytes{0};
+    std::atomic<uint64_t> small_page_bytes{0};
+    std::atomic<uint64_t> hugetlb_fallbacks{0};
+
+    // Direct mappings, and blocks left behind by threads that exited; small
+    // blocks otherwise never come here.
+    std::mutex mutex;
+    std::unordered_map<void*, Backing> direct;
+    std::array<std::vector<void*>, kClassCount> orphaned_blocks;
+};
+
+// Built on first use and never destroyed, so containers created or freed
+// during static initialisation and teardown still find it.
+RegionState& state(Region region) {
+    static auto* states = new std::array<RegionState, memory::kRegionCount>();
+    return (*states)[static_cast<std::size_t>(region)];
+}
+
+// Each thread carves small blocks from its own slabs and keeps what it frees,
+// so growing a level's order list on a shard takes no lock and no syscall
+// unless that thread's slab runs out.
+struct RegionCache {
+    std::byte* slab = nullptr;
+    std::size_t slab_left = 0;
+    std::array<std::vector<void*>, kClassCount> free_blocks;
+};
+
+// Set once this thread's cache is gone; later frees go to the orphan lists.
+thread_local bool cache_released = false;
+
+struct ThreadCache {
+    std::array<RegionCache, memory::kRegionCount> regions;
+
+    ~ThreadCache() {
+        cache_released = true;
+        for (std::size_t idx = 0; idx < regions.size(); ++idx) {
+            RegionState& rs = state(static_cast<Region>(idx));
+            std::lock_guard<std::mutex> lock(rs.mutex);
+            for (std::size_t cls = 0; cls < kClassCount; ++cls) {
+                auto& blocks = regions[idx].free_blocks[cls];
+                rs.orphaned_blocks[cls].insert(rs.orphaned_blocks[cls].end(), blocks.begin(), blocks.end());
+            }
+        }
+    }
+};
+
+RegionCache& cacheFor(Region region) {
+    thread_local ThreadCache cache;
+    return cache.regions[static_cast<std::size_t>(region)];
+}
+
+std::atomic<uint64_t>& counterFor(RegionState& region, Backing backing) {
+    switch (backing) {
+        case Backing::HUGETLB: return region.hugetlb_bytes;
+        case Backing::THP: return region.thp_bytes;
+        default: return region.small_page_bytes;
+    }
+}
+
+std::size_t roundToHugePage(std::size_t bytes) {
+    return (bytes + memory::kHugePageSize - 1) & ~(memory::kHugePageSize - 1);
+}
+
+// len is a multiple of the huge page size.
+void* mapHuge(RegionState& region, std::size_t len, Backing& backing) {
+    constexpr int kProt = PROT_READ | PROT_WRITE;
+    if (region.mode.load(std::memory_order_relaxed) == HugePageMode::HUGETLB) {
+        void* mapped = ::mmap(nullptr, len, kProt, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mapped != MAP_FAILED) {
+            backing = Backing::HUGETLB;
+            region.hugetlb_bytes.fetch_add(len, std::memory_order_relaxed);
+            return mapped;
+        }
+        region.hugetlb_fallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Over-map and trim so the range starts on a 2 MB boundary THP can fill.
+    void* raw = ::mmap(nullptr, len + memory::kHugePageSize, kProt, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    const auto base = reinterpret_cast<std::uintptr_t>(raw);
+    const auto aligned = (base + memory::kHugePageSize - 1) & ~(memory::kHugePageSize - 1);
+    const std::size_t head = aligned - base;
+    if (head > 0) {
+        ::munmap(raw, head);
+    }
+    ::munmap(reinterpret_cast<void*>(aligned + len), memory::kHugePageSize - head);
+    void* mapped = reinterpret_cast<void*>(aligned);
+    backing = ::madvise(mapped, len, MADV_HUGEPAGE) == 0 ? Backing::THP : Backing::SMALL;
+    counterFor(region, backing).fetch_add(len, std::memory_order_relaxed);
+    return mapped;
+}
+
+std::size_t classIndex(std::size_t bytes, std::size_t align) {
+    const std::size_t block = std::bit_ceil(std::max({bytes, align, std::size_t{1} << kMinClassShift}));
+    return static_cast<std::size_t>(std::countr_zero(block)) - kMinClassShift;
+}
+
+// Takes the blocks of a class that exited threads left behind.
+bool adoptOrphans(RegionState& region, std::size_t cls, std::vector<void*>& blocks) {
+    std::lock_guard<std::mutex> lock(region.mutex);
+    if (region.orphaned_blocks[cls].empty()) {
+        return false;
+    }
+    blocks.swap(region.orphaned_blocks[cls]);
+    return true;
+}
+
+void* carve(RegionState& region, RegionCache& cache, std::size_t cls) {
+    auto& blocks = cache.free_blocks[cls];
+    if (!blocks.empty()) {
+        void* block = blocks.back();
+        blocks.pop_back();
+        return block;
+    }
+    const std::size_t size = std::size_t{1} << (cls + kMinClassShift);
+    // Blocks are aligned to their size, which covers any alignment that picked the class.
+    const auto cursor = reinterpret_cast<std::uintptr_t>(cache.slab);
+    const std::size_t pad = cache.slab ? ((cursor + size - 1) & ~(size - 1)) - cursor : 0;
+    if (!cache.slab || cache.slab_left < pad + size) {
+        if (!adoptOrphans(region, cls, blocks)) {
+            Backing backing = Backing::SMALL;
+            cache.slab = static_cast<std::byte*>(mapHuge(region, memory::kHugePageSize, backing));
+            cache.slab_left = memory::kHugePageSize;
+        }
+        return carve(region, cache, cls);
+    }
+    std::byte* block = cache.slab + pad;
+    cache.slab = block + size;
+    cache.slab_left -= pad + size;
+    return block;
+}
+
+uint64_t readField(const char* path, const std::string& field) {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.rfind(field, 0) == 0) {
+            return std::stoull(line.substr(field.size()));
+        }
+    }
+    return 0;
+}
+
+}  // namespace
+
+namespace memory {
+
+const char* toString(Region region) {
+    switch (region) {
+        case Region::LADDERS: return "ladders";
+        case Region::ARENAS: return "arenas";
+        case Region::QUEUES: return "queues";
+        case Region::SOCKETS: return "socket_buffers";
+        default: return "unknown";
+    }
+}
+
+void configureHugePages(const HugePageSettings& settings) {
+    const std::array<HugePageMode, kRegionCount> modes{settings.ladders, settings.arenas, settings.queues,
+                                                       settings.sockets};
+    for (std::size_t idx = 0; idx < kRegionCount; ++idx) {
+        const auto region = static_cast<Region>(idx);
+        RegionState& rs = state(region);
+        // deallocate() goes by the mode, so it must be the one every live block was allocated with.
+        if (rs.allocations.load(std::memory_order_relaxed) > 0 &&
+            rs.mode.load(std::memory_order_relaxed) != modes[idx]) {
+            LOG_WARN("Memory {}: already allocated from, keeping mode {}", toString(region),
+                     ::toString(rs.mode.load(std::memory_order_relaxed)));
+            continue;
+        }
+        rs.mode.store(modes[idx], std::memory_order_relaxed);
+    }
+}
+
+void* allocate(Region region, std::size_t bytes, std::size_t align) {
+    RegionState& rs = state(region);
+    bytes = std::max<std::size_t>(bytes, 1);
+    rs.allocations.fetch_add(1, std::memory_order_relaxed);
+    rs.live_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    if (rs.mode.load(std::memory_order_relaxed) == HugePageMode::OFF) {
+        rs.small_page_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        return ::operator new(bytes, std::align_val_t(align));
+    }
+    if (bytes >= kDirectThreshold) {
+        Backing backing = Backing::SMALL;
+        void* mapped = mapHuge(rs, roundToHugePage(bytes), backing);
+        std::lock_guard<std::mutex> lock(rs.mutex);
+        rs.direct.emplace(mapped, backing);
+        return mapped;
+    }
+    return carve(rs, cacheFor(region), classIndex(bytes, align));
+}
+
+void deallocate(Region region, void* ptr, std::size_t bytes, std::size_t align) noexcept {
+    if (!ptr) {
+        return;
+    }
+    RegionState& rs = state(region);
+    bytes = std::max<std::size_t>(bytes, 1);
+    rs.live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    if (rs.mode.load(std::memory_order_relaxed) == HugePageMode::OFF) {
+        rs.small_page_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        ::operator delete(ptr, bytes, std::align_val_t(align));
+        return;
+    }
+    if (bytes >= kDirectThreshold) {
+        Backing backing = Backing::SMALL;
+        {
+            std::lock_guard<std::mutex> lock(rs.mutex);
+            const auto it = rs.direct.find(ptr);
+            if (it == rs.direct.end()) {
+                return;
+            }
+            backing = it->second;
+            rs.direct.erase(it);
+        }
+        const std::size_t len = roundToHugePage(bytes);
+        counterFor(rs, backing).fetch_sub(len, std::memory_order_relaxed);
+        ::munmap(ptr, len);
+        return;
+    }
+    const std::size_t cls = classIndex(bytes, align);
+    if (UNLIKELY(cache_released)) {
+        std::lock_guard<std::mutex> lock(rs.mutex);
+        rs.orphaned_blocks[cls].push_back(ptr);
+        return;
+    }
+    cacheFor(region).free_blocks[cls].push_back(ptr);
+}
+
+RegionStats stats(Region region) {
+    RegionState& rs = state(region);
+    RegionStats out;
+    out.mode = rs.mode.load(std::memory_order_relaxed);
+    out.allocations = rs.allocations.load(std::memory_order_relaxed);
+    out.live_bytes = rs.live_bytes.load(std::memory_order_relaxed);
+    out.hugetlb_bytes = rs.hugetlb_bytes.load(std::memory_order_relaxed);
+    out.thp_bytes = rs.thp_bytes.load(std::memory_order_relaxed);
+    out.small_page_bytes = rs.small_page_bytes.load(std::memory_order_relaxed);
+    out.hugetlb_fallbacks = rs.hugetlb_fallbacks.load(std::memory_order_relaxed);
+    return out;
+}
+
+void logHugePageReport() {
+    constexpr double kMb = 1024.0 * 1024.0;
+    for (Region region : {Region::LADDERS, Region::ARENAS, Region::QUEUES, Region::SOCKETS}) {
+        const RegionStats s = stats(region);
+        LOG_INFO("Memory {} ({}): {} allocations, {:.1f} MB live; hugetlb {:.1f} MB, thp {:.1f} MB, "
+                 "small pages {:.1f} MB, {} hugetlb fallbacks",
+                 toString(region), ::toString(s.mode), s.allocations, static_cast<double>(s.live_bytes) / kMb,
+                 static_cast<double>(s.hugetlb_bytes) / kMb, static_cast<double>(s.thp_bytes) / kMb,
+                 static_cast<double>(s.small_page_bytes) / kMb, s.hugetlb_fallbacks);
+    }
+    LOG_INFO("Memory: AnonHugePages {} kB, HugePages_Free {} of {}",
+             readField("/proc/self/smaps_rollup", "AnonHugePages:"), readField("/proc/meminfo", "HugePages_Free:"),
+             readField("/proc/meminfo", "HugePages_Total:"));
+}
+
+bool lockProcessMemory() {
+    if (::mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        LOG_WARN("mlockall failed: {}; memory stays pageable (raise RLIMIT_MEMLOCK or grant CAP_IPC_LOCK)",
+                 std::strerror(errno));
+        return false;
+    }
+    LOG_INFO("Memory: process locked, current and future mappings");
+    return true;
+}
+
+}  // namespace memory
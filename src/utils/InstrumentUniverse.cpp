@@ -0,0 +1,106 @@
+#include "utils/InstrumentUniverse.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace {
+
+std::vector<std::string> splitCsvLine(const std::string& line) {
+    std::vector<std::string> fields;
+    std::string field;
+    bool quoted = false;
+    for (char ch : line) {
+        if (ch == '"') {
+            quoted = !quoted;
+        } else if (ch == ',' && !quoted) {
+            fields.push_back(field);
+            field.clear();
+        } else if (ch != '\r') {
+            field.push_back(ch);
+        }
+    }
+    fields.push_back(field);
+    return fields;
+}
+
+int columnIndex(const std::vector<std::string>& header, const char* name) {
+    for (std::size_t i = 0; i < header.size(); ++i) {
+        if (header[i] == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+const std::string* field(const std::vector<std::string>& row, int column) {
+    if (column < 0 || static_cast<std::size_t>(column) >= row.size() || row[static_cast<std::size_t>(column)].empty()) {
+        return nullptr;
+    }
+    return &row[static_cast<std::size_t>(column)];
+}
+
+}  // namespace
+
+std::vector<InstrumentSpec> loadInstrumentCsv(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open instrument csv: " + path);
+    }
+
+    std::string line;
+    if (!std::getline(file, line)) {
+        return {};
+    }
+    const auto header = splitCsvLine(line);
+    const int tokenCol = columnIndex(header, "token");
+    if (tokenCol < 0) {
+        throw std::runtime_error("Instrument csv has no token column: " + path);
+    }
+    const int symbolCol = columnIndex(header, "symbol");
+    const int nameCol = columnIndex(header, "stock_name");
+    const int lotCol = columnIndex(header, "lot_size");
+    const int tickCol = columnIndex(header, "tick_size");
+    const int closeCol = columnIndex(header, "underlying_prev_close");
+
+    std::vector<InstrumentSpec> instruments;
+    while (std::getline(file, line)) {
+        if (line.empty() || line == "\r") {
+            continue;
+        }
+        const auto row = splitCsvLine(line);
+        const std::string* token = field(row, tokenCol);
+        if (!token) {
+            continue;
+        }
+        InstrumentSpec spec;
+        spec.token = static_cast<InstrumentToken>(std::stoul(*token));
+        if (const auto* symbol = field(row, symbolCol)) spec.symbol = *symbol;
+        if (const auto* name = field(row, nameCol)) spec.name = *name;
+        if (const auto* lot = field(row, lotCol)) spec.lot_size = static_cast<uint32_t>(std::stoul(*lot));
+        if (const auto* tick = field(row, tickCol)) spec.tick_size = std::stod(*tick);
+        if (const auto* close = field(row, closeCol)) spec.prev_close = std::stod(*close);
+        instruments.push_back(std::move(spec));
+    }
+    return instruments;
+}
+
+std::vector<InstrumentSpec> loadInstrumentUniverse(const InstrumentSettings& settings) {
+    std::vector<InstrumentSpec> universe;
+    std::unordered_set<InstrumentToken> seen;
+    for (const auto token : settings.tokens) {
+        if (seen.insert(token).second) {
+            InstrumentSpec spec;
+            spec.token = token;
+            universe.push_back(std::move(spec));
+        }
+    }
+    if (!settings.csv_path.empty()) {
+        for (auto& spec : loadInstrumentCsv(settings.csv_path)) {
+            if (seen.insert(spec.token).second) {
+                universe.push_back(std::move(spec));
+            }
+        }
+    }
+    return universe;
+}
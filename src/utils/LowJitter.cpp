@@ -0,0 +1,107 @@
+#include "utils/LowJitter.h"
+
+#include <sys/prctl.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "utils/Affinity.h"
+#include "utils/LogMacros.h"
+
+namespace {
+
+// An unset nohz_full reads "(null)" on some kernels and empty on others.
+std::vector<int> readCpuList(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    std::string line;
+    if (!file.is_open() || !std::getline(file, line) || line.empty() ||
+        std::isdigit(static_cast<unsigned char>(line.front())) == 0) {
+        return {};
+    }
+    return cpu::parseCpuList(line);
+}
+
+bool contains(const std::vector<int>& cpus, int cpu) {
+    return std::find(cpus.begin(), cpus.end(), cpu) != cpus.end();
+}
+
+}  // namespace
+
+namespace jitter {
+
+Isolation readIsolation(const std::string& sys_root) {
+    const std::filesystem::path cpus = std::filesystem::path(sys_root) / "devices/system/cpu";
+    Isolation isolation;
+    isolation.isolated = readCpuList(cpus / "isolated");
+    isolation.nohz_full = readCpuList(cpus / "nohz_full");
+    return isolation;
+}
+
+bool checkIsolation(const char* role, const std::vector<int>& cores, const Isolation& isolation) {
+    bool ok = true;
+    for (int core : cores) {
+        if (core < 0) {
+            continue;
+        }
+        const bool isolated = contains(isolation.isolated, core);
+        const bool tickless = contains(isolation.nohz_full, core);
+        if (!isolated || !tickless) {
+            LOG_WARN("{} core {} is {}{}{}; expect scheduler and timer jitter", role, core,
+                     isolated ? "" : "not in isolcpus", (!isolated && !tickless) ? " and " : "",
+                     tickless ? "" : "not in nohz_full");
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+std::string thpDefrag(const std::string& sys_root) {
+    std::ifstream file(std::filesystem::path(sys_root) / "kernel/mm/transparent_hugepage/defrag");
+    std::string line;
+    if (!file.is_open() || !std::getline(file, line)) {
+        return {};
+    }
+    // "always defer [madvise] never": the bracketed entry is the active one.
+    const auto open = line.find('[');
+    const auto close = line.find(']', open);
+    if (open == std::string::npos || close == std::string::npos) {
+        return {};
+    }
+    return line.substr(open + 1, close - open - 1);
+}
+
+bool disableTransparentHugePages() {
+    if (::prctl(PR_SET_THP_DISABLE, 1, 0, 0, 0) != 0) {
+        LOG_WARN("PR_SET_THP_DISABLE failed: {}", std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+Probe measure(std::chrono::nanoseconds duration, std::chrono::nanoseconds threshold) {
+    using Clock = std::chrono::steady_clock;
+    Probe probe;
+    const auto gap_limit = static_cast<uint64_t>(threshold.count());
+    const auto start = Clock::now();
+    const auto end = start + duration;
+    auto prev = start;
+    while (prev < end) {
+        const auto now = Clock::now();
+        const auto gap = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - prev).count());
+        ++probe.samples;
+        if (gap > gap_limit) {
+            ++probe.interruptions;
+            probe.lost_ns += gap;
+            probe.max_ns = std::max(probe.max_ns, gap);
+        }
+        prev = now;
+    }
+    probe.elapsed_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(prev - start).count());
+    return probe;
+}
+
+}  // namespace jitter
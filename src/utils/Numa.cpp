@@ -0,0 +1,129 @@
+#include "utils/Numa.h"
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "utils/Affinity.h"
+
+namespace {
+
+bool readLine(const std::filesystem::path& path, std::string& line) {
+    std::ifstream file(path);
+    return file.is_open() && static_cast<bool>(std::getline(file, line));
+}
+
+const std::vector<int> kNoCpus;
+
+}  // namespace
+
+namespace numa {
+
+std::size_t Topology::nodeCount() const {
+    return static_cast<std::size_t>(std::count_if(node_cpus.begin(), node_cpus.end(),
+                                                   [](const auto& cpus) { return !cpus.empty(); }));
+}
+
+int Topology::nodeOf(int cpu) const {
+    for (std::size_t node = 0; node < node_cpus.size(); ++node) {
+        if (std::find(node_cpus[node].begin(), node_cpus[node].end(), cpu) != node_cpus[node].end()) {
+            return static_cast<int>(node);
+        }
+    }
+    return -1;
+}
+
+const std::vector<int>& Topology::cpusOf(int node) const {
+    if (node < 0 || static_cast<std::size_t>(node) >= node_cpus.size()) {
+        return kNoCpus;
+    }
+    return node_cpus[static_cast<std::size_t>(node)];
+}
+
+Topology discover(const std::string& sys_root) {
+    namespace fs = std::filesystem;
+    Topology topology;
+    const fs::path nodes = fs::path(sys_root) / "devices/system/node";
+    std::error_code ec;
+    for (fs::directory_iterator it(nodes, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        if (name.size() <= 4 || name.rfind("node", 0) != 0 ||
+            !std::all_of(name.begin() + 4, name.end(), [](unsigned char ch) { return ch >= '0' && ch <= '9'; })) {
+            continue;
+        }
+        std::string cpulist;
+        if (!readLine(it->path() / "cpulist", cpulist)) {
+            continue;
+        }
+        const auto node = static_cast<std::size_t>(std::stoul(name.substr(4)));
+        if (node >= topology.node_cpus.size()) {
+            topology.node_cpus.resize(node + 1);
+        }
+        topology.node_cpus[node] = cpu::parseCpuList(cpulist);
+    }
+    if (topology.nodeCount() == 0) {
+        std::vector<int> all(std::max(1u, std::thread::hardware_concurrency()));
+        for (std::size_t idx = 0; idx < all.size(); ++idx) {
+            all[idx] = static_cast<int>(idx);
+        }
+        topology.node_cpus.assign(1, std::move(all));
+    }
+    return topology;
+}
+
+int nicNode(const std::string& iface, const std::string& sys_root) {
+    std::string line;
+    const auto path = std::filesystem::path(sys_root) / "class/net" / iface / "device/numa_node";
+    if (iface.empty() || !readLine(path, line)) {
+        return -1;
+    }
+    try {
+        return std::max(-1, std::stoi(line));
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+std::vector<int> placeOnNode(const Topology& topology, int node, const std::vector<int>& pinned) {
+    if (!pinned.empty()) {
+        return pinned;
+    }
+    return topology.cpusOf(node);
+}
+
+std::vector<int> remoteCpus(const Topology& topology, int node, const std::vector<int>& cpus) {
+    std::vector<int> remote;
+    if (node < 0) {
+        return remote;
+    }
+    for (int cpu : cpus) {
+        if (cpu >= 0 && topology.nodeOf(cpu) != node) {
+            remote.push_back(cpu);
+        }
+    }
+    return remote;
+}
+
+void runOn(const std::vector<int>& cpus, const std::function<void()>& fn) {
+    if (cpus.empty()) {
+        fn();
+        return;
+    }
+    std::exception_ptr failure;
+    std::thread builder([&] {
+        cpu::setCurrentThreadAffinity(cpus);
+        try {
+            fn();
+        } catch (...) {
+            failure = std::current_exception();
+        }
+    });
+    builder.join();
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+}  // namespace numa
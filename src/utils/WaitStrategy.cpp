@@ -0,0 +1,89 @@
+#include "utils/WaitStrategy.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <ctime>
+#include <thread>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+int64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+timespec toTimespec(uint64_t ns) {
+    timespec ts{};
+    ts.tv_sec = static_cast<time_t>(ns / 1'000'000'000ULL);
+    ts.tv_nsec = static_cast<long>(ns % 1'000'000'000ULL);
+    return ts;
+}
+
+long futex(std::atomic<uint32_t>& word, int op, uint32_t value, const timespec* timeout) {
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+    return ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), op, value, timeout, nullptr, 0);
+}
+
+}  // namespace
+
+WaitCounters& WaitCounters::operator+=(const WaitCounters& other) {
+    spins += other.spins;
+    yields += other.yields;
+    sleeps += other.sleeps;
+    parks += other.parks;
+    wakeups += other.wakeups;
+    wake_latency_total_ns += other.wake_latency_total_ns;
+    wake_latency_max_ns = std::max(wake_latency_max_ns, other.wake_latency_max_ns);
+    return *this;
+}
+
+WaitStrategy::WaitStrategy(const WaitSettings& settings)
+    : mode_(settings.mode),
+      spin_limit_(std::max<uint32_t>(settings.spin_limit, 1)),
+      park_timeout_ns_(std::max<uint64_t>(settings.park_timeout_us, 1) * 1'000),
+      backoff_max_ns_(std::max<uint64_t>(settings.backoff_max_us * 1'000ULL, kMinBackoffNs)) {}
+
+WaitCounters WaitStrategy::counters() const {
+    WaitCounters out;
+    out.spins = spins_.load(std::memory_order_relaxed);
+    out.yields = yields_.load(std::memory_order_relaxed);
+    out.sleeps = sleeps_.load(std::memory_order_relaxed);
+    out.parks = parks_.load(std::memory_order_relaxed);
+    out.wakeups = wake_latency_.count();
+    out.wake_latency_total_ns = wake_latency_.total();
+    out.wake_latency_max_ns = wake_latency_.max();
+    return out;
+}
+
+void WaitStrategy::yield() {
+    stats::bump(yields_);
+    std::this_thread::yield();
+}
+
+void WaitStrategy::backoff() {
+    stats::bump(sleeps_);
+    const timespec ts = toTimespec(backoff_ns_);
+    ::nanosleep(&ts, nullptr);
+    backoff_ns_ = std::min(backoff_ns_ * 2, backoff_max_ns_);
+}
+
+void WaitStrategy::sleep(uint32_t key) {
+    const timespec ts = toTimespec(park_timeout_ns_);
+    futex(epoch_, FUTEX_WAIT_PRIVATE, key, &ts);
+    if (epoch_.load(std::memory_order_acquire) != key) {
+        const int64_t elapsed = steadyNanos() - notified_ns_.load(std::memory_order_relaxed);
+        wake_latency_.observe(static_cast<uint64_t>(std::max<int64_t>(elapsed, 0)));
+    }
+}
+
+void WaitStrategy::wake() {
+    notified_ns_.store(steadyNanos(), std::memory_order_relaxed);
+    epoch_.fetch_add(1, std::memory_order_release);
+    futex(epoch_, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr);
+}
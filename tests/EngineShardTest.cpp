@@ -0,0 +1,462 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine/EngineShard.h"
+#include "engine/InlineEngine.h"
+#include "engine/InstrumentOnboarder.h"
+#include "engine/ShardAssignment.h"
+#include "engine/ShardBalancer.h"
+#include "engine/Warmup.h"
+#include "utils/InstrumentUniverse.h"
+#include "utils/LogMacros.h"
+
+namespace {
+
+void expect(bool condition, const char* message) {
+    if (!condition) {
+        throw std::runtime_error(message);
+    }
+}
+
+ingress::WireOrder makeWire(OrderId id, InstrumentToken token, Side side, Price price, Qty qty) {
+    ingress::WireOrder order{};
+    order.order_id = id;
+    order.instrument = token;
+    order.side = side;
+    order.price = price;
+    order.quantity = qty;
+    order.type = OrderType::LIMIT;
+    return order;
+}
+
+void waitForProcessed(const std::vector<engine::EngineShard*>& shards, uint64_t expected) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        uint64_t total = 0;
+        for (const auto* shard : shards) {
+            total += shard->processed();
+        }
+        if (total >= expected) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+InstrumentSpec spec(InstrumentToken token) {
+    InstrumentSpec out;
+    out.token = token;
+    return out;
+}
+
+}  // namespace
+
+int main() {
+    try {
+        {
+            const std::string path = "engine_shard_test_market_data.csv";
+            {
+                std::ofstream csv(path);
+                csv << "symbol,token,stock_name,lot_size,tick_size,underlying_prev_close\n"
+                    << "HDFCBANK,1333,\"HDFC BANK, LTD\",1,0.05,1518.4\n"
+                    << "TCS,11536,TCS LTD,1,0.1,3950\n"
+                    << "DUP,26000,DUPLICATE,1,0.05,1\n";
+            }
+            InstrumentSettings settings;
+            settings.tokens = {26000, 35000};
+            settings.csv_path = path;
+            const auto universe = loadInstrumentUniverse(settings);
+            std::remove(path.c_str());
+
+            expect(universe.size() == 4, "Universe should merge ini tokens with csv rows and drop duplicates");
+            expect(universe[0].token == 26000 && universe[1].token == 35000, "Ini tokens should come first");
+            expect(universe[2].symbol == "HDFCBANK" && universe[2].name == "HDFC BANK, LTD",
+                   "Quoted csv fields should keep embedded commas");
+            expect(universe[3].tick_size > 0.09 && universe[3].prev_close > 3949.0, "Csv numeric columns mismatch");
+        }
+
+        {
+            engine::RoundRobinAssignment roundRobin;
+            expect(roundRobin.assign(spec(1), 3) == 0 && roundRobin.assign(spec(2), 3) == 1 &&
+                       roundRobin.assign(spec(3), 3) == 2 && roundRobin.assign(spec(4), 3) == 0,
+                   "Round robin should deal instruments in order");
+
+            engine::HashAssignment hash;
+            std::vector<std::size_t> perShard(4, 0);
+            for (InstrumentToken token = 1000; token < 3000; ++token) {
+                ++perShard[hash.assign(spec(token), perShard.size())];
+            }
+            for (auto count : perShard) {
+                expect(count > 400 && count < 600, "Hash assignment should spread consecutive tokens");
+            }
+            expect(hash.assign(spec(26000), 4) == hash.assign(spec(26000), 4), "Hash assignment must be stable");
+
+            EngineSettings settings;
+            settings.pins[35000] = 2;
+            auto pinned = engine::makeAssignmentPolicy(settings);
+            expect(pinned->assign(spec(35000), 3) == 2, "Pinned instrument should land on its shard");
+            expect(pinned->assign(spec(26000), 3) == 0, "Unpinned instruments should use the fallback policy");
+
+            bool threw = false;
+            try {
+                pinned->assign(spec(35000), 2);
+            } catch (const std::runtime_error&) {
+                threw = true;
+            }
+            expect(threw, "Pin beyond the shard count should be rejected");
+
+            settings.assignment = "nope";
+            threw = false;
+            try {
+                engine::makeAssignmentPolicy(settings);
+            } catch (const std::runtime_error&) {
+                threw = true;
+            }
+            expect(threw, "Unknown assignment policy should be rejected");
+        }
+
+        {
+            engine::EngineShard shard(0, -1, 64);
+            for (InstrumentToken token = 1; token <= 3; ++token) {
+                shard.addInstrument(token, std::make_unique<OrderBook>()).setInstrumentToken(token);
+            }
+            expect(shard.instrumentCount() == 3 && shard.queueFor(4) == nullptr, "Shard instrument registry mismatch");
+
+            // More orders than one burst on token 1 so the sweep has to come back to it.
+            OrderId id = 1;
+            for (int i = 0; i < 40; ++i) {
+                shard.queueFor(1)->push(makeWire(id++, 1, Side::BUY, 100, 1));
+            }
+            shard.queueFor(2)->push(makeWire(id++, 2, Side::SELL, 200, 5));
+            shard.queueFor(3)->push(makeWire(id++, 3, Side::BUY, 300, 7));
+            shard.queueFor(3)->push(makeWire(id++, 3, Side::SELL, 300, 2));
+
+            std::thread worker([&shard] { shard.run(); });
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (shard.processed() < 43 && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+            shard.stop();
+            worker.join();
+
+            expect(shard.processed() == 43, "Shard should process every queued order");
+            expect(shard.bookFor(1)->totalOpenQtyAt(Side::BUY, 100) == 40, "Token 1 book mismatch");
+            expect(shard.bookFor(2)->totalOpenQtyAt(Side::SELL, 200) == 5, "Token 2 book mismatch");
+            expect(shard.bookFor(3)->totalOpenQtyAt(Side::BUY, 300) == 5, "Token 3 orders should have matched");
+        }
+
+        {
+            // Two producers feed one MPSC instrument queue while the shard runs.
+            engine::EngineShard shard(0, -1, 64);
+            shard.addInstrument(7, std::make_unique<OrderBook>(), true).setInstrumentToken(7);
+            expect(shard.queueFor(7)->multiProducer(), "Instrument queue should be multi-producer");
+
+            std::thread worker([&shard] { shard.run(); });
+            std::vector<std::thread> producers;
+            for (OrderId base : {OrderId{1'000}, OrderId{2'000}}) {
+                producers.emplace_back([&shard, base] {
+                    for (OrderId i = 0; i < 500; ++i) {
+                        while (!shard.queueFor(7)->push(makeWire(base + i, 7, Side::BUY, 100, 1))) {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+            }
+            for (auto& producer : producers) {
+                producer.join();
+            }
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (shard.processed() < 1'000 && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+            shard.stop();
+            worker.join();
+            expect(shard.processed() == 1'000, "Shard should process both producers' orders");
+            expect(shard.bookFor(7)->totalOpenQtyAt(Side::BUY, 100) == 1'000, "MPSC book quantity mismatch");
+        }
+
+        for (TradePublisher::Mode mode : {TradePublisher::Mode::THREAD, TradePublisher::Mode::INLINE}) {
+            // Trades of every book in the shard go through the one publisher, in match order.
+            std::mutex mutex;
+            std::vector<std::pair<InstrumentToken, OrderId>> trades;
+            std::vector<std::thread::id> emitters;
+            std::thread::id shard_thread;
+            const auto record = [&](TradeBatch batch) {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (const TradeEvent& event : batch) {
+                    trades.emplace_back(event.instrument, event.aggressorId);
+                }
+                emitters.push_back(std::this_thread::get_id());
+            };
+            {
+                TradePublisher::Options options;
+                options.mode = mode;
+                options.capacity = 4;
+                engine::EngineShard shard(0, -1, 256, {}, options);
+                for (InstrumentToken token = 1; token <= 3; ++token) {
+                    auto& book = shard.addInstrument(token, std::make_unique<OrderBook>());
+                    book.clearTradeSinks();
+                    book.addTradeSink(record);
+                }
+                OrderId id = 1;
+                for (InstrumentToken token = 1; token <= 3; ++token) {
+                    shard.queueFor(token)->push(makeWire(id++, token, Side::SELL, 100, 50));
+                    for (int i = 0; i < 50; ++i) {
+                        shard.queueFor(token)->push(makeWire(id++, token, Side::BUY, 100, 1));
+                    }
+                }
+                std::thread worker([&shard] { shard.run(); });
+                shard_thread = worker.get_id();
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+                while (shard.processed() < 153 && std::chrono::steady_clock::now() < deadline) {
+                    std::this_thread::yield();
+                }
+                shard.stop();
+                worker.join();
+                expect(shard.tradePublisher().published() == 150, "Publisher should see every trade of the shard");
+            }
+
+            expect(trades.size() == 150, "Every trade should reach its listener by shard teardown");
+            std::vector<OrderId> lastPerBook(4, 0);
+            for (const auto& [token, aggressor] : trades) {
+                expect(aggressor > lastPerBook[token], "Trades of one book should arrive in match order");
+                lastPerBook[token] = aggressor;
+            }
+            for (const auto& emitter : emitters) {
+                expect(emitter == emitters.front(), "All books of a shard should share one trade thread");
+            }
+            expect((emitters.front() == shard_thread) == (mode == TradePublisher::Mode::INLINE),
+                   "Inline trades should run on the shard thread, threaded ones off it");
+        }
+
+        {
+            // A book moves to another running shard mid-stream: every order is
+            // matched exactly once and trades keep their order.
+            EngineSettings settings;
+            engine::EngineShard a(0, -1, 64);
+            engine::EngineShard b(1, -1, 64);
+            std::mutex mutex;
+            std::vector<OrderId> aggressors;
+            const auto record = [&](TradeBatch batch) {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (const TradeEvent& event : batch) {
+                    aggressors.push_back(event.aggressorId);
+                }
+            };
+            auto& moving = a.addInstrument(5, std::make_unique<OrderBook>());
+            moving.clearTradeSinks();
+            moving.addTradeSink(record);
+            b.addInstrument(6, std::make_unique<OrderBook>()).clearTradeSinks();
+            engine::InstrumentLoad* load = nullptr;
+            a.forEachLoad([&load](engine::InstrumentLoad& entry) { load = &entry; });
+            engine::ShardBalancer balancer({&a, &b}, settings);
+
+            std::thread workerA([&a] { a.run(); });
+            std::thread workerB([&b] { b.run(); });
+            auto* queue = a.queueFor(5);
+            for (OrderId id = 1; id <= 2'000; ++id) {
+                const Side side = (id % 2 == 1) ? Side::SELL : Side::BUY;
+                while (!queue->push(makeWire(id, 5, side, 100, 1))) {
+                    std::this_thread::yield();
+                }
+                queue->notifyConsumer();
+                if (id == 700) {
+                    a.requestRelease(5, b);
+                }
+            }
+            waitForProcessed({&a, &b}, 2'000);
+            a.stop();
+            b.stop();
+            workerA.join();
+            workerB.join();
+
+            expect(a.migratedOut() == 1 && b.migratedIn() == 1 && a.migrationAborts() == 0, "Book should migrate once");
+            expect(a.bookFor(5) == nullptr && b.bookFor(5) == &moving, "Target shard should own the book");
+            expect(load->shard.load() == 1 && load->processed.load() == 2'000, "Load record should follow the book");
+            expect(a.processed() + b.processed() == 2'000, "Every order should be processed exactly once");
+            expect(moving.totalOpenQtyAt(Side::BUY, 100) == 0 && moving.totalOpenQtyAt(Side::SELL, 100) == 0,
+                   "Every order should have matched its pair");
+            std::lock_guard<std::mutex> lock(mutex);
+            expect(aggressors.size() == 1'000, "One trade per pair expected");
+            for (std::size_t i = 0; i < aggressors.size(); ++i) {
+                expect(aggressors[i] == static_cast<OrderId>(2 * (i + 1)), "Trades should keep their order");
+            }
+        }
+
+        {
+            // The balancer evens out the busiest and idlest shards and leaves pins alone.
+            EngineSettings settings;
+            settings.rebalance_min_load = 100;
+            settings.pins[2] = 0;
+            engine::EngineShard a(0, -1, 512);
+            engine::EngineShard b(1, -1, 512);
+            for (InstrumentToken token : {1u, 2u, 3u}) {
+                a.addInstrument(token, std::make_unique<OrderBook>()).clearTradeSinks();
+            }
+            b.addInstrument(4, std::make_unique<OrderBook>()).clearTradeSinks();
+            engine::ShardBalancer balancer({&a, &b}, settings);
+            expect(!balancer.rebalance(), "Idle shards should stay put");
+
+            OrderId id = 1;
+            const auto load = [&](InstrumentToken token, int orders) {
+                for (int i = 0; i < orders; ++i) {
+                    a.queueFor(token)->push(makeWire(id++, token, Side::BUY, 100, 1));
+                }
+            };
+            load(1, 300);
+            load(2, 150);
+            load(3, 200);
+            expect(balancer.rebalance() && balancer.requested() == 1, "A skewed pair should trigger a move");
+
+            std::thread workerA([&a] { a.run(); });
+            std::thread workerB([&b] { b.run(); });
+            waitForProcessed({&a, &b}, 650);
+            a.stop();
+            b.stop();
+            workerA.join();
+            workerB.join();
+            // Gap 650: token 1 (300) comes closest to half of it.
+            expect(b.bookFor(1) != nullptr && a.bookFor(2) != nullptr && a.bookFor(3) != nullptr,
+                   "The instrument closest to half the gap should move");
+            expect(b.bookFor(1)->totalOpenQtyAt(Side::BUY, 100) == 300, "Moved book should keep its orders");
+        }
+
+        {
+            // Runtime onboarding: a running shard adopts a new book, the same
+            // token always gets the same queue, and the limit refuses the rest.
+            AppConfig config;
+            config.ingress.onboarding_max_instruments = 1;
+            engine::EngineShard a(0, -1, 64);
+            engine::EngineShard b(1, -1, 64);
+            a.addInstrument(1, std::make_unique<OrderBook>()).clearTradeSinks();
+            ingress::OnboardingChannel channel(1);
+            engine::RoundRobinAssignment assignment;
+            assignment.assign(spec(1), 2);
+            engine::InstrumentOnboarder onboarder({&a, &b}, channel, config, assignment, nullptr, false);
+            std::mutex mutex;
+            std::size_t trades = 0;
+            const auto count = [&](TradeBatch batch) {
+                std::lock_guard<std::mutex> lock(mutex);
+                trades += batch.size();
+            };
+            onboarder.setHook([&](InstrumentToken, OrderBook& book, engine::InstrumentOnboarder::Route route) {
+                book.clearTradeSinks();
+                book.addTradeSink(count);
+                return route;
+            });
+
+            std::thread workerA([&a] { a.run(); });
+            std::thread workerB([&b] { b.run(); });
+            onboarder.handle({9, 0});
+            onboarder.handle({9, 0});
+            onboarder.handle({10, 0});
+            const auto replies = channel.takeReplies(0);
+            expect(replies.size() == 3 && replies[0].queue != nullptr && replies[1].queue == replies[0].queue,
+                   "Repeated requests should get the same queue");
+            expect(replies[2].queue == nullptr && onboarder.refused() == 1, "The instrument limit should refuse");
+
+            for (OrderId id = 1; id <= 100; ++id) {
+                const Side side = (id % 2 == 1) ? Side::SELL : Side::BUY;
+                while (!replies[0].queue->push(makeWire(id, 9, side, 100, 1))) {
+                    std::this_thread::yield();
+                }
+                replies[0].queue->notifyConsumer();
+            }
+            waitForProcessed({&a, &b}, 100);
+            a.stop();
+            b.stop();
+            workerA.join();
+            workerB.join();
+            expect(b.onboarded() == 1 && b.bookFor(9) != nullptr, "Assignment should put the book on shard 1");
+            expect(b.processed() == 100 && onboarder.onboarded() == 1, "Onboarded queue should be drained");
+            std::lock_guard<std::mutex> lock(mutex);
+            expect(trades == 50, "Onboarded book should trade through the hook's sink");
+        }
+
+        {
+            // Warm-up sizes every book, runs one synthetic flow per backend and leaves the books untouched.
+            engine::EngineShard shard(0, -1, 64);
+            shard.addInstrument(1, std::make_unique<OrderBook>(BookBackend::RING)).clearTradeSinks();
+            shard.addInstrument(2, std::make_unique<OrderBook>(BookBackend::RING)).clearTradeSinks();
+            shard.addInstrument(3, std::make_unique<OrderBook>(BookBackend::STD_MAP)).clearTradeSinks();
+            WarmupSettings settings;
+            settings.expected_orders = 4096;
+            settings.level_orders = 4;
+            settings.synthetic_orders = 1000;
+            const auto warm = engine::warmUpShard(shard, settings);
+            expect(warm.books == 3 && warm.synthetic_orders == 2000, "One flow per distinct backend");
+            expect(warm.synthetic_trades > 0, "Synthetic flow should match");
+            OrderBook& book = *shard.bookFor(1);
+            expect(book.bestBid() == nullptr && book.last_trade_price() == 0, "Live books see no synthetic orders");
+
+            shard.queueFor(1)->push(makeWire(4000, 1, Side::SELL, 100, 5));
+            shard.queueFor(1)->push(makeWire(4001, 1, Side::BUY, 100, 2));
+            std::thread worker([&shard] { shard.run(); });
+            waitForProcessed({&shard}, 2);
+            shard.stop();
+            worker.join();
+            expect(book.totalOpenQtyAt(Side::SELL, 100) == 3 && book.last_trade_quantity() == 2,
+                   "Pre-sized book should trade normally");
+        }
+
+        {
+            // Inline: trades reach the sink inside handle(), and the same input gives the same trades.
+            const auto replay = [](std::vector<TradeEvent>& trades) {
+                const auto collect = [&trades](TradeBatch batch) {
+                    trades.insert(trades.end(), batch.begin(), batch.end());
+                };
+                engine::InlineEngine engine;
+                engine.addTradeSink(collect);
+                const HrtTime epoch{};
+                std::size_t seen = 0;
+                for (OrderId id = 1; id <= 200; ++id) {
+                    const auto token = static_cast<InstrumentToken>(100 + id % 3);
+                    const Side side = (id % 2 == 0) ? Side::BUY : Side::SELL;
+                    const auto price = static_cast<Price>(1000 + (id * 7) % 5);
+                    engine.handle(makeWire(id, token, side, price, static_cast<Qty>(1 + id % 4)),
+                                  epoch + std::chrono::microseconds(id));
+                    for (; seen < trades.size(); ++seen) {
+                        expect(trades[seen].aggressorId == id && trades[seen].sequence == id,
+                               "Trades are delivered before handle() returns, with the order's sequence");
+                    }
+                }
+                expect(!engine.handle("not an order", epoch) && engine.lastSequence() == 200,
+                       "A malformed payload takes no sequence");
+                expect(engine.books() == 3 && engine.book(101) != nullptr && engine.book(7) == nullptr,
+                       "A book per instrument seen");
+                expect(engine.book(101)->dispatch() == TradePublishMode::INLINE, "Inline engine books are inline");
+                bool refused = false;
+                try {
+                    TradePublisher publisher;
+                    engine.book(101)->setTradePublisher(&publisher);
+                } catch (const std::runtime_error&) {
+                    refused = true;
+                }
+                expect(refused, "An inline book refuses a trade publisher");
+            };
+            std::vector<TradeEvent> first;
+            std::vector<TradeEvent> second;
+            replay(first);
+            replay(second);
+            expect(!first.empty() && first.size() == second.size(), "Same input, same number of trades");
+            for (std::size_t i = 0; i < first.size(); ++i) {
+                expect(first[i].aggressorId == second[i].aggressorId &&
+                           first[i].restingOrderId == second[i].restingOrderId && first[i].price == second[i].price &&
+                           first[i].quantity == second[i].quantity,
+                       "Same input, same trades");
+            }
+        }
+
+        return 0;
+    } catch (const std::exception& ex) {
+        LOG_ERROR("EngineShard tests failed: {}", ex.what());
+        return 1;
+    }
+}
@@ -0,0 +1,152 @@
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "datastructures/SpscQueue.h"
+#include "utils/HugePages.h"
+#include "utils/LogMacros.h"
+
+namespace {
+
+void expect(bool condition, const std::string& message) {
+    if (!condition) {
+        throw std::runtime_error(message);
+    }
+}
+
+bool alignedTo(const void* ptr, std::size_t align) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % align == 0;
+}
+
+uint64_t mapped(const memory::RegionStats& s) {
+    return s.hugetlb_bytes + s.thp_bytes + s.small_page_bytes;
+}
+
+// Small blocks come from one 2 MB slab and a freed block is handed out again.
+void slabBlocksAreReused() {
+    using memory::Region;
+    void* first = memory::allocate(Region::ARENAS, 100, 8);
+    void* line = memory::allocate(Region::ARENAS, 24, 64);
+    expect(alignedTo(first, 128) && alignedTo(line, 64), "slab blocks are aligned to their size class");
+    std::memset(first, 0xab, 100);
+    const memory::RegionStats after_two = memory::stats(Region::ARENAS);
+    expect(mapped(after_two) == memory::kHugePageSize, "two small blocks share one slab");
+    expect(after_two.live_bytes == 124, "live bytes track requested sizes");
+
+    memory::deallocate(Region::ARENAS, first, 100, 8);
+    void* again = memory::allocate(Region::ARENAS, 120, 8);
+    expect(again == first, "a freed block is reused by its size class");
+    memory::deallocate(Region::ARENAS, again, 120, 8);
+    memory::deallocate(Region::ARENAS, line, 24, 64);
+    expect(memory::stats(Region::ARENAS).live_bytes == 0, "every byte was returned");
+}
+
+// Large requests get a 2 MB-aligned mapping of their own that is unmapped on free.
+void largeRequestsAreMappedDirectly() {
+    using memory::Region;
+    const uint64_t before = mapped(memory::stats(Region::SOCKETS));
+    const std::size_t bytes = memory::kHugePageSize + 4096;
+    auto* buffer = static_cast<char*>(memory::allocate(Region::SOCKETS, bytes, 1));
+    expect(alignedTo(buffer, memory::kHugePageSize), "direct mappings start on a huge page boundary");
+    buffer[0] = 1;
+    buffer[bytes - 1] = 1;
+    expect(mapped(memory::stats(Region::SOCKETS)) - before == 2 * memory::kHugePageSize,
+           "direct mappings are rounded up to whole huge pages");
+    memory::deallocate(Region::SOCKETS, buffer, bytes, 1);
+    expect(mapped(memory::stats(Region::SOCKETS)) == before, "freeing a direct mapping unmaps it");
+}
+
+// hugetlb either gets the reserved pool or falls back and says so.
+void hugetlbFallsBack() {
+    using memory::Region;
+    void* block = memory::allocate(Region::QUEUES, 256, 64);
+    const memory::RegionStats s = memory::stats(Region::QUEUES);
+    expect(s.hugetlb_bytes > 0 || s.hugetlb_fallbacks > 0, "hugetlb is attempted before falling back");
+    expect(s.hugetlb_bytes > 0 || s.thp_bytes + s.small_page_bytes > 0, "a fallback still maps a slab");
+    memory::deallocate(Region::QUEUES, block, 256, 64);
+}
+
+// Containers on the allocator behave like ordinary ones.
+void queueOnHugePages() {
+    SpscQueue<uint64_t> queue(1024);
+    for (uint64_t i = 0; i < 1000; ++i) {
+        expect(queue.push(i), "queue accepts up to its capacity");
+    }
+    uint64_t value = 0;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        expect(queue.pop(value) && value == i, "queue keeps FIFO order");
+    }
+    std::vector<int, HugePageAllocator<int, memory::Region::LADDERS>> grown;
+    for (int i = 0; i < 100'000; ++i) {
+        grown.push_back(i);
+    }
+    expect(grown[99'999] == 99'999 && grown.size() == 100'000, "vector grows across size classes");
+}
+
+// Threads carve from their own slabs; what an exited thread freed is reused.
+void threadsKeepTheirOwnSlabs() {
+    using memory::Region;
+    void* kept = nullptr;
+    void* freed = nullptr;
+    std::thread worker([&] {
+        kept = memory::allocate(Region::LADDERS, 4096, 64);
+        freed = memory::allocate(Region::LADDERS, 4096, 64);
+        memory::deallocate(Region::LADDERS, freed, 4096, 64);
+    });
+    worker.join();
+    void* mine = memory::allocate(Region::LADDERS, 512, 64);
+    expect(reinterpret_cast<std::uintptr_t>(mine) / memory::kHugePageSize !=
+               reinterpret_cast<std::uintptr_t>(kept) / memory::kHugePageSize,
+           "each thread carves its own slab");
+    bool reused = false;
+    std::vector<void*> blocks;
+    for (std::size_t i = 0; i < 2 * memory::kHugePageSize / 4096 && !reused; ++i) {
+        blocks.push_back(memory::allocate(Region::LADDERS, 4096, 64));
+        reused = blocks.back() == freed;
+    }
+    expect(reused, "blocks freed by an exited thread are handed out again");
+    for (void* block : blocks) {
+        memory::deallocate(Region::LADDERS, block, 4096, 64);
+    }
+    memory::deallocate(Region::LADDERS, mine, 512, 64);
+    memory::deallocate(Region::LADDERS, kept, 4096, 64);
+}
+
+// A region keeps the mode its live blocks were allocated with.
+void modeIsFixedOnceAllocated() {
+    HugePageSettings settings;
+    settings.ladders = HugePageMode::OFF;
+    settings.arenas = HugePageMode::THP;
+    settings.queues = HugePageMode::HUGETLB;
+    settings.sockets = HugePageMode::THP;
+    memory::configureHugePages(settings);
+    expect(memory::stats(memory::Region::LADDERS).mode == HugePageMode::THP, "allocated region keeps its mode");
+}
+
+}  // namespace
+
+int main() {
+    try {
+        HugePageSettings settings;
+        settings.ladders = HugePageMode::THP;
+        settings.arenas = HugePageMode::THP;
+        settings.queues = HugePageMode::HUGETLB;
+        settings.sockets = HugePageMode::THP;
+        memory::configureHugePages(settings);
+
+        slabBlocksAreReused();
+        largeRequestsAreMappedDirectly();
+        hugetlbFallsBack();
+        queueOnHugePages();
+        threadsKeepTheirOwnSlabs();
+        modeIsFixedOnceAllocated();
+        memory::logHugePageReport();
+        return 0;
+    } catch (const std::exception& ex) {
+        LOG_ERROR("Huge page tests failed: {}", ex.what());
+        return 1;
+    }
+}
@@ -0,0 +1,103 @@
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "datastructures/MpscQueue.h"
+#include "ingress/OrderQueue.h"
+#include "utils/LogMacros.h"
+
+namespace {
+
+void expect(bool condition, const std::string& message) {
+    if (!condition) {
+        throw std::runtime_error(message);
+    }
+}
+
+// Items carry (producer << 32 | sequence) so the consumer can check per-producer FIFO.
+void concurrentProducers(std::size_t producers, uint64_t per_producer) {
+    MpscQueue<uint64_t> queue(128);
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, &go, p, per_producer] {
+            while (!go.load(std::memory_order_acquire)) {
+            }
+            for (uint64_t i = 0; i < per_producer; ++i) {
+                while (!queue.push((static_cast<uint64_t>(p) << 32) | i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint64_t> next(producers, 0);
+    uint64_t received = 0;
+    go.store(true, std::memory_order_release);
+    while (received < producers * per_producer) {
+        const std::size_t n = queue.consume(16, [&](uint64_t item) {
+            const auto producer = static_cast<std::size_t>(item >> 32);
+            expect(producer < producers, "Unknown producer id");
+            expect((item & 0xffffffffULL) == next[producer]++, "Per-producer FIFO order violated");
+        });
+        if (n == 0) {
+            std::this_thread::yield();
+        }
+        received += n;
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    expect(queue.read_available() == 0, "Queue should be empty after draining every producer");
+}
+
+}  // namespace
+
+int main() {
+    try {
+        {
+            MpscQueue<int> queue(3);
+            expect(queue.capacity() == 4, "Capacity rounds up to a power of two");
+            for (int i = 0; i < 4; ++i) {
+                expect(queue.push(i), "Every slot is usable");
+            }
+            expect(!queue.push(4) && queue.write_available() == 0, "Push into a full queue fails");
+            int value = -1;
+            for (int i = 0; i < 10; ++i) {
+                expect(queue.pop(value) && value == i, "FIFO order across laps");
+                expect(queue.push(i + 4), "Freed cell is reusable on the next lap");
+            }
+            int seen = 0;
+            expect(queue.consume(8, [&](int item) { expect(item == 10 + seen++, "consume order"); }) == 4,
+                   "consume drains what is ready");
+            expect(!queue.pop(value), "Pop from an empty queue fails");
+        }
+
+        concurrentProducers(1, 200'000);
+        concurrentProducers(4, 100'000);
+
+        {
+            ingress::OrderQueue single(8);
+            ingress::OrderQueue multi(8, true);
+            expect(single.single() != nullptr && !single.multiProducer(), "Default OrderQueue is SPSC");
+            expect(multi.single() == nullptr && multi.multiProducer(), "multi_producer selects MPSC");
+            ingress::WireOrder order{};
+            for (OrderId id = 1; id <= 3; ++id) {
+                order.order_id = id;
+                expect(single.push(order) && multi.push(order), "OrderQueue push");
+            }
+            OrderId expected_single = 1;
+            OrderId expected_multi = 1;
+            single.consume(8, [&](const ingress::WireOrder& o) { expect(o.order_id == expected_single++, "SPSC order"); });
+            multi.consume(8, [&](const ingress::WireOrder& o) { expect(o.order_id == expected_multi++, "MPSC order"); });
+            expect(expected_single == 4 && expected_multi == 4, "Both OrderQueue paths drain everything");
+        }
+        return 0;
+    } catch (const std::exception& ex) {
+        LOG_ERROR("MpscQueue tests failed: {}", ex.what());
+        return 1;
+    }
+}
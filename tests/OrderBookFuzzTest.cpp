@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ReferenceMatcher.h"
+#include "core/OrderBook.h"
+#include "core/OrderBuilder.h"
+#include "utils/LogMacros.h"
+
+// Randomized cross-check of every OrderBook backend against ReferenceMatcher.
+// Usage: order_book_fuzz_tests [messages-per-backend] [seed]
+
+namespace {
+
+void expect(bool condition, const std::string& message) {
+    if (!condition) {
+        throw std::runtime_error(message);
+    }
+}
+
+using Trade = ReferenceMatcher::Trade;
+
+// Trade sink; safe to call from a trade publisher thread.
+class TradeCapture {
+public:
+    void onTrades(TradeBatch trades) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const TradeEvent& event : trades) {
+            trades_.push_back({event.aggressorId, event.restingOrderId, event.price, event.quantity});
+        }
+        count_.store(trades_.size(), std::memory_order_release);
+    }
+
+    bool waitFor(size_t expected) const {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        uint32_t spins = 0;
+        while (count_.load(std::memory_order_acquire) < expected) {
+            if (++spins % 1000 == 0) {
+                std::this_thread::yield();
+                if (std::chrono::steady_clock::now() > deadline) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    size_t count() const { return count_.load(std::memory_order_acquire); }
+
+    Trade at(size_t index) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return trades_[index];
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<Trade> trades_;
+    std::atomic<size_t> count_{0};
+};
+
+enum class MessageKind { Add, Cancel, Modify };
+
+struct Message {
+    MessageKind kind = MessageKind::Add;
+    OrderId id = 0;
+    Side side = Side::BUY;
+    Price price = 0;
+    Qty qty = 0;
+    Qty display = 0;
+    OrderType type = OrderType::LIMIT;
+};
+
+// Drifting mid with mostly near-touch flow, occasional crossing and far-away
+// orders (ring overflow), and rare jumps that force the window to re-centre.
+class FlowGenerator {
+public:
+    explicit FlowGenerator(uint64_t seed) : rng_(seed) {}
+
+    // Ids only leave the candidate pool lazily, once the reference says they stopped resting.
+    Message next(const ReferenceMatcher& reference) {
+        if (++ticks_ % 100 == 0) {
+            mid_ = drift(mid_, pick(-3, 3));
+        }
+        if (pick(0, 4999) == 0) {
+            mid_ = drift(mid_, pick(0, 1) ? 2500 : -2500);
+        }
+
+        const int roll = pick(0, 99);
+        if (roll < 20) {
+            if (auto id = pickResting(reference)) {
+                return {MessageKind::Cancel, id};
+            }
+        } else if (roll < 35) {
+            if (auto id = pickResting(reference)) {
+                return modifyOf(id, reference);
+            }
+        }
+        return addOf(roll);
+    }
+
+    void onAdded(OrderId id, const ReferenceMatcher& reference) {
+        if (reference.isResting(id)) {
+            live_.push_back(id);
+        }
+    }
+
+private:
+    std::mt19937_64 rng_;
+    Price mid_ = 100'000;
+    uint64_t ticks_ = 0;
+    OrderId next_id_ = 1;
+    std::vector<OrderId> live_;
+
+    int pick(int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng_); }
+
+    static Price drift(Price price, int delta) {
+        const auto moved = static_cast<int64_t>(price) + delta;
+        return static_cast<Price>(std::max<int64_t>(moved, 5'000));
+    }
+
+    OrderId pickResting(const ReferenceMatcher& reference) {
+        while (!live_.empty()) {
+            const auto index = static_cast<size_t>(pick(0, static_cast<int>(live_.size()) - 1));
+            const OrderId id = live_[index];
+            if (reference.isResting(id)) {
+                return id;
+            }
+            live_[index] = live_.back();
+            live_.pop_back();
+        }
+        return 0;
+    }
+
+    Message addOf(int roll) {
+        Message msg;
+        msg.id = next_id_++;
+        msg.side = pick(0, 1) ? Side::BUY : Side::SELL;
+        int offset = pick(-8, 40);
+        if (pick(0, 99) == 0) {
+            offset += pick(1'500, 4'000);
+        }
+        msg.price = drift(mid_, msg.side == Side::BUY ? -offset : offset);
+        msg.qty = static_cast<Qty>(pick(1, 20));
+
+        if (roll < 45) {
+            msg.type = OrderType::LIMIT;
+        } else if (roll < 55) {
+            msg.type = OrderType::ICEBERG;
+            msg.qty = static_cast<Qty>(pick(20, 100));
+            msg.display = static_cast<Qty>(pick(0, 3) == 0 ? 0 : pick(1, 10));
+        } else if (roll < 75) {
+            msg.type = OrderType::IOC;
+        } else if (roll < 90) {
+            msg.type = OrderType::FOK;
+        } else {
+            msg.type = OrderType::MARKET;
+            msg.price = 0;
+        }
+        return msg;
+    }
+
+    Message modifyOf(OrderId id, const ReferenceMatcher& reference) {
+        Message msg;
+        msg.kind = MessageKind::Modify;
+        msg.id = id;
+        const Qty filled = reference.filled(id);
+        const Qty total = reference.total(id);
+        msg.price = reference.price(id);
+        if (pick(0, 1)) {
+            msg.price = drift(msg.price, pick(-10, 10));
+        }
+        // Never below the filled quantity: that path only logs and is covered elsewhere.
+        msg.qty = static_cast<Qty>(pick(static_cast<int>(filled), static_cast<int>(total) * 2));
+        return msg;
+    }
+};
+
+std::unique_ptr<Order> toOrder(const Message& msg) {
+    auto builder = OrderBuilder()
+        .setOrderId(msg.id)
+        .setInstrumentToken(1)
+        .setSide(msg.side)
+        .setPrice(msg.price)
+        .setQuantity(msg.qty)
+        .setTimestamp(std::chrono::high_resolution_clock::now())
+        .setOrderType(msg.type);
+    if (msg.display > 0) {
+        builder.setDisplayQuantity(msg.display);
+    }
+    return builder.build();
+}
+
+std::string describe(const Trade& trade) {
+    return "{aggressor=" + std::to_string(trade.aggressor) + " resting=" + std::to_string(trade.resting) +
+           " px=" + std::to_string(trade.price) + " qty=" + std::to_string(trade.qty) + "}";
+}
+
+void compareBooks(const OrderBook& book, const ReferenceMatcher& reference, const std::string& where) {
+    std::vector<std::pair<Price, Qty>> bids, asks;
+    book.snapshot(bids, asks);
+    std::sort(bids.begin(), bids.end());
+    std::sort(asks.begin(), asks.end());
+    expect(bids == reference.levels(Side::BUY), where + ": bid levels diverged");
+    expect(asks == reference.levels(Side::SELL), where + ": ask levels diverged");
+
+    const Order* bid = book.bestBid();
+    const Order* ask = book.bestAsk();
+    expect((bid ? bid->orderId() : 0) == reference.bestHead(Side::BUY), where + ": best bid head diverged");
+    expect((ask ? ask->orderId() : 0) == reference.bestHead(Side::SELL), where + ": best ask head diverged");
+}
+
+void runBackend(BookBackend backend, uint64_t messages, uint64_t seed) {
+    constexpr uint64_t kCheckEvery = 1'000;
+
+    TradeCapture capture;
+    ReferenceMatcher reference;
+    FlowGenerator flow(seed);
+    {
+        OrderBook book(backend);
+        book.setInstrumentToken(1);
+        book.clearTradeSinks();
+        book.addTradeSink(capture);
+
+        size_t checked = 0;
+        for (uint64_t i = 0; i < messages; ++i) {
+            const Message msg = flow.next(reference);
+            const auto where = [&] {
+                return std::string(toString(backend)) + " seed " + std::to_string(seed) + " message " +
+                       std::to_string(i);
+            };
+            switch (msg.kind) {
+                case MessageKind::Add:
+                    book.addOrder(toOrder(msg));
+                    reference.add(msg.id, msg.side, msg.price, msg.qty, msg.type, msg.display);
+                    flow.onAdded(msg.id, reference);
+                    break;
+                case MessageKind::Cancel:
+                    expect(book.cancelOrder(msg.id) == reference.cancel(msg.id), where() + ": cancel result diverged");
+                    break;
+                case MessageKind::Modify:
+                    book.modifyOrder(msg.id, msg.price, msg.qty);
+                    reference.modify(msg.id, msg.price, msg.qty);
+                    break;
+            }
+
+            const auto& expected = reference.trades();
+            expect(capture.waitFor(expected.size()), where() + ": engine produced fewer trades than the reference");
+            for (; checked < expected.size(); ++checked) {
+                const Trade actual = capture.at(checked);
+                expect(actual == expected[checked],
+                       where() + ": trade " + std::to_string(checked) + " engine " + describe(actual) +
+                           " reference " + describe(expected[checked]));
+            }
+            if (i % kCheckEvery == 0 || i + 1 == messages) {
+                expect(capture.count() == expected.size(), where() + ": engine produced extra trades");
+                compareBooks(book, reference, where());
+            }
+        }
+    }
+    expect(capture.count() == reference.trades().size(), std::string(toString(backend)) + ": trades after shutdown");
+    LOG_INFO("Fuzz {} seed {}: {} messages, {} trades match the reference",
+             toString(backend), seed, messages, reference.trades().size());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const uint64_t messages = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+    const uint64_t seed = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 20251108;
+    try {
+        for (BookBackend backend : {BookBackend::RING, BookBackend::RB_TREE, BookBackend::STD_MAP,
+                                    BookBackend::CHUNK_MAP}) {
+            runBackend(backend, messages, seed);
+        }
+        return 0;
+    } catch (const std::exception& ex) {
+        LOG_ERROR("OrderBook fuzz tests failed: {}", ex.what());
+        return 1;
+    }
+}
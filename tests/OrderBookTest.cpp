@@ -1,11 +1,18 @@
 #include <chrono>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+#include "core/ExecReportPublisher.h"
 #include "core/OrderBook.h"
 #include "core/OrderBookManager.h"
 #include "core/OrderBuilder.h"
+#include "datastructures/PriceChunkMap.h"
 #include "utils/LogMacros.h"
 
 namespace {
@@ -18,9 +25,10 @@ void expect(bool condition, const char* message) {
 
 std::unique_ptr<Order> makeOrder(OrderId id, Side side, Price price, Qty qty,
                                  OrderType type = OrderType::LIMIT, Qty display = 0,
-                                 InstrumentToken token = 1) {
+                                 InstrumentToken token = 1, uint64_t sequence = 0) {
     auto builder = OrderBuilder()
         .setOrderId(id)
+        .setSequence(sequence)
         .setInstrumentToken(token)
         .setSide(side)
         .setPrice(price)
@@ -174,6 +182,155 @@ int main() {
             expect(book.totalOpenQtyAt(Side::SELL, 1000) == 0, "All liquidity gone after final clip");
         }
 
+        {
+            OrderBook book;
+            // Levels far outside the ladder window are parked, not dropped.
+            book.addOrder(makeOrder(90, Side::BUY, 1000, 5));
+            book.addOrder(makeOrder(91, Side::BUY, 5000, 3));
+            expect(book.totalOpenQtyAt(Side::BUY, 1000) == 5, "Bid evicted by the window shift must survive");
+            book.addOrder(makeOrder(92, Side::BUY, 200, 4));
+            expect(book.totalOpenQtyAt(Side::BUY, 200) == 4, "Deep bid should rest in overflow");
+
+            book.addOrder(makeOrder(93, Side::SELL, 5000, 3));
+            const Order* nextBid = book.bestBid();
+            expect(nextBid && nextBid->price() == 1000, "Best bid should come back from overflow");
+
+            book.addOrder(makeOrder(94, Side::SELL, 200, 9));
+            expect(book.bestBid() == nullptr, "Sell sweep should consume ring and overflow bids");
+            expect(book.totalOpenQtyAt(Side::SELL, 200) == 0, "Sweep should fully fill");
+
+            book.addOrder(makeOrder(95, Side::SELL, 3000, 2));
+            book.addOrder(makeOrder(96, Side::SELL, 90000, 2));
+            expect(book.cancelOrder(96), "Overflow ask should be cancellable");
+            expect(book.totalOpenQtyAt(Side::SELL, 90000) == 0, "Cancelled overflow level should be erased");
+        }
+
+        {
+            OrderBook book;
+            book.addOrder(makeOrder(60, Side::SELL, 1000, 7));
+            book.addOrder(makeOrder(61, Side::SELL, 1001, 7));
+            // Aggressive iceberg sweeps past its 5-lot display slice.
+            book.addOrder(makeOrder(62, Side::BUY, 1001, 20, OrderType::ICEBERG, 5));
+            expect(book.totalOpenQtyAt(Side::SELL, 1000) == 0 && book.totalOpenQtyAt(Side::SELL, 1001) == 0,
+                   "Iceberg aggressor should sweep both ask levels");
+            expect(book.totalOpenQtyAt(Side::BUY, 1001) == 5, "Iceberg remainder should rest with a full slice");
+
+            book.modifyOrder(62, 1001, 16);
+            expect(book.totalOpenQtyAt(Side::BUY, 1001) == 2, "Size reduction should shrink, not refill, the slice");
+            book.modifyOrder(62, 1001, 14);
+            expect(book.bestBid() == nullptr, "Reducing to the filled quantity should remove the order");
+        }
+
+        {
+            // Enough keys to force leaf splits, then erase down through merges.
+            PriceChunkMap<Price, int, std::greater<Price>, 4> chunks;
+            for (Price px = 1; px <= 40; ++px) {
+                *chunks.emplace(px * 10) = static_cast<int>(px);
+            }
+            expect(chunks.size() == 40 && chunks.leafCount() > 1, "Chunk map should split into several leaves");
+            Price top = 0;
+            expect(chunks.best(&top) && top == 400, "Descending chunk map best should be the highest key");
+            expect(chunks.find(250) && *chunks.find(250) == 25, "Chunk map lookup mismatch");
+            expect(chunks.find(255) == nullptr, "Chunk map should not find absent keys");
+
+            Price prev = std::numeric_limits<Price>::max();
+            bool ordered = true;
+            chunks.inOrder([&](const Price& px, int&) {
+                ordered = ordered && px < prev;
+                prev = px;
+            });
+            expect(ordered, "Chunk map iteration should follow the comparator");
+
+            for (Price px = 1; px <= 40; ++px) {
+                if (px % 5 != 0) {
+                    expect(chunks.erase(px * 10), "Chunk map erase should find the key");
+                }
+            }
+            expect(chunks.size() == 8, "Chunk map size after erase mismatch");
+            expect(chunks.leafCount() <= 4, "Sparse leaves should merge");
+            expect(chunks.best(&top) && top == 400 && chunks.find(50), "Chunk map should keep surviving keys");
+        }
+
+        {
+            OrderBook book(BookBackend::CHUNK_MAP);
+
+            for (OrderId id = 100; id < 140; ++id) {
+                const Price offset = static_cast<Price>(id - 100) * 250;
+                book.addOrder(makeOrder(id, Side::BUY, 20000 - offset, 2));
+                book.addOrder(makeOrder(id + 100, Side::SELL, 30000 + offset, 2));
+            }
+            expect(book.bestBid() && book.bestBid()->price() == 20000, "Chunk map best bid mismatch");
+            expect(book.bestAsk() && book.bestAsk()->price() == 30000, "Chunk map best ask mismatch");
+
+            expect(book.cancelOrder(100), "Chunk map best bid should be cancellable");
+            expect(book.bestBid() && book.bestBid()->price() == 19750, "Best bid should move to the next level");
+
+            book.addOrder(makeOrder(300, Side::BUY, 32000, 20));
+            expect(book.totalOpenQtyAt(Side::BUY, 32000) == 2, "Buy should sweep nine ask levels and rest 2");
+            expect(book.bestAsk() && book.bestAsk()->price() == 32250, "Best ask after sweep mismatch");
+
+            std::vector<std::pair<Price, Qty>> bids, asks;
+            book.snapshot(bids, asks);
+            expect(bids.size() == 40 && asks.size() == 31, "Chunk map snapshot depth mismatch");
+        }
+
+        {
+            OrderBook book;
+            PriceBandSettings bands;
+            bands.reference_price = 1000;
+            bands.static_band_bps = 500;
+            bands.dynamic_band_bps = 200;
+            book.setPriceBands(bands);
+
+            book.addOrder(makeOrder(70, Side::BUY, 1060, 5));
+            expect(book.totalOpenQtyAt(Side::BUY, 1060) == 0, "Order outside the static band must be rejected");
+            expect(book.bandRejects() == 1, "Static band reject should be counted");
+
+            book.addOrder(makeOrder(71, Side::SELL, 1000, 5));
+            book.addOrder(makeOrder(72, Side::BUY, 1000, 5));
+            book.addOrder(makeOrder(73, Side::SELL, 1030, 5));
+            expect(book.totalOpenQtyAt(Side::SELL, 1030) == 0, "Order outside the dynamic band must be rejected");
+
+            book.addOrder(makeOrder(74, Side::SELL, 1015, 5));
+            book.addOrder(makeOrder(75, Side::BUY, 985, 5));
+            book.addOrder(makeOrder(76, Side::SELL, 985, 5));
+            // Last trade 985 moves the dynamic band to [966, 1004]; a market buy may not reach 1015.
+            book.addOrder(makeOrder(77, Side::BUY, 0, 5, OrderType::MARKET));
+            expect(book.totalOpenQtyAt(Side::SELL, 1015) == 5, "Market order must stop at the band protection price");
+        }
+
+        {
+            OrderBook book;
+            PriceBandSettings bands;
+            bands.volatility_move_bps = 100;
+            bands.volatility_window_ms = 1000;
+            bands.halt_ms = 500;
+            book.setPriceBands(bands);
+
+            book.addOrder(makeOrder(80, Side::SELL, 1000, 5));
+            book.addOrder(makeOrder(81, Side::SELL, 1020, 5));
+            book.addOrder(makeOrder(82, Side::BUY, 1000, 5));
+            expect(book.tradingState() == TradingState::Continuous, "First trade only anchors the window");
+
+            book.addOrder(makeOrder(83, Side::BUY, 1020, 5));
+            expect(book.tradingState() == TradingState::Halted, "2% move inside the window should halt the book");
+
+            book.addOrder(makeOrder(84, Side::SELL, 1030, 1));
+            expect(book.totalOpenQtyAt(Side::SELL, 1030) == 0, "Halted book must not accept orders");
+
+            auto resumed = OrderBuilder()
+                .setOrderId(85)
+                .setInstrumentToken(1)
+                .setSide(Side::SELL)
+                .setPrice(1030)
+                .setQuantity(1)
+                .setTimestamp(std::chrono::high_resolution_clock::now() + std::chrono::seconds(1))
+                .build();
+            book.addOrder(std::move(resumed));
+            expect(book.tradingState() == TradingState::Continuous, "Halt should lift after halt_ms");
+            expect(book.totalOpenQtyAt(Side::SELL, 1030) == 1, "Orders should rest again after the halt");
+        }
+
         {
             OrderBookManager manager;
             const InstrumentToken nifty = 111;
@@ -196,6 +353,115 @@ int main() {
             expect(manager.bestBid(bank) == nullptr, "All bank orders should fill out");
         }
 
+        {
+            // The leaves hook sees every order that leaves unfilled and every modify,
+            // with no report publisher set.
+            std::vector<std::pair<OrderId, int64_t>> changes;
+            OrderBook book;
+            book.clearTradeSinks();
+            book.setLeavesHook(
+                [](void* context, OrderId orderId, int64_t delta) {
+                    static_cast<std::vector<std::pair<OrderId, int64_t>>*>(context)->emplace_back(orderId, delta);
+                },
+                &changes);
+            PriceBandSettings bands;
+            bands.reference_price = 1000;
+            bands.static_band_bps = 500;
+            book.setPriceBands(bands);
+
+            book.addOrder(makeOrder(80, Side::BUY, 1100, 5));   // band reject
+            book.addOrder(makeOrder(81, Side::SELL, 1000, 3));
+            book.addOrder(makeOrder(82, Side::BUY, 1000, 5, OrderType::IOC));  // 2 unfilled
+            book.addOrder(makeOrder(83, Side::BUY, 990, 4));
+            book.modifyOrder(83, 990, 3);
+            book.modifyOrder(83, 991, 6);
+            expect(book.cancelOrder(83), "Resting order should cancel");
+            book.addOrder(makeOrder(84, Side::SELL, 990, 1));  // no bids left, rests
+            const std::vector<std::pair<OrderId, int64_t>> expected{{80, -5}, {82, -2}, {83, -1}, {83, 3}, {83, -6}};
+            expect(changes == expected, "Reject, IOC remainder, modifies and cancel should each reach the hook once");
+        }
+
+        {
+            // Reserved level pools keep FIFO order next to overflow levels.
+            OrderBook book;
+            book.clearTradeSinks();
+            book.reserve(64, 3);
+            for (OrderId id = 1; id <= 5; ++id) {
+                book.addOrder(makeOrder(id, Side::SELL, 1000, 1));
+            }
+            book.addOrder(makeOrder(6, Side::SELL, 5000, 1));  // outside the ring window
+            book.addOrder(makeOrder(7, Side::BUY, 1000, 2));
+            expect(book.bestAsk() && book.bestAsk()->orderId() == 3, "Fills should take the oldest orders first");
+            for (OrderId id = 3; id <= 5; ++id) {
+                expect(book.cancelOrder(id), "Reserved nodes should cancel");
+            }
+            book.addOrder(makeOrder(8, Side::SELL, 1001, 4));
+            expect(book.totalOpenQtyAt(Side::SELL, 1001) == 4 && book.totalOpenQtyAt(Side::SELL, 5000) == 1,
+                   "Levels should work after their pools were reused");
+        }
+
+        {
+            // Execution reports: ack, fills on both sides, cancel, rejects, in datagram order.
+            // Sequenced orders stamp their reports and trades; API cancels are unsequenced.
+            std::vector<execution::ExecutionReport> reports;
+            std::vector<uint64_t> trade_sequences;
+            uint64_t last_sequence = 0;
+            {
+                ExecReportPublisher::Options options;
+                options.stream = 7;
+                ExecReportPublisher publisher(options, [&](const char* data, std::size_t len) {
+                    execution::ReportHeader header;
+                    const std::size_t before = reports.size();
+                    expect(execution::decodeReports(std::string_view(data, len), header, reports),
+                           "Datagram should decode");
+                    expect(header.stream == 7 && header.count > 0, "Header should carry the stream");
+                    expect(header.sequence == before, "Sequence should count the reports sent before");
+                });
+                OrderBook book;
+                book.clearTradeSinks();
+                book.setInstrumentToken(9);
+                book.setExecReportPublisher(&publisher);
+                const auto collect = [&](TradeBatch trades) {
+                    for (const TradeEvent& trade : trades) {
+                        trade_sequences.push_back(trade.sequence);
+                    }
+                };
+                book.addTradeSink(collect);
+                book.addOrder(makeOrder(1, Side::SELL, 100, 10, OrderType::LIMIT, 0, 9, 11));
+                book.addOrder(makeOrder(2, Side::BUY, 100, 4, OrderType::LIMIT, 0, 9, 12));
+                expect(book.cancelOrder(1), "Resting remainder should cancel");
+                expect(!book.cancelOrder(1), "Second cancel should fail");
+                book.addOrder(makeOrder(3, Side::BUY, 100, 5, OrderType::IOC, 0, 9, 13));
+                last_sequence = book.lastSequence();
+            }
+
+            using execution::ExecutionReport;
+            const auto is = [&](std::size_t idx, OrderId id, ExecType type, Qty last, Qty cum, Qty leaves) {
+                const ExecutionReport& r = reports[idx];
+                return r.order_id == id && r.type == type && r.last_qty == last && r.cum_qty == cum &&
+                       r.leaves_qty == leaves && r.instrument == 9;
+            };
+            expect(reports.size() == 8, "Eight reports expected");
+            expect(is(0, 1, ExecType::ACK, 0, 0, 10), "Resting sell should be acked");
+            expect(is(1, 2, ExecType::ACK, 0, 0, 4), "Aggressive buy should be acked");
+            expect(is(2, 2, ExecType::FILL, 4, 4, 0) && reports[2].price == 100, "Aggressor should fill");
+            expect(is(3, 1, ExecType::PARTIAL_FILL, 4, 4, 6), "Resting side should be partially filled");
+            expect(is(4, 1, ExecType::CANCEL, 0, 4, 0), "Cancel should report the filled quantity");
+            expect(is(5, 1, ExecType::REJECT, 0, 0, 0) && reports[5].reason == ExecReason::UNKNOWN_ORDER,
+                   "Cancel of a gone order should be rejected");
+            expect(is(6, 3, ExecType::ACK, 0, 0, 5), "IOC should be acked");
+            expect(is(7, 3, ExecType::CANCEL, 0, 0, 0) && reports[7].reason == ExecReason::UNFILLED,
+                   "Unfilled IOC should be cancelled");
+            expect(reports[1].side == static_cast<uint8_t>(Side::BUY) && reports[1].timestamp_ns > 0,
+                   "Reports should carry side and time");
+            const std::vector<uint64_t> expected_sequences{11, 12, 12, 12, 0, 0, 13, 13};
+            for (std::size_t idx = 0; idx < reports.size(); ++idx) {
+                expect(reports[idx].sequence == expected_sequences[idx], "Report should carry its order's sequence");
+            }
+            expect(trade_sequences == std::vector<uint64_t>{12}, "Trade should carry the aggressor's sequence");
+            expect(last_sequence == 13, "Book should remember the last sequence applied");
+        }
+
         return 0;
     } catch (const std::exception& ex) {
         LOG_ERROR("OrderBook tests failed: {}", ex.what());
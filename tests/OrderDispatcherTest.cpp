@@ -0,0 +1,331 @@
+#include <poll.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ingress/McastSocket.h"
+#include "ingress/OnboardingChannel.h"
+#include "ingress/OrderDispatcher.h"
+#include "ingress/OrderQueue.h"
+#include "ingress/Sequencer.h"
+#include "ingress/Throttle.h"
+#include "ingress/WireOrder.h"
+#include "utils/LogMacros.h"
+
+namespace {
+
+void expect(bool condition, const std::string& message) {
+    if (!condition) {
+        throw std::runtime_error(message);
+    }
+}
+
+}  // namespace
+
+int main() {
+    try {
+        {
+            ingress::WireOrder order{};
+            order.order_id = 7;
+            order.instrument = 35000;
+            order.side = Side::SELL;
+            order.price = 101;
+            order.quantity = 3;
+            const std::string line = ingress::serializeWireOrder(order);
+
+            InstrumentToken token = 0;
+            expect(ingress::peekWireInstrument(line, token) && token == 35000, "Peek reads the instrument column");
+            expect(!ingress::peekWireInstrument("7", token), "Peek rejects a line without an instrument");
+            expect(!ingress::peekWireInstrument("7,abc,BUY", token), "Peek rejects a non-numeric instrument");
+            expect(ingress::peekWireInstrument("7,26000", token) && token == 26000, "Peek accepts a final column");
+        }
+
+        {
+            ingress::OrderQueue a(8), b(8), c(8);
+            OrderDispatcher::RouteMap routes;
+            routes[1] = {&a};
+            routes[2] = {&b};
+            routes[3] = {&c};
+            const std::vector<InstrumentToken> universe{1, 2, 3, 4, 1};
+
+            const auto parts = partitionRoutes(routes, universe, 2);
+            expect(parts.size() == 2, "One route map per dispatcher");
+            expect(parts[0].size() == 3 && parts[1].size() == 3, "Every part knows every routed instrument");
+            expect(parts[0].at(1).queue == &a && parts[1].at(1).queue == nullptr, "Token 1 belongs to part 0");
+            expect(parts[0].at(2).queue == nullptr && parts[1].at(2).queue == &b, "Token 2 belongs to part 1");
+            expect(parts[0].at(3).queue == &c && parts[1].at(3).queue == nullptr, "Token 3 belongs to part 0");
+
+            const auto single = partitionRoutes(routes, universe, 0);
+            expect(single.size() == 1 && single[0].size() == 3, "Zero parts falls back to one dispatcher");
+        }
+
+        {
+            // Requests reach the engine side; replies wake only the asking dispatcher's fd.
+            ingress::OnboardingChannel channel(2);
+            ingress::OrderQueue queue(8);
+            const auto readable = [&channel](std::size_t dispatcher) {
+                pollfd fd{channel.replyFd(dispatcher), POLLIN, 0};
+                return ::poll(&fd, 1, 0) == 1;
+            };
+            expect(!readable(0) && !readable(1), "No replies yet");
+
+            channel.request(1, 42);
+            channel.request(1, 43);
+            std::vector<ingress::OnboardingChannel::Request> requests;
+            expect(channel.waitRequests(requests, std::chrono::milliseconds(10)), "Open channel keeps serving");
+            expect(requests.size() == 2 && requests[0].token == 42 && requests[0].dispatcher == 1,
+                   "Requests arrive in order with their dispatcher");
+
+            channel.reply(1, {42, &queue});
+            channel.reply(1, {43, nullptr});
+            expect(readable(1) && !readable(0), "Only the asking dispatcher is woken");
+            const auto replies = channel.takeReplies(1);
+            expect(replies.size() == 2 && replies[0].queue == &queue && replies[1].queue == nullptr,
+                   "Replies carry the route or a refusal");
+            expect(!readable(1) && channel.takeReplies(1).empty(), "Taking replies resets the fd");
+
+            std::thread closer([&channel] { channel.close(); });
+            expect(!channel.waitRequests(requests, std::chrono::seconds(5)), "Close ends the engine side");
+            closer.join();
+        }
+
+        {
+            // Concurrent stampers share one gap-free sequence, increasing per thread.
+            ingress::Sequencer sequencer;
+            expect(sequencer.last() == 0, "Nothing stamped yet");
+            constexpr std::size_t kPerThread = 10000;
+            std::vector<std::vector<uint64_t>> stamped(4);
+            std::vector<std::thread> threads;
+            for (auto& out : stamped) {
+                threads.emplace_back([&sequencer, &out] {
+                    for (std::size_t i = 0; i < kPerThread; ++i) {
+                        out.push_back(sequencer.next());
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            std::vector<bool> taken(stamped.size() * kPerThread + 1, false);
+            for (const auto& out : stamped) {
+                for (std::size_t i = 0; i < out.size(); ++i) {
+                    expect(out[i] > 0 && out[i] < taken.size() && !taken[out[i]], "Each number is handed out once");
+                    expect(i == 0 || out[i] > out[i - 1], "A thread sees increasing numbers");
+                    taken[out[i]] = true;
+                }
+            }
+            expect(sequencer.last() == stamped.size() * kPerThread, "Last is the count stamped");
+        }
+
+        {
+            // Two instruments on one SPSC queue (the risk stage's inbound) share its claim.
+            ingress::OrderQueue shared(128);
+            OrderDispatcher::RouteMap routes;
+            routes[1] = {&shared};
+            routes[2] = {&shared};
+            SocketUtils::McastSocket socket;
+            OrderDispatcher dispatcher(socket, routes);
+            constexpr OrderId kOrders = 70;  // spans more than one claim batch
+            for (OrderId id = 1; id <= kOrders; ++id) {
+                ingress::WireOrder order{};
+                order.order_id = id;
+                order.instrument = static_cast<InstrumentToken>(1 + id % 2);
+                order.side = Side::BUY;
+                order.price = 100;
+                order.quantity = 1;
+                dispatcher.handlePayload(ingress::serializeWireOrder(order));
+            }
+            dispatcher.flush();
+            expect(shared.read_available() == kOrders, "Every order of both instruments is published");
+            ingress::WireOrder out{};
+            for (OrderId id = 1; id <= kOrders; ++id) {
+                expect(shared.pop(out) && out.order_id == id && out.instrument == 1 + id % 2,
+                       "A shared queue keeps arrival order");
+            }
+            for (const auto& queue : dispatcher.queueStats()) {
+                expect(queue.high_water > 0, "Both instruments see the shared queue's depth");
+            }
+        }
+
+        {
+            // A full queue only affects its own instrument: 1 spills, 2 drops, 3 keeps flowing.
+            ingress::OrderQueue spill(4), drop(4), free(64);
+            OrderDispatcher::RouteMap routes;
+            routes[1] = {&spill};
+            routes[2] = {&drop};
+            routes[3] = {&free};
+            SocketUtils::McastSocket socket;
+            OrderDispatcher dispatcher(socket, routes);
+            std::vector<OrderId> rejected;
+            OrderDispatcher::Backpressure backpressure;
+            backpressure.overflow = IngressOverflow::DROP;
+            backpressure.spill_capacity = 2;
+            backpressure.overrides[1] = IngressOverflow::SPILL;
+            backpressure.overrides[3] = IngressOverflow::BLOCK;
+            dispatcher.setBackpressure(std::move(backpressure));
+            dispatcher.setRejectSink([&rejected](const ingress::WireOrder& order, ExecReason reason) {
+                expect(reason == ExecReason::OVERLOADED, "Queue overflow rejects as overloaded");
+                rejected.push_back(order.order_id);
+            });
+
+            const std::size_t capacity = spill.write_available();
+            OrderId next_id = 1;
+            for (std::size_t i = 0; i < capacity + 3; ++i) {
+                for (InstrumentToken token : {1u, 2u, 3u}) {
+                    ingress::WireOrder order{};
+                    order.order_id = next_id++;
+                    order.instrument = token;
+                    order.side = Side::BUY;
+                    order.price = 100;
+                    order.quantity = 1;
+                    dispatcher.handlePayload(ingress::serializeWireOrder(order));
+                }
+            }
+            dispatcher.flush();
+
+            expect(free.read_available() == capacity + 3, "The blocking instrument is not held up");
+            // Instrument 2 drops three orders; instrument 1's backlog holds two and drops the third.
+            expect(drop.read_available() == capacity && rejected.size() == 4, "Overflow past the queue is dropped");
+            expect(rejected.front() == 3 * capacity + 2, "The first order past the queue is rejected");
+            expect(spill.read_available() == capacity, "The spilling queue is full");
+
+            std::vector<OrderId> drained;
+            ingress::WireOrder out{};
+            while (spill.pop(out)) {
+                drained.push_back(out.order_id);
+            }
+            dispatcher.flush();
+            while (spill.pop(out)) {
+                drained.push_back(out.order_id);
+            }
+            expect(drained.size() == capacity + 2 && rejected.size() == 4, "The backlog is replayed, its overflow dropped");
+            for (std::size_t i = 0; i < drained.size(); ++i) {
+                expect(drained[i] == 3 * i + 1, "Spilled orders keep arrival order");
+            }
+
+            const auto stats = dispatcher.queueStats();
+            expect(stats.size() == 3, "Every routed instrument has stats");
+            for (const auto& queue : stats) {
+                if (queue.token == 1) {
+                    expect(queue.overflow == IngressOverflow::SPILL && queue.spilled == 2 && queue.dropped == 1,
+                           "Spill counts");
+                    expect(queue.high_water == capacity, "High water reaches the capacity");
+                } else if (queue.token == 2) {
+                    expect(queue.spilled == 0 && queue.dropped == 3, "Drop counts");
+                } else {
+                    expect(queue.overflow == IngressOverflow::BLOCK && queue.dropped == 0 &&
+                               queue.high_water == capacity + 3,
+                           "The free queue never overflows");
+                }
+            }
+        }
+
+        {
+            // Burst 2 at 1000/s: two orders pass at once, the third is due 1ms later.
+            ThrottleSettings settings;
+            settings.participant_rate = 1000;
+            settings.participant_burst = 2;
+            settings.max_participants = 4;
+            settings.instrument_rate = 1000;
+            settings.instrument_burst = 3;
+            ingress::Throttle throttle(settings);
+            ingress::WireOrder order{};
+            order.participant = 1;
+            ingress::Throttle::Bucket* instrument = throttle.bucketFor(9);
+            expect(instrument != nullptr && throttle.bucketFor(9) == instrument, "One bucket per instrument");
+
+            constexpr int64_t kMs = 1'000'000;
+            const int64_t now = 10 * kMs;
+            expect(throttle.admit(order, instrument, now, 0) == now, "First order of the burst");
+            expect(throttle.admit(order, instrument, now, 0) == now, "Second order of the burst");
+            expect(throttle.admit(order, instrument, now, 0) == ingress::Throttle::kRejected, "Over the burst");
+            expect(throttle.admit(order, instrument, now, 5 * kMs) == now + kMs, "Delayed by one interval");
+            expect(throttle.admit(order, instrument, now + kMs, 0) == ingress::Throttle::kRejected,
+                   "The delayed order used the refill");
+
+            // Participant 2 has a bucket of its own, but instrument 9 runs dry under it;
+            // the participant token of the refused order is handed back.
+            order.participant = 2;
+            expect(throttle.admit(order, instrument, now + kMs, 0) == now + kMs, "The instrument refilled one");
+            expect(throttle.admit(order, instrument, now + kMs, 0) == ingress::Throttle::kRejected,
+                   "The instrument limit applies to everyone");
+            expect(throttle.admit(order, nullptr, now + kMs, 0) == now + kMs,
+                   "A refused instrument does not cost the participant");
+
+            // Ids past max_participants share the last bucket.
+            order.participant = 100;
+            expect(throttle.admit(order, nullptr, now, 0) == now, "Unknown participants are limited too");
+            order.participant = 200;
+            expect(throttle.admit(order, nullptr, now, 0) == now, "Shared bucket, second token");
+            expect(throttle.admit(order, nullptr, now, 0) == ingress::Throttle::kRejected, "Shared bucket is empty");
+
+            const auto stats = throttle.throttled();
+            expect(stats.size() == 3 && stats[0].participant == 1 && stats[0].rejected == 2 && stats[0].delayed == 1,
+                   "Participant 1 was rejected twice and delayed once");
+            expect(stats[1].participant == 2 && stats[1].rejected == 1, "Participant 2 was rejected once");
+            expect(stats[2].participant == 4 && stats[2].rejected == 1, "Past max_participants counts as the last id");
+        }
+
+        {
+            // Through the dispatcher: participant 5 is rejected past its burst, participant 6 delayed.
+            ingress::OrderQueue queue(64);
+            OrderDispatcher::RouteMap routes;
+            routes[1] = {&queue};
+            SocketUtils::McastSocket socket;
+            ThrottleSettings settings;
+            settings.participant_burst = 1;
+            settings.participant_rates[5] = 1;
+            settings.participant_rates[6] = 500;
+            settings.max_participants = 8;
+            settings.action = ThrottleAction::DELAY;
+            settings.max_delay_us = 100'000;
+            ingress::Throttle throttle(settings);
+            ingress::Sequencer sequencer;
+            OrderDispatcher dispatcher(socket, routes);
+            dispatcher.setThrottle(&throttle);
+            dispatcher.setSequencer(&sequencer);
+            std::vector<OrderId> rejected;
+            dispatcher.setRejectSink([&rejected](const ingress::WireOrder& order, ExecReason reason) {
+                expect(reason == ExecReason::THROTTLED, "Rate rejects are throttled");
+                rejected.push_back(order.order_id);
+            });
+
+            const auto send = [&dispatcher](OrderId id, ParticipantId participant) {
+                ingress::WireOrder order{};
+                order.order_id = id;
+                order.instrument = 1;
+                order.side = Side::SELL;
+                order.price = 100;
+                order.quantity = 1;
+                order.participant = participant;
+                dispatcher.handlePayload(ingress::serializeWireOrder(order));
+            };
+            send(1, 5);
+            send(2, 6);
+            send(3, 6);  // due 2ms later
+            send(4, 5);  // a second away, past max_delay: rejected
+            send(5, 7);
+            dispatcher.flush();
+            expect(rejected.size() == 1 && rejected[0] == 4, "Only the order beyond max_delay is rejected");
+            expect(queue.read_available() == 3, "The delayed order is held");
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            dispatcher.flush();
+            std::vector<ingress::WireOrder> routed;
+            ingress::WireOrder out{};
+            while (queue.pop(out)) {
+                routed.push_back(out);
+            }
+            expect(routed.size() == 4 && routed[3].order_id == 3, "The delayed order is routed once due");
+            expect(routed[2].order_id == 5 && routed[3].sequence > routed[2].sequence,
+                   "A delayed order is stamped on release");
+        }
+        return 0;
+    } catch (const std::exception& ex) {
+        LOG_ERROR("OrderDispatcher tests failed: {}", ex.what());
+        return 1;
+    }
+}
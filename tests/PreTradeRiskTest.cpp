@@ -0,0 +1,256 @@
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "core/ExecReportPublisher.h"
+#include "core/OrderBook.h"
+#include "core/OrderBuilder.h"
+#include "risk/PreTradeRisk.h"
+#include "risk/RiskStage.h"
+#include "utils/LogMacros.h"
+
+namespace {
+
+void expect(bool condition, const char* message) {
+    if (!condition) {
+        throw std::runtime_error(message);
+    }
+}
+
+ingress::WireOrder makeOrder(OrderId id, ParticipantId participant, Side side, Price price, Qty qty,
+                             OrderType type = OrderType::LIMIT) {
+    ingress::WireOrder order{};
+    order.order_id = id;
+    order.instrument = 1;
+    order.side = side;
+    order.price = price;
+    order.quantity = qty;
+    order.type = type;
+    order.participant = participant;
+    return order;
+}
+
+std::unique_ptr<Order> toBookOrder(const ingress::WireOrder& wire) {
+    return OrderBuilder()
+        .setOrderId(wire.order_id)
+        .setInstrumentToken(wire.instrument)
+        .setSide(wire.side)
+        .setPrice(wire.price)
+        .setQuantity(wire.quantity)
+        .setTimestamp(std::chrono::high_resolution_clock::now())
+        .setOrderType(wire.type)
+        .build();
+}
+
+TradeEvent makeTrade(OrderId aggressor, OrderId resting, Qty qty) {
+    return TradeEvent{1, Side::BUY, aggressor, Side::SELL, resting, 1000, qty, 0};
+}
+
+}  // namespace
+
+int main() {
+    try {
+        {
+            RiskSettings settings;
+            settings.max_participants = 4;
+            settings.max_order_qty = 100;
+            settings.max_notional = 50'000;
+            risk::PreTradeRisk risk(settings);
+
+            expect(risk.check(makeOrder(1, 0, Side::BUY, 100, 100)) == risk::RiskResult::Accepted,
+                   "Order at qty limit should pass");
+            expect(risk.check(makeOrder(2, 0, Side::BUY, 100, 101)) == risk::RiskResult::MaxOrderQty,
+                   "Order above qty limit should be rejected");
+            expect(risk.check(makeOrder(3, 0, Side::BUY, 1000, 60)) == risk::RiskResult::MaxNotional,
+                   "Order above notional limit should be rejected");
+            expect(risk.check(makeOrder(4, 9, Side::BUY, 100, 1)) == risk::RiskResult::UnknownParticipant,
+                   "Participant outside the table should be rejected");
+            expect(risk.rejected(risk::RiskResult::MaxOrderQty) == 1, "Qty reject counter mismatch");
+        }
+
+        {
+            RiskSettings settings;
+            settings.max_participants = 4;
+            settings.max_open_orders = 2;
+            risk::PreTradeRisk risk(settings);
+
+            expect(risk.check(makeOrder(10, 1, Side::SELL, 1000, 5)) == risk::RiskResult::Accepted, "First open order");
+            expect(risk.check(makeOrder(11, 1, Side::SELL, 1000, 5)) == risk::RiskResult::Accepted, "Second open order");
+            expect(risk.check(makeOrder(12, 1, Side::SELL, 1000, 5)) == risk::RiskResult::MaxOpenOrders,
+                   "Third open order should breach the limit");
+            expect(risk.check(makeOrder(13, 2, Side::SELL, 1000, 5)) == risk::RiskResult::Accepted,
+                   "Limits are tracked per participant");
+
+            // IOC orders never rest, so they do not count towards open orders.
+            expect(risk.check(makeOrder(14, 3, Side::BUY, 1000, 5, OrderType::IOC)) == risk::RiskResult::Accepted,
+                   "IOC aggressor should pass");
+            risk.onTrade(makeTrade(14, 10, 5));
+            expect(risk.openOrders(1) == 1, "Fully filled resting order should release its open slot");
+            expect(risk.position(1) == -5, "Seller position should reflect the fill");
+            expect(risk.position(3) == 5, "Buyer position should reflect the fill");
+            expect(risk.check(makeOrder(15, 1, Side::SELL, 1000, 5)) == risk::RiskResult::Accepted,
+                   "Released slot should admit a new order");
+        }
+
+        {
+            RiskSettings settings;
+            settings.max_participants = 2;
+            settings.max_position = 10;
+            risk::PreTradeRisk risk(settings);
+
+            expect(risk.check(makeOrder(20, 0, Side::BUY, 1000, 6)) == risk::RiskResult::Accepted, "Within position");
+            expect(risk.check(makeOrder(21, 0, Side::BUY, 1000, 5)) == risk::RiskResult::MaxPosition,
+                   "Open buys plus new order would exceed the position limit");
+            expect(risk.check(makeOrder(22, 0, Side::SELL, 1000, 10)) == risk::RiskResult::Accepted,
+                   "Opposite side reduces worst-case exposure");
+
+            risk.onTrade(TradeEvent{1, Side::SELL, 23, Side::BUY, 20, 1000, 6, 0});
+            expect(risk.position(0) == 6, "Resting buy fill should update position");
+            expect(risk.check(makeOrder(24, 0, Side::BUY, 1000, 4)) == risk::RiskResult::Accepted,
+                   "Filled qty moves from open exposure to position");
+            expect(risk.check(makeOrder(25, 0, Side::BUY, 1000, 1)) == risk::RiskResult::MaxPosition,
+                   "Position plus open buys is at the limit");
+        }
+
+        {
+            // Cancels and rejects free the open slots and exposure they reserved.
+            RiskSettings settings;
+            settings.max_participants = 2;
+            settings.max_open_orders = 2;
+            settings.max_position = 10;
+            risk::PreTradeRisk risk(settings);
+
+            expect(risk.check(makeOrder(30, 0, Side::BUY, 1000, 5)) == risk::RiskResult::Accepted, "First buy");
+            expect(risk.check(makeOrder(31, 0, Side::BUY, 1000, 5)) == risk::RiskResult::Accepted, "Second buy");
+            expect(risk.check(makeOrder(32, 0, Side::BUY, 1000, 1)) == risk::RiskResult::MaxOpenOrders,
+                   "Third buy should breach the open order limit");
+
+            risk.onLeavesChange(30, -5);
+            expect(risk.openOrders(0) == 1, "Cancel should release the open slot");
+            expect(risk.check(makeOrder(33, 0, Side::BUY, 1000, 5)) == risk::RiskResult::Accepted,
+                   "Cancelled quantity should no longer count towards the position limit");
+
+            risk.onTrade(TradeEvent{1, Side::SELL, 40, Side::BUY, 31, 1000, 2, 0});
+            risk.onLeavesChange(31, -3);
+            expect(risk.openOrders(0) == 1 && risk.position(0) == 2, "Partial fill then cancel should settle");
+
+            // A cancel may overtake fills that are still on their way.
+            risk.onLeavesChange(33, -2);
+            risk.onTrade(TradeEvent{1, Side::SELL, 41, Side::BUY, 33, 1000, 3, 0});
+            expect(risk.openOrders(0) == 0 && risk.position(0) == 5, "Cancel before fill should settle the same");
+
+            expect(risk.check(makeOrder(34, 0, Side::BUY, 1000, 5, OrderType::IOC)) == risk::RiskResult::Accepted,
+                   "IOC within limits");
+            risk.onLeavesChange(34, -5);
+            expect(risk.liveOrders() == 0, "Closed and filled orders should leave the order table");
+            expect(risk.check(makeOrder(35, 0, Side::BUY, 1000, 5)) == risk::RiskResult::Accepted,
+                   "Freed exposure should admit an order up to the limit");
+        }
+
+        {
+            // Wire ids are hashed into a fixed table; a full table rejects instead of growing.
+            RiskSettings settings;
+            settings.max_participants = 2;
+            settings.max_live_orders = 2;
+            risk::PreTradeRisk risk(settings);
+
+            const OrderId huge = std::numeric_limits<OrderId>::max() - 1;
+            expect(risk.check(makeOrder(huge, 0, Side::BUY, 1000, 5)) == risk::RiskResult::Accepted,
+                   "Large ids should not need a large table");
+            expect(risk.check(makeOrder(7, 0, Side::BUY, 1000, 5)) == risk::RiskResult::Accepted, "Second live order");
+            expect(risk.check(makeOrder(8, 0, Side::BUY, 1000, 5)) == risk::RiskResult::OrderTableFull,
+                   "Full table should reject");
+            risk.onLeavesChange(huge, -5);
+            expect(risk.check(makeOrder(8, 0, Side::BUY, 1000, 5)) == risk::RiskResult::Accepted,
+                   "Closing an order should free its table slot");
+            risk.onTrade(makeTrade(9, 7, 5));
+            expect(risk.liveOrders() == 1 && risk.openOrders(0) == 1, "Filled order should leave the table");
+            expect(risk.rejected(risk::RiskResult::OrderTableFull) == 1, "Table full counter mismatch");
+        }
+
+        {
+            // Modifies reach risk through the book's leaves hook: down, then up, then cancel.
+            RiskSettings settings;
+            settings.max_participants = 2;
+            settings.max_position = 20;
+            risk::PreTradeRisk risk(settings);
+            OrderBook book;
+            book.clearTradeSinks();
+            book.setLeavesHook(
+                [](void* context, OrderId orderId, int64_t delta) {
+                    static_cast<risk::PreTradeRisk*>(context)->onLeavesChange(orderId, delta);
+                },
+                &risk);
+
+            const auto resting = makeOrder(50, 0, Side::BUY, 1000, 10);
+            expect(risk.check(resting) == risk::RiskResult::Accepted, "Resting buy within limits");
+            book.addOrder(toBookOrder(resting));
+
+            book.modifyOrder(50, 1000, 4);
+            expect(risk.check(makeOrder(51, 0, Side::BUY, 1000, 16, OrderType::IOC)) == risk::RiskResult::Accepted,
+                   "Modify down should release the reduced quantity");
+            risk.onLeavesChange(51, -16);
+
+            book.modifyOrder(50, 1001, 12);
+            expect(risk.check(makeOrder(52, 0, Side::BUY, 1000, 9, OrderType::IOC)) == risk::RiskResult::MaxPosition,
+                   "Modify up should reserve the added quantity");
+
+            expect(book.cancelOrder(50), "Modified order should cancel");
+            expect(risk.openOrders(0) == 0 && risk.liveOrders() == 0, "Cancel after modifies should free everything");
+            expect(risk.check(makeOrder(53, 0, Side::BUY, 1000, 20)) == risk::RiskResult::Accepted,
+                   "Full position capacity should be back");
+        }
+
+        {
+            // A refused order leaves the stage as a REJECT report; the accepted one reaches the engine.
+            RiskSettings settings;
+            settings.max_participants = 2;
+            settings.max_order_qty = 10;
+            OrderDispatcher::Queue engine_queue(64);
+            risk::RiskStage stage(settings, {{1, OrderDispatcher::Route{&engine_queue}}}, 64);
+            std::vector<execution::ExecutionReport> reports;
+            ingress::WireOrder forwarded{};
+            {
+                ExecReportPublisher::Options options;
+                options.stream = 3;
+                ExecReportPublisher publisher(options, [&](const char* data, std::size_t len) {
+                    execution::ReportHeader header;
+                    expect(execution::decodeReports(std::string_view(data, len), header, reports),
+                           "Datagram should decode");
+                });
+                stage.setRejectSink([&publisher](const ingress::WireOrder& order, ExecReason reason) {
+                    execution::ExecutionReport report;
+                    report.order_id = order.order_id;
+                    report.instrument = order.instrument;
+                    report.type = ExecType::REJECT;
+                    report.reason = reason;
+                    publisher.publish(report);
+                });
+                std::thread runner([&stage] { stage.run(); });
+                expect(stage.inbound()->push(makeOrder(60, 0, Side::BUY, 1000, 11)), "Inbound push");
+                expect(stage.inbound()->push(makeOrder(61, 0, Side::BUY, 1000, 5)), "Inbound push");
+                stage.inbound()->notifyConsumer();
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+                while (!engine_queue.pop(forwarded) && std::chrono::steady_clock::now() < deadline) {
+                    std::this_thread::yield();
+                }
+                stage.stop();
+                runner.join();
+            }
+            expect(forwarded.order_id == 61, "Accepted order should reach its engine queue");
+            expect(reports.size() == 1, "Only the refused order should be reported");
+            expect(reports[0].order_id == 60 && reports[0].type == ExecType::REJECT &&
+                       reports[0].reason == ExecReason::RISK && reports[0].instrument == 1,
+                   "Risk refusal should be a REJECT with reason risk");
+        }
+
+        return 0;
+    } catch (const std::exception& ex) {
+        LOG_ERROR("PreTradeRisk tests failed: {}", ex.what());
+        return 1;
+    }
+}
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "types/AppTypes.h"
+#include "types/OrderSide.h"
+#include "types/OrderType.h"
+
+/**
+ * @brief Deliberately simple price-time matcher used as the oracle for the
+ *        randomized OrderBook cross-check.
+ *
+ * Mirrors OrderBook semantics without any of its data structures: levels are
+ * std::map<Price, std::deque<OrderId>>, orders live in a hash map, and every
+ * quantity is recomputed from first principles.
+ */
+class ReferenceMatcher {
+public:
+    struct Trade {
+        OrderId aggressor = 0;
+        OrderId resting = 0;
+        Price price = 0;
+        Qty qty = 0;
+
+        bool operator==(const Trade&) const = default;
+    };
+
+    void add(OrderId id, Side side, Price price, Qty qty, OrderType type, Qty display) {
+        RefOrder order;
+        order.side = side;
+        order.price = price;
+        order.total = qty;
+        order.type = type;
+        order.display = (type == OrderType::ICEBERG) ? display : 0;
+        orders_[id] = order;
+        refresh(orders_[id]);
+        process(id);
+    }
+
+    bool cancel(OrderId id) {
+        auto it = orders_.find(id);
+        if (it == orders_.end() || !it->second.resting) {
+            return false;
+        }
+        unlink(id, it->second);
+        orders_.erase(it);
+        return true;
+    }
+
+    void modify(OrderId id, Price newPrice, Qty newQty) {
+        auto it = orders_.find(id);
+        if (it == orders_.end() || !it->second.resting) {
+            return;
+        }
+        RefOrder& order = it->second;
+        const bool priceChanged = newPrice != order.price;
+        const bool qtyIncrease = newQty > order.total;
+
+        if (!priceChanged && !qtyIncrease) {
+            if (newQty < order.filled) {
+                return;
+            }
+            // In-place reduction keeps priority and never grows the visible slice.
+            const Qty before = order.visible;
+            order.total = newQty;
+            refresh(order);
+            order.visible = std::min(order.visible, before);
+            if (remaining(order) == 0) {
+                cancel(id);
+            }
+            return;
+        }
+
+        unlink(id, order);
+        if (newQty < order.filled) {
+            orders_.erase(it);
+            return;
+        }
+        order.total = newQty;
+        order.price = newPrice;
+        refresh(order);
+        process(id);
+    }
+
+    const std::vector<Trade>& trades() const { return trades_; }
+
+    // Non-empty levels with their visible quantity, in ascending price order.
+    std::vector<std::pair<Price, Qty>> levels(Side side) const {
+        std::vector<std::pair<Price, Qty>> out;
+        const auto collect = [&](const auto& book) {
+            for (const auto& [price, queue] : book) {
+                Qty total = 0;
+                for (OrderId id : queue) {
+                    total += orders_.at(id).visible;
+                }
+                out.emplace_back(price, total);
+            }
+        };
+        if (side == Side::BUY) {
+            collect(bids_);
+        } else {
+            collect(asks_);
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    // Head order of the best level, or 0 when that side is empty.
+    OrderId bestHead(Side side) const {
+        if (side == Side::BUY) {
+            return bids_.empty() ? 0 : bids_.begin()->second.front();
+        }
+        return asks_.empty() ? 0 : asks_.begin()->second.front();
+    }
+
+    bool isResting(OrderId id) const {
+        auto it = orders_.find(id);
+        return it != orders_.end() && it->second.resting;
+    }
+
+    Qty filled(OrderId id) const {
+        auto it = orders_.find(id);
+        return it == orders_.end() ? 0 : it->second.filled;
+    }
+
+    Qty total(OrderId id) const {
+        auto it = orders_.find(id);
+        return it == orders_.end() ? 0 : it->second.total;
+    }
+
+    Price price(OrderId id) const {
+        auto it = orders_.find(id);
+        return it == orders_.end() ? 0 : it->second.price;
+    }
+
+private:
+    struct RefOrder {
+        Side side = Side::INVALID;
+        Price price = 0;
+        Qty total = 0;
+        Qty filled = 0;
+        Qty display = 0;
+        Qty visible = 0;
+        OrderType type = OrderType::LIMIT;
+        bool resting = false;
+    };
+
+    std::map<Price, std::deque<OrderId>, std::greater<Price>> bids_;
+    std::map<Price, std::deque<OrderId>, std::less<Price>> asks_;
+    std::unordered_map<OrderId, RefOrder> orders_;
+    std::vector<Trade> trades_;
+
+    static Qty remaining(const RefOrder& order) { return order.total - order.filled; }
+
+    static void refresh(RefOrder& order) {
+        const Qty left = remaining(order);
+        order.visible = (order.display > 0) ? std::min(order.display, left) : left;
+    }
+
+    void process(OrderId id) {
+        RefOrder& order = orders_.at(id);
+        bool rest = false;
+        switch (order.type) {
+            case OrderType::LIMIT:
+                match(id, true);
+                rest = true;
+                break;
+            case OrderType::MARKET:
+                match(id, false);
+                break;
+            case OrderType::IOC:
+                match(id, true);
+                break;
+            case OrderType::FOK:
+                if (visibleAgainst(order.side, order.price) >= order.visible) {
+                    match(id, true);
+                }
+                break;
+            case OrderType::ICEBERG:
+                if (order.display == 0) {
+                    order.display = remaining(order);
+                }
+                refresh(order);
+                match(id, true);
+                rest = true;
+                break;
+        }
+
+        RefOrder& after = orders_.at(id);
+        if (rest && after.visible > 0) {
+            // A resting iceberg shows a full slice, not the leftover of the one it swept with.
+            refresh(after);
+            link(id, after);
+        } else {
+            orders_.erase(id);
+        }
+    }
+
+    void match(OrderId id, bool respectPrice) {
+        if (orders_.at(id).side == Side::BUY) {
+            matchAgainst(id, asks_, respectPrice);
+        } else {
+            matchAgainst(id, bids_, respectPrice);
+        }
+    }
+
+    template <typename Book>
+    void matchAgainst(OrderId id, Book& book, bool respectPrice) {
+        RefOrder& order = orders_.at(id);
+        while (order.visible > 0 && !book.empty()) {
+            auto levelIt = book.begin();
+            const Price levelPrice = levelIt->first;
+            if (respectPrice && book.key_comp()(order.price, levelPrice)) {
+                break;
+            }
+
+            const OrderId headId = levelIt->second.front();
+            RefOrder& head = orders_.at(headId);
+            const Qty qty = std::min(order.visible, head.visible);
+            order.filled += qty;
+            order.visible -= qty;
+            head.filled += qty;
+            head.visible -= qty;
+            trades_.push_back({id, headId, levelPrice, qty});
+
+            if (head.visible == 0) {
+                levelIt->second.pop_front();
+                if (head.display > 0 && remaining(head) > 0) {
+                    refresh(head);
+                    levelIt->second.push_back(headId);
+                } else {
+                    orders_.erase(headId);
+                }
+                if (levelIt->second.empty()) {
+                    book.erase(levelIt);
+                }
+            }
+            // An aggressive iceberg keeps sweeping with its hidden quantity.
+            if (order.visible == 0 && order.display > 0 && remaining(order) > 0) {
+                refresh(order);
+            }
+        }
+    }
+
+    Qty visibleAgainst(Side side, Price limit) const {
+        Qty total = 0;
+        const auto sum = [&](const auto& book) {
+            for (const auto& [price, queue] : book) {
+                if (book.key_comp()(limit, price)) {
+                    break;
+                }
+                for (OrderId id : queue) {
+                    total += orders_.at(id).visible;
+                }
+            }
+        };
+        if (side == Side::BUY) {
+            sum(asks_);
+        } else {
+            sum(bids_);
+        }
+        return total;
+    }
+
+    void link(OrderId id, RefOrder& order) {
+        order.resting = true;
+        if (order.side == Side::BUY) {
+            bids_[order.price].push_back(id);
+        } else {
+            asks_[order.price].push_back(id);
+        }
+    }
+
+    void unlink(OrderId id, RefOrder& order) {
+        order.resting = false;
+        const auto drop = [&](auto& book) {
+            auto levelIt = book.find(order.price);
+            auto& queue = levelIt->second;
+            queue.erase(std::find(queue.begin(), queue.end(), id));
+            if (queue.empty()) {
+                book.erase(levelIt);
+            }
+        };
+        if (order.side == Side::BUY) {
+            drop(bids_);
+        } else {
+            drop(asks_);
+        }
+    }
+};
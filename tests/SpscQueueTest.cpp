@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "datastructures/SpscQueue.h"
+#include "utils/LogMacros.h"
+
+namespace {
+
+void expect(bool condition, const std::string& message) {
+    if (!condition) {
+        throw std::runtime_error(message);
+    }
+}
+
+}  // namespace
+
+int main() {
+    try {
+        {
+            SpscQueue<int> queue(5);
+            expect(queue.capacity() == 8, "Capacity rounds up to a power of two");
+            for (int i = 0; i < 8; ++i) {
+                expect(queue.push(i), "Every slot is usable");
+            }
+            expect(!queue.push(8), "Push into a full queue fails");
+            expect(queue.read_available() == 8 && queue.write_available() == 0, "Full queue accounting");
+
+            // Wrap the indices several times over the mask.
+            int value = -1;
+            for (int i = 0; i < 100; ++i) {
+                expect(queue.pop(value) && value == i, "FIFO order across wrap-around");
+                expect(queue.push(i + 8), "Freed slot is reusable");
+            }
+            for (int i = 100; i < 108; ++i) {
+                expect(queue.pop(value) && value == i, "Drain after wrap-around");
+            }
+            expect(!queue.pop(value) && queue.read_available() == 0, "Pop from an empty queue fails");
+        }
+        {
+            SpscQueue<int> queue(8);
+            std::array<int, 12> in{};
+            std::iota(in.begin(), in.end(), 0);
+            std::array<int, 12> out{};
+
+            // Offset the indices so the bulk calls straddle the end of the buffer.
+            expect(queue.try_push_n(in.data(), 5) == 5 && queue.try_pop_n(out.data(), 5) == 5, "Bulk warm-up");
+            expect(queue.try_push_n(in.data(), 12) == 8, "Bulk push stops when the queue fills");
+            expect(queue.try_pop_n(out.data(), 12) == 8, "Bulk pop drains across the wrap");
+            for (int i = 0; i < 8; ++i) {
+                expect(out[static_cast<size_t>(i)] == i, "Bulk FIFO order across the wrap");
+            }
+
+            // Claimed slots run to the end of the buffer and stay private until commit.
+            auto slots = queue.claim(8);
+            expect(slots.size() == 3, "Claim stops at the end of the buffer");
+            slots[0] = 40;
+            slots[1] = 41;
+            expect(queue.read_available() == 0 && queue.peek(8).empty(), "Uncommitted slots are invisible");
+            queue.commit(2);
+            slots = queue.claim(8);
+            expect(slots.size() == 1, "Claim resumes after the committed slots");
+            slots[0] = 42;
+            queue.commit(1);
+            slots = queue.claim(8);
+            expect(slots.size() == 5, "Claim continues from the start of the buffer");
+            slots[0] = 43;
+            queue.commit(1);
+
+            auto ready = queue.peek(8);
+            expect(ready.size() == 3 && ready[0] == 40 && ready[2] == 42, "Peek returns the run up to the wrap");
+            queue.release(3);
+            ready = queue.peek(8);
+            expect(ready.size() == 1 && ready[0] == 43, "Peek resumes after the wrap");
+            queue.release(1);
+            expect(queue.read_available() == 0, "Released slots are free again");
+        }
+        {
+            // Batched producer and in-place consumer on separate threads.
+            constexpr uint64_t kItems = 1'000'000;
+            SpscQueue<uint64_t> queue(64);
+            bool ordered = true;
+            std::thread consumer([&] {
+                for (uint64_t expected = 0; expected < kItems;) {
+                    const auto ready = queue.peek(16);
+                    if (ready.empty()) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    for (uint64_t value : ready) {
+                        ordered = ordered && value == expected++;
+                    }
+                    queue.release(ready.size());
+                }
+            });
+            std::array<uint64_t, 24> batch{};
+            for (uint64_t next = 0; next < kItems;) {
+                const size_t n = static_cast<size_t>(std::min<uint64_t>(batch.size(), kItems - next));
+                for (size_t i = 0; i < n; ++i) {
+                    batch[i] = next + i;
+                }
+                size_t pushed = 0;
+                while (pushed < n) {
+                    const size_t count = queue.try_push_n(batch.data() + pushed, n - pushed);
+                    if (count == 0) {
+                        std::this_thread::yield();
+                    }
+                    pushed += count;
+                }
+                next += n;
+            }
+            consumer.join();
+            expect(ordered, "Batched cross-thread FIFO order");
+        }
+        {
+            // Producer and consumer on separate threads exercise the cached-index refresh paths.
+            constexpr uint64_t kItems = 1'000'000;
+            SpscQueue<uint64_t> queue(64);
+            bool ordered = true;
+            std::thread consumer([&] {
+                uint64_t value = 0;
+                for (uint64_t expected = 0; expected < kItems;) {
+                    if (queue.pop(value)) {
+                        ordered = ordered && value == expected;
+                        ++expected;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+            for (uint64_t i = 0; i < kItems; ++i) {
+                while (!queue.push(i)) {
+                    std::this_thread::yield();
+                }
+            }
+            consumer.join();
+            expect(ordered, "Cross-thread FIFO order");
+        }
+        return 0;
+    } catch (const std::exception& ex) {
+        LOG_ERROR("SpscQueue tests failed: {}", ex.what());
+        return 1;
+    }
+}
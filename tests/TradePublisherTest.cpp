@@ -0,0 +1,241 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/OrderBook.h"
+#include "core/TradePublisher.h"
+#include "datastructures/SequencedRing.h"
+#include "utils/LogMacros.h"
+
+namespace {
+
+void expect(bool condition, const std::string& message) {
+    if (!condition) {
+        throw std::runtime_error(message);
+    }
+}
+
+TradeEvent makeTrade(OrderId aggressor) {
+    TradeEvent event{};
+    event.instrument = 1;
+    event.aggressorId = aggressor;
+    event.price = 100;
+    event.quantity = 1;
+    return event;
+}
+
+// Trade sink recording aggressor ids; optionally holds its consumer thread until released.
+class Recorder {
+public:
+    explicit Recorder(bool gated = false) : open_(!gated) {}
+
+    void onTrades(TradeBatch trades) {
+        uint32_t spins = 0;
+        while (!open_.load(std::memory_order_acquire)) {
+            if (++spins % 1000 == 0) {
+                std::this_thread::yield();
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const TradeEvent& event : trades) {
+            ids_.push_back(event.aggressorId);
+        }
+        ++batches_;
+    }
+
+    std::size_t batches() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return batches_;
+    }
+
+    void open() { open_.store(true, std::memory_order_release); }
+
+    std::vector<OrderId> ids() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return ids_;
+    }
+
+private:
+    std::atomic<bool> open_;
+    mutable std::mutex mutex_;
+    std::vector<OrderId> ids_;
+    std::size_t batches_ = 0;
+};
+
+bool inOrder(const std::vector<OrderId>& ids) {
+    for (std::size_t i = 1; i < ids.size(); ++i) {
+        if (ids[i] <= ids[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A book whose own sinks are replaced by `sink` (none when null).
+std::unique_ptr<OrderBook> quietBook(Recorder* sink = nullptr) {
+    auto book = std::make_unique<OrderBook>();
+    book->setInstrumentToken(1);
+    book->clearTradeSinks();
+    if (sink) {
+        book->addTradeSink(*sink);
+    }
+    return book;
+}
+
+TradePublisher::Options threaded(TradePublisher::Overflow overflow) {
+    TradePublisher::Options options;
+    options.capacity = 4;
+    options.overflow = overflow;
+    return options;
+}
+
+}  // namespace
+
+int main() {
+    try {
+        {
+            // The producer gates on the slowest cursor; each consumer reads the same slots.
+            SequencedRing<int> ring(3, 2);
+            expect(ring.capacity() == 4 && ring.consumers() == 2, "Ring geometry mismatch");
+            for (int i = 0; i < 4; ++i) {
+                expect(ring.tryPublish(i), "Empty ring should accept a full capacity");
+            }
+            expect(!ring.tryPublish(4), "Full ring must refuse instead of overwriting");
+
+            std::vector<int> seen;
+            expect(ring.consume(0, 8, [&](const int& value) { seen.push_back(value); }) == 4, "Consumer 0 drain");
+            expect(seen == std::vector<int>({0, 1, 2, 3}), "Consumer 0 should see events in sequence order");
+            expect(!ring.tryPublish(4), "Lagging consumer 1 must still hold the ring");
+            expect(ring.lag(0) == 0 && ring.lag(1) == 4, "Per-consumer lag mismatch");
+
+            const int* first = nullptr;
+            ring.consume(1, 1, [&](const int& value) { first = &value; });
+            expect(first != nullptr && *first == 0, "Consumer 1 reads the slot in place");
+            expect(ring.tryPublish(4) && !ring.tryPublish(5), "One freed slot admits exactly one event");
+        }
+
+        {
+            // Extra consumers see every event in order, alongside the book's own sinks.
+            Recorder listener;
+            auto book = quietBook(&listener);
+            Recorder dropCopy;
+            Recorder analytics;
+            TradePublisher::Options options = threaded(TradePublisher::Overflow::BLOCK);
+            options.capacity = 64;
+            {
+                TradePublisher publisher(options);
+                publisher.attach(1, *book);
+                publisher.addConsumer("drop_copy", dropCopy);
+                publisher.addConsumer("analytics", analytics);
+                for (OrderId id = 1; id <= 1'000; ++id) {
+                    publisher.publish(*book, makeTrade(id));
+                }
+                expect(publisher.consumerCount() == 3, "Books plus two consumers expected");
+                bool threw = false;
+                try {
+                    publisher.addConsumer("late", dropCopy);
+                } catch (const std::runtime_error&) {
+                    threw = true;
+                }
+                expect(threw, "Consumers cannot join a running publisher");
+            }
+            for (const Recorder* recorder : {&listener, &dropCopy, &analytics}) {
+                const auto ids = recorder->ids();
+                expect(ids.size() == 1'000 && inOrder(ids), "Every consumer should see all trades in order");
+            }
+            expect(dropCopy.batches() < 1'000, "Consumers should receive trades in batches");
+        }
+
+        {
+            // Drop: a stuck consumer costs trades, but they are counted.
+            auto book = quietBook();
+            Recorder slow(true);
+            uint64_t dropped = 0;
+            {
+                TradePublisher publisher(threaded(TradePublisher::Overflow::DROP));
+                publisher.attach(1, *book);
+                publisher.addConsumer("slow", slow);
+                for (OrderId id = 1; id <= 100; ++id) {
+                    publisher.publish(*book, makeTrade(id));
+                }
+                dropped = publisher.dropped();
+                expect(dropped >= 90, "A full ring should drop and count");
+                const auto stats = publisher.consumerStats();
+                expect(stats[1].name == "slow" && stats[1].lag >= 1, "Stuck consumer should report lag");
+                slow.open();
+            }
+            const auto ids = slow.ids();
+            expect(ids.size() + dropped == 100 && inOrder(ids), "Delivered plus dropped should cover every trade");
+        }
+
+        {
+            // Spill: the matching thread never waits, and nothing is lost or reordered.
+            auto book = quietBook();
+            Recorder slow(true);
+            {
+                TradePublisher publisher(threaded(TradePublisher::Overflow::SPILL));
+                publisher.attach(1, *book);
+                publisher.addConsumer("slow", slow);
+                for (OrderId id = 1; id <= 100; ++id) {
+                    publisher.publish(*book, makeTrade(id));
+                }
+                expect(publisher.spilled() >= 90 && publisher.dropped() == 0, "A full ring should spill");
+                expect(publisher.flush() > 0, "Spill cannot drain while the consumer is stuck");
+                slow.open();
+            }
+            const auto ids = slow.ids();
+            expect(ids.size() == 100 && inOrder(ids), "Spilled trades should all arrive in order");
+        }
+
+        {
+            // Block: the matching thread waits for the slowest consumer.
+            auto book = quietBook();
+            Recorder slow(true);
+            {
+                TradePublisher publisher(threaded(TradePublisher::Overflow::BLOCK));
+                publisher.attach(1, *book);
+                publisher.addConsumer("slow", slow);
+                std::thread release([&slow] {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                    slow.open();
+                });
+                for (OrderId id = 1; id <= 100; ++id) {
+                    publisher.publish(*book, makeTrade(id));
+                }
+                release.join();
+                expect(publisher.stalls() > 0, "A full ring should stall the producer");
+                const auto stats = publisher.consumerStats();
+                expect(stats[1].max_lag >= 4, "Slow consumer lag should reach the ring size");
+            }
+            const auto ids = slow.ids();
+            expect(ids.size() == 100 && inOrder(ids), "Blocking overflow must be lossless");
+        }
+
+        {
+            // Inline: consumers run on the caller, in registration order.
+            std::vector<std::string> calls;
+            const auto bookSink = [&](TradeBatch) { calls.push_back("book"); };
+            const auto dropCopy = [&](TradeBatch) { calls.push_back("drop_copy"); };
+            auto book = quietBook();
+            book->addTradeSink(bookSink);
+            TradePublisher::Options options;
+            options.mode = TradePublisher::Mode::INLINE;
+            TradePublisher publisher(options);
+            publisher.attach(1, *book);
+            publisher.addConsumer("drop_copy", dropCopy);
+            publisher.publish(*book, makeTrade(1));
+            expect(calls == std::vector<std::string>({"book", "drop_copy"}), "Inline consumers run synchronously");
+            expect(publisher.consumerStats()[1].consumed == 1, "Inline consumers are counted");
+        }
+
+        return 0;
+    } catch (const std::exception& ex) {
+        LOG_ERROR("TradePublisher tests failed: {}", ex.what());
+        return 1;
+    }
+}
@@ -0,0 +1,117 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "datastructures/SpscQueue.h"
+#include "utils/LogMacros.h"
+#include "utils/WaitStrategy.h"
+
+namespace {
+
+void expect(bool condition, const std::string& message) {
+    if (!condition) {
+        throw std::runtime_error(message);
+    }
+}
+
+// Producer publishes in slow bursts so park/backoff modes really go idle;
+// the consumer must see every item in order whatever the mode.
+WaitCounters pingPong(WaitMode mode) {
+    constexpr uint64_t kItems = 2'000;
+    WaitSettings settings;
+    settings.mode = mode;
+    settings.spin_limit = 16;
+    settings.park_timeout_us = 200'000;
+    settings.backoff_max_us = 50;
+
+    SpscQueue<uint64_t> queue(64);
+    WaitStrategy wait(settings);
+    std::atomic<bool> done{false};
+
+    std::thread consumer([&] {
+        uint64_t expected = 0;
+        uint64_t value = 0;
+        while (expected < kItems) {
+            if (!queue.pop(value)) {
+                wait.idle([&queue] { return queue.read_available() > 0; });
+                continue;
+            }
+            wait.reset();
+            if (value != expected) {
+                return;
+            }
+            ++expected;
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    for (uint64_t i = 0; i < kItems; ++i) {
+        while (!queue.push(i)) {
+            std::this_thread::yield();
+        }
+        wait.notify();
+        if (i % 100 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+    consumer.join();
+    expect(done.load(std::memory_order_acquire), std::string(toString(mode)) + ": consumer lost or reordered items");
+    return wait.counters();
+}
+
+}  // namespace
+
+int main() {
+    try {
+        {
+            const WaitCounters c = pingPong(WaitMode::BUSY_SPIN);
+            expect(c.spins > 0 && c.yields == 0 && c.parks == 0 && c.sleeps == 0, "busy_spin should only spin");
+        }
+        {
+            const WaitCounters c = pingPong(WaitMode::SPIN_YIELD);
+            expect(c.yields > 0 && c.parks == 0, "spin_yield should yield once past the spin limit");
+        }
+        {
+            // The 200ms park timeout would blow well past the run time if notify() were lost.
+            const auto start = std::chrono::steady_clock::now();
+            const WaitCounters c = pingPong(WaitMode::SPIN_PARK);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            expect(c.parks > 0 && c.wakeups > 0, "spin_park should park and be woken");
+            expect(c.wakeups <= c.parks, "every wakeup belongs to a park");
+            expect(elapsed < std::chrono::seconds(2), "spin_park consumer slept through notifications");
+        }
+        {
+            const WaitCounters c = pingPong(WaitMode::BACKOFF);
+            expect(c.sleeps > 0 && c.parks == 0, "backoff should sleep once past the spin limit");
+        }
+        {
+            // Nobody notifies: a park still returns after park_timeout_us.
+            WaitSettings settings;
+            settings.mode = WaitMode::SPIN_PARK;
+            settings.spin_limit = 1;
+            settings.park_timeout_us = 1'000;
+            WaitStrategy wait(settings);
+            const auto start = std::chrono::steady_clock::now();
+            wait.idle();
+            wait.idle();
+            expect(std::chrono::steady_clock::now() - start < std::chrono::seconds(1), "park must honour its timeout");
+            expect(wait.counters().parks == 2 && wait.counters().wakeups == 0, "timed-out park is not a wakeup");
+        }
+        {
+            // A ready predicate that already holds cancels the park.
+            WaitSettings settings;
+            settings.mode = WaitMode::SPIN_PARK;
+            settings.spin_limit = 1;
+            WaitStrategy wait(settings);
+            wait.idle([] { return true; });
+            expect(wait.counters().parks == 0, "ready input must not park");
+        }
+        return 0;
+    } catch (const std::exception& ex) {
+        LOG_ERROR("WaitStrategy tests failed: {}", ex.what());
+        return 1;
+    }
+}